@@ -0,0 +1,25 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace vfx { namespace compare
+{
+	/// \brief	Stage times of single run [ms], keyed by scenario and stage.
+	typedef std::map<std::string, std::map<std::string, std::vector<double>>> RunData;
+
+	/// \brief	Loads stage times of benchmark output.
+	///
+	///			JSON written by vfxBenchmark holds all scenarios of run, scenario
+	///			key is name and resolution ("lighting 128x128x128"). CSV written
+	///			by Profiler::log holds single scenario with stage per column, its
+	///			key is built the same way from file name "profile_WxHxD_<features>"
+	///			("enabled_s16_l64 128x128x128"). Malformed input fails the load.
+	///
+	/// \param file Benchmark JSON or profiler CSV.
+	/// \param run Loaded scenarios are added to run.
+	/// \param error Reason of failure.
+	/// \return False if file could not be read.
+	bool loadRun(const std::string& file, RunData& run, std::string& error);
+} }
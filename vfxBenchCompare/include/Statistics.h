@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace vfx { namespace compare
+{
+	/// \brief	Settings of comparison.
+	struct Settings
+	{
+		double threshold = 0.05;		//!< Relative slowdown of median reported as regression.
+		double alpha = 0.05;			//!< Significance level of test and 1 - confidence of interval.
+		unsigned int resamples = 2000;	//!< Bootstrap resamples.
+		uint32_t seed = 0;				//!< Seed of bootstrap, equal inputs give equal results.
+	};
+
+	/// \brief	Comparison of candidate stage times to baseline.
+	struct Comparison
+	{
+		double baselineMedian = 0.0;
+		double candidateMedian = 0.0;
+		double change = 0.0;			//!< Relative change of median, positive is slower.
+		double changeLow = 0.0;			//!< Lower bound of confidence interval of change.
+		double changeHigh = 0.0;		//!< Upper bound of confidence interval of change.
+		double pValue = 1.0;			//!< Two-sided Mann-Whitney U test.
+		bool regression = false;		//!< Significantly slower by more than threshold.
+		bool improvement = false;		//!< Significantly faster by more than threshold.
+	};
+
+	double median(std::vector<double> samples);
+
+	/// \brief	Two-sided p-value of Mann-Whitney U test, normal approximation
+	///			with tie and continuity correction.
+	double mannWhitneyPValue(const std::vector<double>& a, const std::vector<double>& b);
+
+	/// \brief	Percentile bootstrap confidence interval of ratio of medians b / a.
+	void bootstrapMedianRatio(const std::vector<double>& a, const std::vector<double>& b, const Settings& settings, double& low, double& high);
+
+	/// \brief	Compares samples, change is significant when test rejects equality
+	///			and confidence interval of change excludes zero.
+	///
+	/// \param baseline Non-empty baseline samples.
+	/// \param candidate Non-empty candidate samples.
+	Comparison compare(const std::vector<double>& baseline, const std::vector<double>& candidate, const Settings& settings);
+} }
@@ -0,0 +1,192 @@
+#include "BenchmarkData.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "document.h"
+#include "istreamwrapper.h"
+
+namespace vfx { namespace compare
+{
+	namespace
+	{
+		const std::string CSV_PREFIX = "profile_";
+
+		bool endsWith(const std::string& value, const std::string& suffix)
+		{
+			return value.size() >= suffix.size() && value.compare(value.size() - suffix.size(), suffix.size(), suffix) == 0;
+		}
+
+		std::vector<std::string> split(const std::string& line, char delimiter)
+		{
+			std::vector<std::string> cells;
+			std::stringstream stream(line);
+			std::string cell;
+
+			while (std::getline(stream, cell, delimiter))
+			{
+				if (!cell.empty() && cell.back() == '\r') cell.pop_back();
+				cells.push_back(cell);
+			}
+
+			return cells;
+		}
+
+		std::string getScenarioKey(const std::string& name, int width, int height, int depth)
+		{
+			return name + " " + std::to_string(width) + "x" + std::to_string(height) + "x" + std::to_string(depth);
+		}
+
+		/// \brief	Parses resolution in "WxHxD" form.
+		bool parseResolution(const std::string& value, int& width, int& height, int& depth)
+		{
+			char separators[2] = {};
+			int read = 0;
+
+			return std::sscanf(value.c_str(), "%d%c%d%c%d%n", &width, &separators[0], &height, &separators[1], &depth, &read) == 5 &&
+				   read == static_cast<int>(value.size()) && separators[0] == 'x' && separators[1] == 'x';
+		}
+
+		/// \brief	Key of CSV scenario in the same form as JSON one. Profiler::log
+		///			names files "profile_WxHxD_<features>", features name scenario.
+		std::string getCsvScenarioKey(const std::string& file)
+		{
+			auto name = file.substr(file.find_last_of("/\\") + 1);
+			name = name.substr(0, name.find_last_of('.'));
+
+			if (name.compare(0, CSV_PREFIX.size(), CSV_PREFIX) == 0)
+				name = name.substr(CSV_PREFIX.size());
+
+			auto separator = name.find('_');
+			int width, height, depth;
+
+			// File renamed by user keeps its name as key
+			if (!parseResolution(name.substr(0, separator), width, height, depth))
+				return name;
+
+			auto features = (separator == std::string::npos) ? std::string("profile") : name.substr(separator + 1);
+			return getScenarioKey(features, width, height, depth);
+		}
+
+		bool isResolution(const rapidjson::Value& value)
+		{
+			return value.IsArray() && value.Size() == 3 && value[0].IsInt() && value[1].IsInt() && value[2].IsInt();
+		}
+
+		bool loadCsv(const std::string& file, RunData& run, std::string& error)
+		{
+			std::ifstream ifs(file, std::ios::in);
+			if (!ifs.is_open())
+			{
+				error = "failed to open " + file;
+				return false;
+			}
+
+			std::string line;
+			if (!std::getline(ifs, line))
+			{
+				error = file + " is empty";
+				return false;
+			}
+
+			// Profiler terminates header and rows by delimiter
+			auto stages = split(line, ',');
+			auto& scenario = run[getCsvScenarioKey(file)];
+
+			while (std::getline(ifs, line))
+			{
+				auto cells = split(line, ',');
+
+				for (size_t i = 0; i < cells.size() && i < stages.size(); ++i)
+				{
+					if (stages[i].empty() || cells[i].empty()) continue;
+					scenario[stages[i]].push_back(std::stod(cells[i]));
+				}
+			}
+
+			return true;
+		}
+
+		bool loadJson(const std::string& file, RunData& run, std::string& error)
+		{
+			std::ifstream ifs(file, std::ios::in);
+			if (!ifs.is_open())
+			{
+				error = "failed to open " + file;
+				return false;
+			}
+
+			rapidjson::Document document;
+			rapidjson::IStreamWrapper isw(ifs);
+			document.ParseStream(isw);
+
+			if (document.HasParseError() || !document.IsObject() || !document.HasMember("results") || !document["results"].IsArray())
+			{
+				error = file + " is not benchmark output";
+				return false;
+			}
+
+			const auto& results = document["results"].GetArray();
+
+			for (rapidjson::SizeType i = 0; i < results.Size(); ++i)
+			{
+				const auto& result = results[i];
+				const std::string location = file + ": result " + std::to_string(i);
+
+				if (!result.IsObject() || !result.HasMember("scenario") || !result["scenario"].IsString() ||
+					!result.HasMember("stage") || !result["stage"].IsString())
+				{
+					error = location + " has no scenario or stage name";
+					return false;
+				}
+
+				if (!result.HasMember("resolution") || !isResolution(result["resolution"]))
+				{
+					error = location + " has no resolution of three integers";
+					return false;
+				}
+
+				const auto& resolution = result["resolution"];
+				auto key = getScenarioKey(result["scenario"].GetString(), resolution[0].GetInt(), resolution[1].GetInt(), resolution[2].GetInt());
+
+				// Stage without times still shows up as missing samples
+				auto& times = run[key][result["stage"].GetString()];
+
+				if (!result.HasMember("times"))
+					continue;
+
+				if (!result["times"].IsArray())
+				{
+					error = location + " has times which are not an array";
+					return false;
+				}
+
+				for (const auto& time : result["times"].GetArray())
+				{
+					if (!time.IsNumber())
+					{
+						error = location + " has time which is not a number";
+						return false;
+					}
+
+					times.push_back(time.GetDouble());
+				}
+			}
+
+			return true;
+		}
+	}
+
+	bool loadRun(const std::string& file, RunData& run, std::string& error)
+	{
+		if (endsWith(file, ".json"))
+			return loadJson(file, run, error);
+
+		if (endsWith(file, ".csv"))
+			return loadCsv(file, run, error);
+
+		error = file + " is neither JSON nor CSV";
+		return false;
+	}
+} }
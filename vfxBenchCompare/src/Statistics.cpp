@@ -0,0 +1,131 @@
+#include "Statistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <utility>
+
+namespace vfx { namespace compare
+{
+	double median(std::vector<double> samples)
+	{
+		if (samples.empty()) return 0.0;
+
+		auto middle = samples.begin() + samples.size() / 2;
+		std::nth_element(samples.begin(), middle, samples.end());
+
+		if (samples.size() % 2) return *middle;
+
+		// Lower middle is largest element of first half
+		auto lower = *std::max_element(samples.begin(), middle);
+		return 0.5 * (lower + *middle);
+	}
+
+	double mannWhitneyPValue(const std::vector<double>& a, const std::vector<double>& b)
+	{
+		const double n1 = static_cast<double>(a.size());
+		const double n2 = static_cast<double>(b.size());
+		const double n = n1 + n2;
+
+		if (a.empty() || b.empty()) return 1.0;
+
+		// Samples tagged by group, sorted to assign ranks
+		std::vector<std::pair<double, bool>> pooled;
+		pooled.reserve(a.size() + b.size());
+		for (auto value : a) pooled.emplace_back(value, true);
+		for (auto value : b) pooled.emplace_back(value, false);
+		std::sort(pooled.begin(), pooled.end());
+
+		double rankSum = 0.0;
+		double tieTerm = 0.0;
+
+		for (size_t i = 0; i < pooled.size();)
+		{
+			size_t j = i;
+			while (j < pooled.size() && pooled[j].first == pooled[i].first) ++j;
+
+			// Ties share average of their ranks, ranks start at 1
+			double rank = 0.5 * (i + 1 + j);
+			double ties = static_cast<double>(j - i);
+			tieTerm += ties * ties * ties - ties;
+
+			for (size_t k = i; k < j; ++k)
+				if (pooled[k].second) rankSum += rank;
+
+			i = j;
+		}
+
+		double u = rankSum - n1 * (n1 + 1.0) / 2.0;
+		double mean = n1 * n2 / 2.0;
+		double variance = n1 * n2 / 12.0 * ((n + 1.0) - tieTerm / (n * (n - 1.0)));
+
+		if (variance <= 0.0) return 1.0;
+
+		double difference = std::max(std::abs(u - mean) - 0.5, 0.0);
+		double z = difference / std::sqrt(variance);
+
+		return std::erfc(z / std::sqrt(2.0));
+	}
+
+	void bootstrapMedianRatio(const std::vector<double>& a, const std::vector<double>& b, const Settings& settings, double& low, double& high)
+	{
+		std::mt19937 generator(settings.seed);
+		std::uniform_int_distribution<size_t> pickA(0, a.size() - 1);
+		std::uniform_int_distribution<size_t> pickB(0, b.size() - 1);
+
+		std::vector<double> sampleA(a.size());
+		std::vector<double> sampleB(b.size());
+		std::vector<double> ratios;
+		ratios.reserve(settings.resamples);
+
+		for (unsigned int i = 0; i < settings.resamples; ++i)
+		{
+			for (auto& value : sampleA) value = a[pickA(generator)];
+			for (auto& value : sampleB) value = b[pickB(generator)];
+
+			auto medianA = median(sampleA);
+			if (medianA > 0.0)
+				ratios.push_back(median(sampleB) / medianA);
+		}
+
+		if (ratios.empty())
+		{
+			low = high = 1.0;
+			return;
+		}
+
+		std::sort(ratios.begin(), ratios.end());
+
+		auto percentile = [&ratios](double p)
+		{
+			auto index = static_cast<size_t>(p * (ratios.size() - 1) + 0.5);
+			return ratios[std::min(index, ratios.size() - 1)];
+		};
+
+		low = percentile(settings.alpha / 2.0);
+		high = percentile(1.0 - settings.alpha / 2.0);
+	}
+
+	Comparison compare(const std::vector<double>& baseline, const std::vector<double>& candidate, const Settings& settings)
+	{
+		Comparison comparison;
+		comparison.baselineMedian = median(baseline);
+		comparison.candidateMedian = median(candidate);
+
+		if (comparison.baselineMedian <= 0.0) return comparison;
+
+		comparison.change = comparison.candidateMedian / comparison.baselineMedian - 1.0;
+		comparison.pValue = mannWhitneyPValue(baseline, candidate);
+
+		double low, high;
+		bootstrapMedianRatio(baseline, candidate, settings, low, high);
+		comparison.changeLow = low - 1.0;
+		comparison.changeHigh = high - 1.0;
+
+		bool significant = comparison.pValue < settings.alpha;
+		comparison.regression = significant && comparison.changeLow > 0.0 && comparison.change > settings.threshold;
+		comparison.improvement = significant && comparison.changeHigh < 0.0 && comparison.change < -settings.threshold;
+
+		return comparison;
+	}
+} }
@@ -0,0 +1,149 @@
+#include "BenchmarkData.h"
+#include "Statistics.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+	const int EXIT_REGRESSION = 1;
+	const int EXIT_INVALID = 2;
+
+	// Fewer resamples give too coarse interval to ever exclude threshold
+	const unsigned long MIN_RESAMPLES = 100;
+
+	void printUsage()
+	{
+		std::cout << "Usage: vfxBenchCompare [options] --baseline <file>... --candidate <file>...\n"
+			<< "Compares stage times of benchmark JSON or profiler CSV outputs.\n\n"
+			<< "  --threshold <percent>  Slowdown of median reported as regression (default 5)\n"
+			<< "  --alpha <level>        Significance level, interval confidence is 1 - alpha (default 0.05)\n"
+			<< "  --resamples <count>    Bootstrap resamples, at least 100 (default 2000)\n\n"
+			<< "Exit code is 1 if any stage regressed, 2 on invalid input.\n";
+	}
+
+	void printComparison(const std::string& scenario, const std::string& stage, const vfx::compare::Comparison& comparison)
+	{
+		const char* status = comparison.regression ? "REGRESSION" : comparison.improvement ? "improvement" : "";
+
+		std::printf("%-32s %-20s %10.4f %10.4f %+8.2f%% [%+7.2f%%, %+7.2f%%] %8.4f  %s\n",
+			scenario.c_str(), stage.c_str(), comparison.baselineMedian, comparison.candidateMedian,
+			comparison.change * 100.0, comparison.changeLow * 100.0, comparison.changeHigh * 100.0, comparison.pValue, status);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	vfx::compare::Settings settings;
+	std::vector<std::string> baselineFiles;
+	std::vector<std::string> candidateFiles;
+	std::vector<std::string>* files = nullptr;
+
+	try
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			std::string argument = argv[i];
+			bool hasValue = i + 1 < argc;
+
+			if (argument == "-h" || argument == "--help") { printUsage(); return EXIT_SUCCESS; }
+			else if (argument == "--baseline" || argument == "-b") files = &baselineFiles;
+			else if (argument == "--candidate" || argument == "-c") files = &candidateFiles;
+			else if (argument == "--threshold" && hasValue) settings.threshold = std::stod(argv[++i]) / 100.0;
+			else if (argument == "--alpha" && hasValue) settings.alpha = std::stod(argv[++i]);
+			else if (argument == "--resamples" && hasValue)
+			{
+				unsigned long resamples = std::stoul(argv[++i]);
+				if (resamples < MIN_RESAMPLES) throw std::invalid_argument("resamples below " + std::to_string(MIN_RESAMPLES));
+				settings.resamples = static_cast<unsigned int>(resamples);
+			}
+			else if (files && argument.compare(0, 2, "--") != 0) files->push_back(argument);
+			else throw std::invalid_argument("unexpected argument " + argument);
+		}
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "vfxBenchCompare: " << e.what() << "\n";
+		printUsage();
+		return EXIT_INVALID;
+	}
+
+	if (baselineFiles.empty() || candidateFiles.empty())
+	{
+		printUsage();
+		return EXIT_INVALID;
+	}
+
+	vfx::compare::RunData baseline, candidate;
+
+	try
+	{
+		std::string error;
+
+		for (const auto& file : baselineFiles)
+			if (!vfx::compare::loadRun(file, baseline, error)) throw std::runtime_error(error);
+
+		for (const auto& file : candidateFiles)
+			if (!vfx::compare::loadRun(file, candidate, error)) throw std::runtime_error(error);
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "vfxBenchCompare: " << e.what() << "\n";
+		return EXIT_INVALID;
+	}
+
+	// Keys of both formats match, single scenarios named differently (e.g. CSV
+	// compared to JSON scenario) are still paired, but user is told so
+	if (baseline.size() == 1 && candidate.size() == 1 && baseline.begin()->first != candidate.begin()->first)
+	{
+		std::cerr << "vfxBenchCompare: comparing scenario " << candidate.begin()->first << " as " << baseline.begin()->first << "\n";
+
+		auto scenario = candidate.begin()->second;
+		candidate.clear();
+		candidate[baseline.begin()->first] = scenario;
+	}
+
+	std::printf("%-32s %-20s %10s %10s %9s %20s %8s\n", "scenario", "stage", "base [ms]", "cand [ms]", "change", "confidence", "p");
+
+	unsigned int regressions = 0;
+	unsigned int compared = 0;
+
+	for (const auto& scenario : baseline)
+	{
+		auto candidateScenario = candidate.find(scenario.first);
+		if (candidateScenario == candidate.end())
+		{
+			std::printf("%-32s missing in candidate\n", scenario.first.c_str());
+			continue;
+		}
+
+		for (const auto& stage : scenario.second)
+		{
+			auto candidateStage = candidateScenario->second.find(stage.first);
+			if (candidateStage == candidateScenario->second.end() || stage.second.empty() || candidateStage->second.empty())
+			{
+				std::printf("%-32s %-20s no samples to compare\n", scenario.first.c_str(), stage.first.c_str());
+				continue;
+			}
+
+			auto comparison = vfx::compare::compare(stage.second, candidateStage->second, settings);
+			printComparison(scenario.first, stage.first, comparison);
+
+			++compared;
+			if (comparison.regression) ++regressions;
+		}
+	}
+
+	for (const auto& scenario : candidate)
+	{
+		if (baseline.find(scenario.first) == baseline.end())
+			std::printf("%-32s missing in baseline\n", scenario.first.c_str());
+	}
+
+	std::printf("\n%u of %u stages regressed by more than %.1f%% (alpha %.3f)\n", regressions, compared, settings.threshold * 100.0, settings.alpha);
+
+	return regressions > 0 ? EXIT_REGRESSION : EXIT_SUCCESS;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include "Fluid.h"
+#include "Profiler.h"
+#include "graphics/Camera.h"
+
+#include <string>
+#include <vector>
+
+namespace vfx
+{
+	/// \brief	Runs profiling scenarios of config file without user interaction.
+	///
+	///			Every scenario is run at every grid resolution of profiling
+	///			section. Simulation restarts for each run, warmup frames are
+	///			followed by measured frames whose stage times are summarized.
+	class Benchmark
+	{
+	public:
+		/// \brief	Statistics of stage or health counter in single run.
+		struct Result
+		{
+			std::string scenario;
+			glm::ivec3 resolution;
+			std::string stage;					//!< Stage or counter name.
+			std::vector<float> times;			//!< Stage time of measured frames [ms] or counter values.
+			profile::Statistics statistics;
+		};
+
+		/// \param configFile Config file with profiling section.
+		explicit Benchmark(const std::string& configFile);
+
+		/// \brief	Runs all scenarios, context has to be current.
+		///
+		/// \return False if config has no scenarios or resolutions.
+		bool run();
+
+		/// \brief	Writes results as CSV, one row per stage of run.
+		bool writeCsv(const std::string& file) const;
+
+		/// \brief	Writes results with stage times of all measured frames,
+		///			health counters of scenarios with statistics and benchmark
+		///			settings as JSON.
+		bool writeJson(const std::string& file) const;
+
+	private:
+		/// \brief	Runs scenario at given resolution and stores its results.
+		void runScenario(const profile::TestData& scenario, const glm::ivec3& resolution);
+
+	private:
+		std::string mConfigFile;
+		std::string mDevice;				//!< Renderer and version of driver.
+		Fluid mFluid;
+		gfx::Camera mCamera;
+		std::vector<Result> mResults;		//!< Results in order of runs.
+		std::vector<Result> mCounters;		//!< Health counters in order of runs.
+	};
+}
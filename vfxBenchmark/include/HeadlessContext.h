@@ -0,0 +1,40 @@
+#pragma once
+
+#include "GL/glew.h"
+
+#include <EGL/egl.h>
+
+namespace vfx
+{
+	/// \brief	OpenGL 4.5 core context without window.
+	///
+	///			Context is created on surfaceless EGL display (Mesa, including
+	///			software drivers), so no display server is required. Frames are
+	///			rendered to framebuffer object owned by context, which stays
+	///			bound as render target of default framebuffer.
+	class HeadlessContext
+	{
+	public:
+		HeadlessContext();
+		~HeadlessContext();
+
+		HeadlessContext(const HeadlessContext&) = delete;
+		HeadlessContext& operator=(const HeadlessContext&) = delete;
+
+		/// \brief	Creates context, makes it current and loads GL functions.
+		///
+		/// \param width Width of render target.
+		/// \param height Height of render target.
+		/// \return False if context could not be created.
+		bool initialize(int width, int height);
+
+		/// \brief	Releases render target and context.
+		void shutdown();
+
+	private:
+		EGLDisplay mDisplay;
+		EGLContext mContext;
+		GLuint mFramebuffer;
+		GLuint mRenderbuffers[2];		//!< Color and depth.
+	};
+}
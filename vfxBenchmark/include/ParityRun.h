@@ -0,0 +1,41 @@
+#pragma once
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include "Fluid.h"
+
+#include <string>
+
+namespace vfx
+{
+	/// \brief	Runs GPU simulation for fixed number of steps and exports its volumes.
+	///
+	///			Settings and exported files match vfxSimulateCPU, so volumes of both
+	///			backends are compared by vfxCompareVolumes. Nothing is rendered,
+	///			stages run as soon as their pipelines are linked.
+	class ParityRun
+	{
+	public:
+		/// \brief	Simulation settings, defaults of vfxSimulateCPU.
+		struct Settings
+		{
+			glm::ivec3 size = glm::ivec3(64);
+			unsigned int steps = 100;
+			unsigned int obstacle = 0;			//!< 0 - boundary, 1 - sphere, 2 - box.
+			int iterations = 20;				//!< Jacobi iterations.
+			float deltaTime = 1.0f / 60.0f;
+			bool macCormack = true;				//!< Advection of density and temperature.
+		};
+
+		explicit ParityRun(const Settings& settings);
+
+		/// \brief	Runs simulation and exports <prefix>_density.vfxv and <prefix>_temperature.vfxv,
+		///			context has to be current.
+		///
+		/// \return False if pipelines failed to link or volumes could not be written.
+		bool run(const std::string& prefix);
+
+	private:
+		Settings mSettings;
+		Fluid mFluid;
+	};
+}
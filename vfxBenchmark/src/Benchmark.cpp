@@ -0,0 +1,238 @@
+#include "Benchmark.h"
+#include "vfxEngine.h"
+
+#include <fstream>
+
+#include "ostreamwrapper.h"
+#include "prettywriter.h"
+
+namespace vfx
+{
+	namespace
+	{
+		const float FRAME_TIME = 1.0f / 60.0f;		//!< Fixed time step, runs are reproducible.
+		const std::string DELIMITER = ",";
+
+		std::string getString(GLenum name)
+		{
+			auto value = reinterpret_cast<const char*>(glGetString(name));
+			return value ? value : "";
+		}
+
+		std::string toString(const glm::ivec3& resolution)
+		{
+			return std::to_string(resolution.x) + "x" + std::to_string(resolution.y) + "x" + std::to_string(resolution.z);
+		}
+
+		template<typename Writer>
+		void writeResult(Writer& writer, const Benchmark::Result& result, const char* nameKey, const char* samplesKey)
+		{
+			const auto& statistics = result.statistics;
+
+			writer.StartObject();
+			writer.Key("scenario"); writer.String(result.scenario.c_str());
+			writer.Key("resolution");
+			writer.StartArray();
+			writer.Int(result.resolution.x);
+			writer.Int(result.resolution.y);
+			writer.Int(result.resolution.z);
+			writer.EndArray();
+			writer.Key(nameKey); writer.String(result.stage.c_str());
+			writer.Key("samples"); writer.Uint64(statistics.samples);
+			writer.Key("mean"); writer.Double(statistics.mean);
+			writer.Key("median"); writer.Double(statistics.median);
+			writer.Key("p95"); writer.Double(statistics.p95);
+			writer.Key("p99"); writer.Double(statistics.p99);
+			writer.Key("stddev"); writer.Double(statistics.stddev);
+
+			// Samples allow comparison of runs by rank tests
+			writer.Key(samplesKey);
+			writer.StartArray();
+			for (auto sample : result.times)
+				writer.Double(sample);
+			writer.EndArray();
+			writer.EndObject();
+		}
+
+		void addCounters(const SimulationStatistics::Values& values)
+		{
+			profile::Profiler::addCounter("divergence_l2", values.divergenceL2);
+			profile::Profiler::addCounter("divergence_max", values.divergenceMax);
+			profile::Profiler::addCounter("mass", values.mass);
+			profile::Profiler::addCounter("max_velocity", values.maxVelocity);
+			profile::Profiler::addCounter("cfl", values.cfl);
+			profile::Profiler::addCounter("active_voxels", static_cast<float>(values.activeVoxels));
+		}
+	}
+
+	Benchmark::Benchmark(const std::string& configFile)
+		: mConfigFile(configFile)
+	{
+	}
+
+	bool Benchmark::run()
+	{
+		profile::Profiler::loadProfilingData(mConfigFile);
+
+		const auto& scenarios = profile::Profiler::getScenarios();
+		const auto& resolutions = profile::Profiler::getResolutions();
+
+		if (scenarios.empty() || resolutions.empty())
+		{
+			LOG_ERROR("Benchmark - No profiling scenarios in " + mConfigFile);
+			return false;
+		}
+
+		mDevice = getString(GL_RENDERER) + "|" + getString(GL_VERSION);
+
+		// Same state as interactive demo
+		glEnable(GL_DEPTH_TEST);
+		glEnable(GL_CULL_FACE);
+		glEnable(GL_BLEND);
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		glClearColor(1.0, 1.0, 1.0, 1.0);
+
+		mFluid.Initialize(glm::vec3(resolutions.front()));
+		mFluid.position = glm::vec3(0.0f, 0.0f, 0.0f);
+		mFluid.scale = glm::vec3(1.0f, 1.0f, 1.0f);
+		mCamera.moveTo(glm::vec3(0.5f, 0.5f, 2.0f));
+
+		for (const auto& scenario : scenarios)
+		{
+			for (const auto& resolution : resolutions)
+				runScenario(scenario, resolution);
+		}
+
+		return true;
+	}
+
+	void Benchmark::runScenario(const profile::TestData& scenario, const glm::ivec3& resolution)
+	{
+		LOG_INFO("Benchmark - Running " + scenario.name + " at " + toString(resolution));
+
+		mFluid.resize(resolution);
+		mFluid.applySettings(scenario);
+
+		auto& renderer = system::Renderer::getInstance();
+		auto& queries = renderer.getTimestampQueries();
+
+		// Frame ending at index i reads timestamps of frame i - latency + 1
+		const auto firstMeasured = profile::Profiler::warmupFrames + queries.getLatency() - 1;
+		const auto frames = firstMeasured + profile::Profiler::measuredFrames;
+
+		const auto droppedBefore = queries.getDroppedFrames();
+		profile::Profiler::clearStageTimes();
+
+		auto statisticsRead = mFluid.getStatistics().readCount;
+
+		for (unsigned int frame = 0; frame < frames; ++frame)
+		{
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+			mFluid.simulate(FRAME_TIME);
+			mFluid.render(FRAME_TIME, &mCamera);
+
+			renderer.endFrame();
+
+			// Frames without read results are skipped by profiler
+			if (frame >= firstMeasured)
+				profile::Profiler::collect();
+
+			// Counters are read back with their own latency, each result is taken once
+			const auto& statistics = mFluid.getStatistics();
+			if (frame >= firstMeasured && statistics.readCount != statisticsRead)
+				addCounters(statistics);
+
+			statisticsRead = statistics.readCount;
+		}
+
+		auto dropped = queries.getDroppedFrames() - droppedBefore;
+		if (dropped > 0)
+			LOG_WARNING("Benchmark - " + std::to_string(dropped) + " frames were not measured, timestamps were not available in time");
+
+		for (const auto& stage : profile::Profiler::getStageTimes())
+		{
+			Result result;
+			result.scenario = scenario.name;
+			result.resolution = resolution;
+			result.stage = stage.first;
+			result.times = stage.second;
+			result.statistics = profile::Profiler::computeStatistics(stage.second);
+			mResults.push_back(result);
+		}
+
+		for (const auto& counter : profile::Profiler::getCounters())
+		{
+			Result result;
+			result.scenario = scenario.name;
+			result.resolution = resolution;
+			result.stage = counter.first;
+			result.times = counter.second;
+			result.statistics = profile::Profiler::computeStatistics(counter.second);
+			mCounters.push_back(result);
+		}
+	}
+
+	bool Benchmark::writeCsv(const std::string& file) const
+	{
+		std::ofstream ofs(file, std::ios::out | std::ios::trunc);
+		if (!ofs.is_open())
+		{
+			LOG_ERROR("Benchmark - Failed to write " + file);
+			return false;
+		}
+
+		ofs << "scenario" << DELIMITER << "resolution" << DELIMITER << "stage" << DELIMITER << "samples" << DELIMITER
+			<< "mean" << DELIMITER << "median" << DELIMITER << "p95" << DELIMITER << "p99" << DELIMITER << "stddev" << "\n";
+
+		for (const auto& result : mResults)
+		{
+			const auto& statistics = result.statistics;
+
+			ofs << result.scenario << DELIMITER << toString(result.resolution) << DELIMITER << result.stage << DELIMITER << statistics.samples << DELIMITER
+				<< statistics.mean << DELIMITER << statistics.median << DELIMITER << statistics.p95 << DELIMITER << statistics.p99 << DELIMITER << statistics.stddev << "\n";
+		}
+
+		LOG_INFO("Benchmark - Results written to " + file);
+		return true;
+	}
+
+	bool Benchmark::writeJson(const std::string& file) const
+	{
+		std::ofstream ofs(file, std::ios::out | std::ios::trunc);
+		if (!ofs.is_open())
+		{
+			LOG_ERROR("Benchmark - Failed to write " + file);
+			return false;
+		}
+
+		rapidjson::OStreamWrapper osw(ofs);
+		rapidjson::PrettyWriter<rapidjson::OStreamWrapper> writer(osw);
+
+		writer.StartObject();
+		writer.Key("device"); writer.String(mDevice.c_str());
+		writer.Key("warmup_frames"); writer.Uint(profile::Profiler::warmupFrames);
+		writer.Key("measured_frames"); writer.Uint(profile::Profiler::measuredFrames);
+
+		writer.Key("results");
+		writer.StartArray();
+
+		for (const auto& result : mResults)
+			writeResult(writer, result, "stage", "times");
+
+		writer.EndArray();
+
+		// Kept apart from results, counters are not times
+		writer.Key("counters");
+		writer.StartArray();
+
+		for (const auto& counter : mCounters)
+			writeResult(writer, counter, "counter", "values");
+
+		writer.EndArray();
+		writer.EndObject();
+
+		LOG_INFO("Benchmark - Results written to " + file);
+		return true;
+	}
+}
@@ -0,0 +1,153 @@
+#include "HeadlessContext.h"
+#include "OGL.h"
+#include "Logger.h"
+
+#include <EGL/eglext.h>
+
+#include <cstring>
+#include <string>
+
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+#define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif
+
+namespace vfx
+{
+	namespace
+	{
+		bool hasExtension(const char* extensions, const char* name)
+		{
+			return extensions && std::strstr(extensions, name) != nullptr;
+		}
+
+		EGLDisplay getSurfacelessDisplay()
+		{
+			auto clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+
+			if (hasExtension(clientExtensions, "EGL_MESA_platform_surfaceless"))
+			{
+				auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+				if (getPlatformDisplay)
+					return getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+			}
+
+			// Default display works as well when it supports surfaceless contexts
+			return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+		}
+	}
+
+	HeadlessContext::HeadlessContext()
+		: mDisplay(EGL_NO_DISPLAY)
+		, mContext(EGL_NO_CONTEXT)
+		, mFramebuffer(0)
+		, mRenderbuffers{ 0, 0 }
+	{
+	}
+
+	HeadlessContext::~HeadlessContext()
+	{
+		shutdown();
+	}
+
+	bool HeadlessContext::initialize(int width, int height)
+	{
+		mDisplay = getSurfacelessDisplay();
+
+		EGLint major = 0, minor = 0;
+		if (mDisplay == EGL_NO_DISPLAY || !eglInitialize(mDisplay, &major, &minor))
+		{
+			LOG_ERROR("HeadlessContext - Failed to initialize EGL display");
+			return false;
+		}
+
+		if (!hasExtension(eglQueryString(mDisplay, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context"))
+		{
+			LOG_ERROR("HeadlessContext - EGL_KHR_surfaceless_context is not supported");
+			return false;
+		}
+
+		const EGLint configAttributes[] =
+		{
+			EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+			EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+			EGL_NONE
+		};
+
+		EGLConfig config;
+		EGLint configs = 0;
+		if (!eglChooseConfig(mDisplay, configAttributes, &config, 1, &configs) || configs == 0)
+		{
+			LOG_ERROR("HeadlessContext - No EGL config supports OpenGL");
+			return false;
+		}
+
+		const EGLint contextAttributes[] =
+		{
+			EGL_CONTEXT_MAJOR_VERSION, 4,
+			EGL_CONTEXT_MINOR_VERSION, 5,
+			EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+			EGL_NONE
+		};
+
+		eglBindAPI(EGL_OPENGL_API);
+		mContext = eglCreateContext(mDisplay, config, EGL_NO_CONTEXT, contextAttributes);
+
+		if (mContext == EGL_NO_CONTEXT || !eglMakeCurrent(mDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, mContext))
+		{
+			LOG_ERROR("HeadlessContext - Failed to create OpenGL 4.5 context");
+			return false;
+		}
+
+		// GLX is unavailable without display server, GL functions are loaded regardless
+		auto error = glewInit();
+		if (error != GLEW_OK && error != GLEW_ERROR_NO_GLX_DISPLAY)
+		{
+			LOG_ERROR("HeadlessContext - Failed to initialize GLEW: " + std::string(reinterpret_cast<const char*>(glewGetErrorString(error))));
+			return false;
+		}
+
+		// Surfaceless context has no default framebuffer
+		GL_CHECK(glGenRenderbuffers(2, mRenderbuffers));
+		GL_CHECK(glBindRenderbuffer(GL_RENDERBUFFER, mRenderbuffers[0]));
+		GL_CHECK(glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height));
+		GL_CHECK(glBindRenderbuffer(GL_RENDERBUFFER, mRenderbuffers[1]));
+		GL_CHECK(glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height));
+		GL_CHECK(glBindRenderbuffer(GL_RENDERBUFFER, 0));
+
+		GL_CHECK(glGenFramebuffers(1, &mFramebuffer));
+		GL_CHECK(glBindFramebuffer(GL_FRAMEBUFFER, mFramebuffer));
+		GL_CHECK(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, mRenderbuffers[0]));
+		GL_CHECK(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, mRenderbuffers[1]));
+
+		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		{
+			LOG_ERROR("HeadlessContext - Render target is incomplete");
+			return false;
+		}
+
+		GL_CHECK(glViewport(0, 0, width, height));
+
+		LOG_INFO("HeadlessContext - EGL " + std::to_string(major) + "." + std::to_string(minor) + ", " + reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+		return true;
+	}
+
+	void HeadlessContext::shutdown()
+	{
+		if (mContext != EGL_NO_CONTEXT)
+		{
+			glDeleteFramebuffers(1, &mFramebuffer);
+			glDeleteRenderbuffers(2, mRenderbuffers);
+			mFramebuffer = 0;
+
+			eglMakeCurrent(mDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+			eglDestroyContext(mDisplay, mContext);
+			mContext = EGL_NO_CONTEXT;
+		}
+
+		if (mDisplay != EGL_NO_DISPLAY)
+		{
+			eglTerminate(mDisplay);
+			mDisplay = EGL_NO_DISPLAY;
+		}
+	}
+}
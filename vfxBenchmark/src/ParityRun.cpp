@@ -0,0 +1,56 @@
+#include "ParityRun.h"
+#include "vfxEngine.h"
+
+#include <chrono>
+#include <thread>
+
+namespace vfx
+{
+	ParityRun::ParityRun(const Settings& settings)
+		: mSettings(settings)
+	{
+	}
+
+	bool ParityRun::run(const std::string& prefix)
+	{
+		auto& renderer = system::Renderer::getInstance();
+
+		mFluid.Initialize(glm::vec3(mSettings.size));
+
+		// Stages of CPU simulation, statistics reduction is not part of it
+		mFluid.features = Features();
+		mFluid.features.statisticsEnabled = false;
+		mFluid.changeObstacle(mSettings.obstacle);
+		mFluid.pressure.iterations = mSettings.iterations;
+		mFluid.useMacCormackAdvection = mSettings.macCormack;
+
+		// Steps are skipped until pipelines are linked, every step has to run
+		while (!mFluid.isSimulationReady())
+		{
+			if (renderer.getPendingPipelineCount() == 0)
+			{
+				LOG_ERROR("ParityRun - Simulation pipelines failed to link");
+				return false;
+			}
+
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		LOG_INFO("ParityRun - Simulating " + std::to_string(mSettings.steps) + " steps");
+
+		for (unsigned int step = 0; step < mSettings.steps; ++step)
+		{
+			mFluid.simulate(mSettings.deltaTime);
+			renderer.endFrame();
+		}
+
+		if (!mFluid.exportVolumes(prefix))
+		{
+			LOG_ERROR("ParityRun - Failed to export volumes " + prefix);
+			return false;
+		}
+
+		LOG_INFO("ParityRun - Volumes exported to " + prefix + "_density.vfxv and " + prefix + "_temperature.vfxv");
+		return true;
+	}
+}
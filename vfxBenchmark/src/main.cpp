@@ -0,0 +1,95 @@
+#include "Benchmark.h"
+#include "ParityRun.h"
+#include "HeadlessContext.h"
+#include "vfxEngine.h"
+
+#include <cstdlib>
+#include <iostream>
+
+namespace
+{
+	void printUsage()
+	{
+		std::cout << "Usage: vfxBenchmark [config.json] [output]\n"
+			<< "Runs profiling scenarios of config and writes statistics to <output>.csv and <output>.json\n"
+			<< "       vfxBenchmark --export <prefix> [options]\n"
+			<< "Runs GPU simulation and exports volumes for comparison with vfxSimulateCPU --half --output by vfxCompareVolumes,\n"
+			<< "differences grow with steps, so compared runs should be short (e.g. --steps 25)\n"
+			<< "  --size <x> <y> <z>         grid size (default: 64 64 64)\n"
+			<< "  --steps <n>                simulation steps (default: 100)\n"
+			<< "  --dt <value>               time step (default: 1/60)\n"
+			<< "  --obstacle <index>         0 - boundary, 1 - sphere, 2 - box (default: 0)\n"
+			<< "  --iterations <n>           Jacobi iterations (default: 20)\n"
+			<< "  --semi-lagrangian          advect density and temperature by Semi-Lagrangian advection\n";
+	}
+
+	/// \brief Parses settings of export mode, options of vfxSimulateCPU.
+	bool parseSettings(int argc, char* argv[], vfx::ParityRun::Settings& settings)
+	{
+		for (int i = 3; i < argc; ++i)
+		{
+			std::string arg = argv[i];
+			int remaining = argc - i - 1;
+
+			auto nextInt = [&]() { return static_cast<int>(std::strtol(argv[++i], nullptr, 10)); };
+
+			if (arg == "--size" && remaining >= 3) { settings.size.x = nextInt(); settings.size.y = nextInt(); settings.size.z = nextInt(); }
+			else if (arg == "--steps" && remaining >= 1) settings.steps = static_cast<unsigned int>(nextInt());
+			else if (arg == "--dt" && remaining >= 1) settings.deltaTime = static_cast<float>(std::atof(argv[++i]));
+			else if (arg == "--obstacle" && remaining >= 1) settings.obstacle = static_cast<unsigned int>(nextInt());
+			else if (arg == "--iterations" && remaining >= 1) settings.iterations = nextInt();
+			else if (arg == "--semi-lagrangian") settings.macCormack = false;
+			else return false;
+		}
+
+		return settings.size.x >= 2 && settings.size.y >= 2 && settings.size.z >= 2 && settings.obstacle <= 2;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc > 1 && (std::string(argv[1]) == "-h" || std::string(argv[1]) == "--help"))
+	{
+		printUsage();
+		return EXIT_SUCCESS;
+	}
+
+	bool exportMode = argc > 1 && std::string(argv[1]) == "--export";
+	vfx::ParityRun::Settings settings;
+
+	if (exportMode && (argc < 3 || !parseSettings(argc, argv, settings)))
+	{
+		printUsage();
+		return EXIT_FAILURE;
+	}
+
+	std::string config = argc > 1 ? argv[1] : "config.json";
+	std::string output = argc > 2 ? argv[2] : "benchmark";
+
+	vfx::HeadlessContext context;
+	if (!context.initialize(1280, 720))
+		return EXIT_FAILURE;
+
+	int status = EXIT_SUCCESS;
+
+	// GL objects of fluid are released while context is current
+	if (exportMode)
+	{
+		vfx::ParityRun parity(settings);
+
+		if (!parity.run(output))
+			status = EXIT_FAILURE;
+	}
+	else
+	{
+		vfx::Benchmark benchmark(config);
+
+		if (!benchmark.run() || !benchmark.writeCsv(output + ".csv") || !benchmark.writeJson(output + ".json"))
+			status = EXIT_FAILURE;
+	}
+
+	vfx::system::Renderer::getInstance().shutdown();
+	context.shutdown();
+
+	return status;
+}
@@ -30,24 +30,19 @@ namespace vfx
 	{
 		static float timer = 1.0f;
 
-		mFluid.advect(deltaTime);
+		float injectionTimeStep = 0.0f;
 
 		if (timer < 0.0f)
 		{
 			timer = 5.0f;
-			mFluid.inject(1.0f);
+			injectionTimeStep = 1.0f;
 		}
 		else
 		{
 			timer -= deltaTime;
 		}
 
-		mFluid.computeBuoyancy(deltaTime);
-		mFluid.computeVorticity();
-		mFluid.computeConfinement(deltaTime);
-		mFluid.computeDivergence();
-		mFluid.solvePressure();
-		mFluid.projectAndSubtract();
+		mFluid.simulate(deltaTime, injectionTimeStep);
 	}
 
 	void DemoBase::updateRotated(float deltaTime)
@@ -71,16 +66,9 @@ namespace vfx
 		updateStandard(deltaTime);
 	}
 
-	void DemoBase::updateStandard(float deltaTime)
-	{
-		mFluid.advect(deltaTime);
-		mFluid.inject(deltaTime);
-		mFluid.computeBuoyancy(deltaTime);
-		mFluid.computeVorticity();
-		mFluid.computeConfinement(deltaTime);
-		mFluid.computeDivergence();
-		mFluid.solvePressure();
-		mFluid.projectAndSubtract();
+	void DemoBase::updateStandard(float deltaTime)
+	{
+		mFluid.simulate(deltaTime);
 	}
 
 	void DemoBase::renderUI()
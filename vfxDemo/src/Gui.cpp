@@ -86,6 +86,10 @@ namespace vfx
 			{
 				ImGui::SliderFloat("jitter##shadows", &fluid->shadowsJitter, 0.0f, 1.0f, "%.1f");
 				ImGui::SliderInt("samples##shadows", &fluid->shadowsSamples, 0, 128);
+
+				int technique = static_cast<int>(fluid->shadows.technique);
+				if (ImGui::Combo("technique##shadows", &technique, "Automatic\0Volume\0Deep opacity map\0\0")) fluid->shadows.technique = static_cast<ShadowTechnique>(technique);
+				if (fluid->shadows.technique != ShadowTechnique::Volume) ImGui::SliderInt("layers##shadows", &fluid->shadows.deepOpacityLayers, 4, 64);
 			}
 
 			ImGui::Text("position");
@@ -101,7 +105,9 @@ namespace vfx
 			// Blur tab
 			if (ImGui::CollapsingHeader("Blur"))
 			{
-				ImGui::SliderInt("kernel size##blur", &fluid->blurFeatures.blurKernelSize, 3, 20);
+				int mode = static_cast<int>(fluid->blurFeatures.mode);
+				if (ImGui::Combo("mode##blur", &mode, "Automatic\0Separable\0Recursive\0\0")) fluid->blurFeatures.mode = static_cast<BlurMode>(mode);
+				ImGui::SliderInt("kernel size##blur", &fluid->blurFeatures.blurKernelSize, 3, 33);
 				ImGui::Checkbox("density##blur", &fluid->blurFeatures.densityBlurEnabled);
 				if (fluid->blurFeatures.densityBlurEnabled) { ImGui::SameLine(); ImGui::SliderFloat("##densityBlurSlider", &fluid->blurFeatures.densityBlurFactor, 0.0f, 5.0f); }
 				ImGui::Checkbox("shadows##blur", &fluid->blurFeatures.shadowsBlurEnabled);
@@ -110,6 +116,30 @@ namespace vfx
 				if (fluid->blurFeatures.obstacleBlurEnabled) { ImGui::SameLine(); ImGui::SliderFloat("##obstacleBlurSlider", &fluid->blurFeatures.obstacleBlurFactor, 0.0f, 5.0f); }
 				ImGui::Checkbox("radiance##blur", &fluid->blurFeatures.radianceBlurEnabled);
 				if (fluid->blurFeatures.radianceBlurEnabled) { ImGui::SameLine(); ImGui::SliderFloat("##obstacleBlurSlider", &fluid->blurFeatures.radianceBlurFactor, 0.0f, 5.0f); }
+				if (ImGui::Button("Benchmark##blur")) fluid->benchmarkBlur();
+			}
+
+			// Scattering tab
+			if (fluid->features.scatteringEnabled && ImGui::CollapsingHeader("Scattering"))
+			{
+				int quality = static_cast<int>(fluid->scattering.quality);
+				if (ImGui::Combo("quality##scattering", &quality, "Low\0Medium\0High\0\0")) fluid->scattering.quality = static_cast<ScatteringQuality>(quality);
+				ImGui::SliderFloat("albedo##scattering", &fluid->scattering.albedo, 0.0f, 1.0f);
+				ImGui::SliderFloat("octave weight##scattering", &fluid->scattering.octaveWeight, 0.0f, 1.0f);
+				ImGui::SliderFloat("intensity##scattering", &fluid->scattering.intensity, 0.0f, 10.0f);
+			}
+
+			// Adaptive stepping tab
+			if (ImGui::CollapsingHeader("Adaptive stepping"))
+			{
+				ImGui::Checkbox("enabled##adaptive", &fluid->adaptiveStep.enabled);
+				if (fluid->adaptiveStep.enabled)
+				{
+					ImGui::SliderFloat("min step scale##adaptive", &fluid->adaptiveStep.minStepScale, 0.1f, 1.0f);
+					ImGui::SliderFloat("max step scale##adaptive", &fluid->adaptiveStep.maxStepScale, 1.0f, 8.0f);
+					ImGui::SliderFloat("gradient threshold##adaptive", &fluid->adaptiveStep.gradientThreshold, 0.01f, 5.0f);
+					ImGui::SliderFloat("transmittance growth##adaptive", &fluid->adaptiveStep.transmittanceGrowth, 1.0f, 8.0f);
+				}
 			}
 
 			ImGui::SliderFloat("density##fluid", &fluid->densityFactor, 0.1f, 200.0f);
@@ -160,7 +190,23 @@ namespace vfx
 		}
 
 		// Projection tab
-		if (ImGui::CollapsingHeader("Pressure")) ImGui::SliderInt("iterations", &fluid->pressure.iterations, 1, 50);
+		if (ImGui::CollapsingHeader("Pressure"))
+		{
+			ImGui::SliderInt("iterations", &fluid->pressure.iterations, 1, 50);
+
+			// Residual after projection shows what more iterations would buy
+			ImGui::Checkbox("health counters##pressure", &fluid->features.statisticsEnabled);
+			if (fluid->features.statisticsEnabled)
+			{
+				const auto& statistics = fluid->getStatistics();
+				float activeRatio = statistics.fluidVoxels > 0 ? 100.0f * statistics.activeVoxels / statistics.fluidVoxels : 0.0f;
+
+				ImGui::Text("divergence L2: %.3e, max: %.3e", statistics.divergenceL2, statistics.divergenceMax);
+				ImGui::Text("mass: %.1f", statistics.mass);
+				ImGui::Text("max velocity: %.2f (CFL %.2f)", statistics.maxVelocity, statistics.cfl);
+				ImGui::Text("active voxels: %u (%.1f%%)", statistics.activeVoxels, activeRatio);
+			}
+		}
 
 		// Buoyancy
 		if (ImGui::CollapsingHeader("Buoyancy"))
@@ -191,7 +237,29 @@ namespace vfx
 		{
 			const char* items[] = { "Disabled", "Front faces", "Back faces", "Directions" };
 			ImGui::Combo("Type##debug", &fluid->domainDebugRenderMode, items, 4);
+
+			if (ImGui::Button("Export volumes##debug")) fluid->exportVolumes("fluid");
+
+			const auto& statistics = StateCache::getInstance().getStatistics();
+			ImGui::Text("GL bindings: %llu issued, %llu filtered", statistics.issued, statistics.filtered);
+
+			auto& queries = system::Renderer::getInstance().getTimestampQueries();
+			ImGui::Text("GPU times (%u frames behind, %llu dropped):", queries.getLatency(), static_cast<unsigned long long>(queries.getDroppedFrames()));
+			for (const auto& result : queries.getResults())
+				ImGui::Text("%*s%s: %.3f ms", result.depth * 2, "", result.name.c_str(), result.milliseconds);
+
+			auto& tuner = system::Renderer::getInstance().getWorkGroupTuner();
+			if (tuner.isTuning()) ImGui::Text("Tuning work group sizes...");
+			else if (ImGui::Button("Tune work groups##debug")) tuner.start();
+
+			// Open in chrome://tracing or ui.perfetto.dev
+			auto& tracer = Tracer::getInstance();
+			if (!tracer.isEnabled() && ImGui::Button("Start trace##debug")) tracer.start();
+			else if (tracer.isEnabled() && ImGui::Button("Stop trace##debug")) tracer.stop("trace.json");
 		}
+
+		// Counters cover single frame
+		StateCache::getInstance().resetStatistics();
 	}
 
 	void GUI::renderInjectionSection(Fluid* fluid)
@@ -25,6 +25,7 @@ has been used. This class also represents object renderer.
 
 #include <assert.h>
 #include "Mesh.h"
+#include "graphics/StateCache.h"
 #include <stdio.h>
 #include <glm/glm.hpp>
 #include <iostream>
@@ -392,8 +393,7 @@ void Mesh::RenderSimple(){
 		}
 		else
 		{
-			glActiveTexture(GL_TEXTURE0);
-			glBindTexture(GL_TEXTURE_2D, defaultTextureOne);
+			vfx::StateCache::getInstance().bindTexture(0, defaultTextureOne);
 		}
 
 		glDrawElementsBaseVertex(GL_TRIANGLES, meshes[i].numIndices, GL_UNSIGNED_INT,
@@ -437,16 +437,14 @@ void Mesh::Render(GLuint shader)
 				}
 			}
 			else {
-				glActiveTexture(GL_TEXTURE0);
-				glBindTexture(GL_TEXTURE_2D, defaultTextureOne);
+				vfx::StateCache::getInstance().bindTexture(0, defaultTextureOne);
 			}
 
 			if (bump_textures[MaterialIndex] != NULL){
 				bump_textures[MaterialIndex]->Bind(GL_TEXTURE1);
 			}
 			else {
-				glActiveTexture(GL_TEXTURE1);
-				glBindTexture(GL_TEXTURE_2D, defaultNormalTexture);
+				vfx::StateCache::getInstance().bindTexture(1, defaultNormalTexture);
 			}
 
 			if (spec_textures[MaterialIndex] != NULL){
@@ -454,8 +452,7 @@ void Mesh::Render(GLuint shader)
 				
 			}
 			else {
-				glActiveTexture(GL_TEXTURE2);
-				glBindTexture(GL_TEXTURE_2D, defaultTextureOne);
+				vfx::StateCache::getInstance().bindTexture(2, defaultTextureOne);
 			}
 
 			if (shader)
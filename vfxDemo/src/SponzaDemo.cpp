@@ -17,6 +17,9 @@ namespace vfx
 
 		mGUI.initialize(&mFluid);
 		mSponza.LoadMesh("data/models/crysponza/sponza.obj");
+
+		// Mesh loading binds textures directly
+		StateCache::getInstance().invalidate();
 		
 		mCamera.moveTo(glm::vec3(116.294, 238.282, -18.8551));
 		mCamera.lookAt(glm::vec3(0, 300, -50));
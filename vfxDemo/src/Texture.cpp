@@ -28,6 +28,7 @@ To load textures, stb_image.c library has been used.
 #include <GL\glew.h>
 #include "stb_image.c"
 #include "Texture.h"
+#include "graphics/StateCache.h"
 
 
 /// <summary>
@@ -99,8 +100,7 @@ bool Texture::Load(bool srgb)
 /// <param name="TextureUnit">texture unit.</param>
 void Texture::Bind(GLenum TextureUnit)
 {
-    glActiveTexture(TextureUnit);
-    glBindTexture(m_textureTarget, m_textureObj);
+    vfx::StateCache::getInstance().bindTexture(TextureUnit - GL_TEXTURE0, m_textureObj);
 }
 
 /// <summary>
@@ -113,12 +113,10 @@ void Texture::Bind(GLenum TextureUnit, GLuint defaultTex)
 {
 	if (m_textureObj == -1)
 	{
-		glActiveTexture(TextureUnit);
-		glBindTexture(m_textureTarget, defaultTex);
+		vfx::StateCache::getInstance().bindTexture(TextureUnit - GL_TEXTURE0, defaultTex);
 	}
 	else
 	{
-		glActiveTexture(TextureUnit);
-		glBindTexture(m_textureTarget, m_textureObj);
+		vfx::StateCache::getInstance().bindTexture(TextureUnit - GL_TEXTURE0, m_textureObj);
 	}
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Tracer.h"
+
 #include <functional>
 #include <map>
 
@@ -44,6 +46,10 @@ namespace vfx { namespace engine
 
 		static void notify(const T& event)
 		{
+			// Zone name has to outlive tracer, events of channel share their name
+			static const std::string name = event.getEventName();
+			TRACE_ZONE(name.c_str());
+
 			for (const auto &observer : Listeners())
 				observer.second(event);
 		}
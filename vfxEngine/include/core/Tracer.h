@@ -0,0 +1,138 @@
+#pragma once
+
+#include "Singleton.h"
+
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+
+/// \brief	Traces enclosing block on CPU, name has to be string literal.
+#define TRACE_ZONE(name) vfx::TraceZone TRACE_CONCAT(traceZone, __LINE__)(name)
+
+namespace vfx
+{
+	/// \brief	Hierarchical CPU and GPU tracing exported to Chrome trace format
+	///			(chrome://tracing, Perfetto).
+	///
+	///			Each thread records zones to its own fixed size buffer without
+	///			locking, buffer is registered on first zone of thread. GPU zones
+	///			come from timestamp queries and are mapped to CPU clock by offset
+	///			calibrated while tracing. Zone recorded while disabled costs one
+	///			relaxed atomic load, so tracing can stay compiled in.
+	class Tracer : public Singleton<Tracer>
+	{
+	public:
+		/// \brief	Clears recorded zones and starts tracing.
+		void start();
+
+		/// \brief	Stops tracing and writes recorded zones.
+		///
+		/// \param file Output file in Chrome trace JSON format.
+		/// \return False if file could not be written.
+		bool stop(const std::string& file);
+
+		bool isEnabled() const { return mEnabled.load(std::memory_order_relaxed); }
+
+		/// \brief	Trace started last, incremented by start.
+		unsigned int getSession() const { return mSession.load(std::memory_order_relaxed); }
+
+		/// \brief	Names calling thread in exported trace. Buffer of thread is
+		///			allocated on its first zone, not by naming it.
+		void setThreadName(const std::string& name);
+
+		/// \brief	Records CPU zone of calling thread.
+		///
+		/// \param name Zone name, has to outlive tracer (string literal).
+		/// \param begin Begin time [ns], see now.
+		/// \param end End time [ns].
+		void addZone(const char* name, uint64_t begin, uint64_t end);
+
+		/// \brief	Records GPU zone.
+		///
+		/// \param name Zone name.
+		/// \param begin GPU timestamp of zone begin [ns].
+		/// \param end GPU timestamp of zone end [ns].
+		void addGpuZone(const std::string& name, uint64_t begin, uint64_t end);
+
+		/// \brief	True if GPU clock offset should be measured, calibrateGpuClock is expected to follow.
+		bool needsGpuCalibration() const;
+
+		/// \brief	Sets offset of GPU clock from GL_TIMESTAMP read just now.
+		void calibrateGpuClock(uint64_t gpuTime);
+
+		/// \brief	Monotonic CPU time [ns].
+		static uint64_t now();
+
+	private:
+		/// \brief	Complete zone.
+		struct Zone
+		{
+			const char* name;
+			uint64_t begin;
+			uint64_t end;
+		};
+
+		/// \brief	Zones of single thread, written only by owning thread.
+		struct ThreadBuffer
+		{
+			std::vector<Zone> zones;			//!< Preallocated storage.
+			std::atomic<size_t> count{ 0 };		//!< Zones written, published with release.
+			std::atomic<uint64_t> dropped{ 0 };	//!< Zones not recorded because buffer was full.
+			std::atomic<unsigned int> session{ 0 };	//!< Session zones belong to.
+			unsigned int threadId = 0;
+			std::string name;
+		};
+
+		/// \brief	GPU zone, names are not literals.
+		struct GpuZone
+		{
+			std::string name;
+			uint64_t begin;
+			uint64_t end;
+		};
+
+		/// \brief	Returns buffer of calling thread, registers it on first call.
+		ThreadBuffer& getThreadBuffer();
+
+	private:
+		std::atomic<bool> mEnabled{ false };
+		std::atomic<uint64_t> mStartTime{ 0 };			//!< CPU time of start [ns].
+		std::atomic<unsigned int> mSession{ 0 };		//!< Incremented by start.
+
+		std::mutex mMutex;								//!< Guards registration, GPU zones and export.
+		std::vector<std::unique_ptr<ThreadBuffer>> mBuffers;
+		std::vector<GpuZone> mGpuZones;
+		int64_t mGpuClockOffset = 0;					//!< CPU time minus GPU time [ns].
+		uint64_t mLastCalibration = 0;					//!< CPU time of last calibration [ns].
+	};
+
+	/// \brief	Records CPU zone covering its lifetime when tracer is enabled.
+	class TraceZone
+	{
+	public:
+		explicit TraceZone(const char* name)
+			: mName(name)
+			, mBegin(Tracer::getInstance().isEnabled() ? Tracer::now() : 0)
+		{
+		}
+
+		~TraceZone()
+		{
+			if (mBegin != 0 && Tracer::getInstance().isEnabled())
+				Tracer::getInstance().addZone(mName, mBegin, Tracer::now());
+		}
+
+		TraceZone(const TraceZone&) = delete;
+		TraceZone& operator=(const TraceZone&) = delete;
+
+	private:
+		const char* mName;
+		uint64_t mBegin;
+	};
+}
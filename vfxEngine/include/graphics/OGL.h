@@ -13,6 +13,15 @@ void CheckOpenGLError(const char* stmt, const char* fname, int line);
 #define GL_CHECK(stmt) stmt
 #endif
 
+/// \brief True if driver compiles shaders and links programs in background
+///		   (GL_ARB_parallel_shader_compile or GL_KHR_parallel_shader_compile).
+///		   Queried on first call, context must be current.
+inline bool HasParallelShaderCompile()
+{
+	static const bool supported = GLEW_ARB_parallel_shader_compile || glewIsSupported("GL_KHR_parallel_shader_compile");
+	return supported;
+}
+
 inline void CheckOpenGLError(const char* stmt, const char* fname, int line)
 {
 	GLenum err = glGetError();
@@ -7,6 +7,7 @@
 
 #include <unordered_map>
 #include <memory>
+#include <vector>
 
 namespace vfx
 {
@@ -20,12 +21,39 @@ namespace vfx
 		Pipeline();
 		virtual ~Pipeline();
 
-		void Create();
+		void Create();
+
+		/// \brief Submits link of attached stages without waiting for result,
+		///		   pipeline is usable after Finish.
+		void CreateAsync();
+
+		/// \brief Returns true when link has finished, never blocks when driver
+		///		   links in parallel.
+		bool IsLinkComplete() const;
+
+		/// \brief Waits for link submitted by CreateAsync and queries uniforms.
+		///
+		/// \return False if link failed.
+		bool Finish();
+
+		/// \brief Creates pipeline from program binary instead of attached stages.
+		///
+		/// \param format Binary format.
+		/// \param binary Program binary.
+		/// \return False if driver rejected the binary.
+		bool CreateFromBinary(GLenum format, const std::vector<char>& binary);
+
+		/// \brief Retrieves binary of linked pipeline.
+		///
+		/// \param format Binary format.
+		/// \param binary Program binary.
+		/// \return False if pipeline is not linked.
+		bool GetBinary(GLenum& format, std::vector<char>& binary) const;
 
 		/// \brief Binds the pipeline.
 		void Bind() const;
 
-		/// \brief Unbinds this pipeline.
+		/// \brief Ends use of this pipeline, program stays current until other pipeline is bound.
 		void Unbind() const;
 
 		/// \brief Adds a shader stage to the pipeline.
@@ -118,8 +146,8 @@ namespace vfx
 		}
 
 	private:
-		/// \brief Links attached shaders to the pipeline.
-		void Link();
+		/// \brief Checks link status of the pipeline, logs link errors.
+		bool CheckLinkStatus() const;
 
 		/// \brief Queries the uniform variables names and locations.
 		void QueryUniforms();
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "OGL.h"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace vfx
+{
+	/// \brief	On-disk cache of linked program binaries.
+	///
+	///			Binaries are keyed by hash of shader sources, defines and
+	///			driver (vendor, renderer, version) strings, so driver update
+	///			or edited shader maps to new entry. Entry rejected by driver
+	///			is reported as miss and caller compiles from source.
+	class ProgramBinaryCache
+	{
+	public:
+		/// \param directory Directory holding cache entries, created on first store.
+		ProgramBinaryCache(const std::string& directory = "shadercache");
+
+		/// \brief	True if driver supports at least one program binary format.
+		bool isSupported() const { return mIsSupported; }
+
+		/// \brief	Computes cache key of program.
+		///
+		/// \param sources Sources of all program stages in attach order.
+		/// \param defines Preprocessor definitions program is compiled with.
+		uint64_t computeKey(const std::vector<std::string>& sources, const std::string& defines = "") const;
+
+		/// \brief	Reads cached binary.
+		///
+		/// \param key Program key.
+		/// \param format Binary format.
+		/// \param binary Binary data.
+		/// \return True if entry exists and is valid.
+		bool load(uint64_t key, GLenum& format, std::vector<char>& binary) const;
+
+		/// \brief	Writes binary to cache, existing entry is replaced.
+		///
+		/// \param key Program key.
+		/// \param format Binary format.
+		/// \param binary Binary data.
+		void store(uint64_t key, GLenum format, const std::vector<char>& binary) const;
+
+		/// \brief	64-bit FNV-1a hash.
+		///
+		/// \param data Hashed data.
+		/// \param seed Hash of preceding data, chains hashes.
+		static uint64_t hash(const std::string& data, uint64_t seed = 14695981039346656037ull);
+
+	private:
+		std::string getEntryPath(uint64_t key) const;
+
+	private:
+		std::string mDirectory;		//!< Cache directory.
+		std::string mDriver;		//!< Vendor, renderer and version of driver.
+		bool mIsSupported;			//!< Driver exposes binary formats.
+	};
+}
@@ -9,9 +9,18 @@ namespace vfx
 	class Shader : public INonCopy
 	{
 	public:
-		Shader(GLenum type, const std::string& source, const std::string& shaderFile = "");
+		/// \param deferStatusCheck Only submits compilation, status is checked by checkCompileStatus.
+		Shader(GLenum type, const std::string& source, const std::string& shaderFile = "", bool deferStatusCheck = false);
 		~Shader();
 
+		/// \brief Returns true when compilation has finished, never blocks when
+		///		   driver compiles in parallel (GL_ARB/KHR_parallel_shader_compile).
+		bool isCompileComplete() const;
+
+		/// \brief Checks compile status, blocks until compilation finishes.
+		///		   Throws std::runtime_error on failure.
+		void checkCompileStatus() const;
+
 		/// \brief Attaches this shader to pipeline object.
 		///
 		/// \param pipeline The pipeline.
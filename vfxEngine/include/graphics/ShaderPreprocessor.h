@@ -0,0 +1,39 @@
+#pragma once
+
+#include <map>
+#include <set>
+#include <string>
+
+namespace vfx
+{
+	/// \brief	Preprocessor definitions of shader variant, name -> value.
+	typedef std::map<std::string, std::string> ShaderDefines;
+
+	/// \brief	Prepares GLSL source for compilation of specific variant.
+	///
+	///			Resolves #include "file" directives relative to shader folder
+	///			(each file is included once) and inserts #define lines of the
+	///			variant right after #version directive. #line directives keep
+	///			compiler messages pointing to lines of the original file.
+	class ShaderPreprocessor
+	{
+	public:
+		/// \param includeFolder Folder included files are searched in.
+		ShaderPreprocessor(const std::string& includeFolder = "shaders");
+
+		/// \brief	Returns source of variant.
+		///
+		/// \param source Shader source.
+		/// \param defines Variant definitions.
+		std::string process(const std::string& source, const ShaderDefines& defines) const;
+
+		/// \brief	Stable textual form of definitions, used as part of variant key.
+		static std::string serialize(const ShaderDefines& defines);
+
+	private:
+		std::string resolveIncludes(const std::string& source, std::set<std::string>& included, unsigned int depth) const;
+
+	private:
+		std::string mIncludeFolder;		//!< Folder of included files.
+	};
+}
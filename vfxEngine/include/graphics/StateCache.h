@@ -0,0 +1,111 @@
+#pragma once
+
+#include "OGL.h"
+
+#include <map>
+#include <tuple>
+#include <utility>
+
+namespace vfx
+{
+	/// \brief	Shadow copy of OpenGL binding state filtering redundant state changes.
+	///
+	///			Tracks current program, texture units, image units and indexed
+	///			buffer bindings. One instance exists per thread (GL context is
+	///			current on single thread). Any code changing tracked state
+	///			directly must call invalidate() afterwards.
+	class StateCache
+	{
+	public:
+		/// \brief	Counters of state changes requested through the cache.
+		struct Statistics
+		{
+			unsigned long long issued = 0;		//!< Calls forwarded to OpenGL.
+			unsigned long long filtered = 0;	//!< Redundant calls dropped.
+		};
+
+		/// \brief	Returns state cache of calling thread.
+		static StateCache& getInstance();
+
+		/// \brief	Makes program current.
+		///
+		/// \param program Program handle, 0 unbinds current program.
+		void useProgram(GLuint program);
+
+		/// \brief	Binds texture to texture unit.
+		///
+		/// \param unit Texture unit index (not GL_TEXTUREi enum).
+		/// \param texture Texture handle, target is given by the texture.
+		void bindTexture(GLuint unit, GLuint texture);
+
+		/// \brief	Binds texture level to image unit.
+		void bindImageTexture(GLuint unit, GLuint texture, GLint level, GLboolean layered, GLint layer, GLenum access, GLenum format);
+
+		/// \brief	Binds buffer to indexed binding point of target.
+		///
+		/// \param target Indexed buffer target (GL_SHADER_STORAGE_BUFFER, GL_UNIFORM_BUFFER, ...).
+		/// \param index Binding point.
+		/// \param buffer Buffer handle.
+		void bindBufferBase(GLenum target, GLuint index, GLuint buffer);
+
+		/// \brief	Binds buffer range to indexed binding point of target. Ranges are
+		///			not tracked, call is always issued.
+		void bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+
+		/// \brief	Deletes textures and forgets units they are tracked on, deleted
+		///			names may be reused by GL for new textures.
+		void deleteTextures(GLsizei count, const GLuint* textures);
+
+		/// \brief	Deletes buffers and forgets binding points they are tracked on.
+		void deleteBuffers(GLsizei count, const GLuint* buffers);
+
+		/// \brief	Deletes program and forgets it if it is tracked as current.
+		void deleteProgram(GLuint program);
+
+		/// \brief	Forgets all tracked state, next requests are issued unconditionally.
+		void invalidate();
+
+		/// \brief	Counters of issued and filtered calls since last reset.
+		const Statistics& getStatistics() const { return mStatistics; }
+
+		/// \brief	Resets counters.
+		void resetStatistics() { mStatistics = Statistics(); }
+
+	private:
+		StateCache() = default;
+
+		/// \brief	Tracked value with validity flag.
+		template<typename T>
+		struct Tracked
+		{
+			T value = T();
+			bool valid = false;
+		};
+
+		/// \brief	Updates tracked value, returns true if call has to be issued.
+		template<typename T>
+		bool update(Tracked<T>& tracked, const T& value)
+		{
+			if (tracked.valid && tracked.value == value)
+			{
+				++mStatistics.filtered;
+				return false;
+			}
+
+			tracked.value = value;
+			tracked.valid = true;
+			++mStatistics.issued;
+			return true;
+		}
+
+		typedef std::tuple<GLuint, GLint, GLboolean, GLint, GLenum, GLenum> ImageBinding;
+
+	private:
+		Tracked<GLuint> mProgram;								//!< Current program.
+		std::map<GLuint, Tracked<GLuint>> mTextures;			//!< Texture bound to each texture unit.
+		std::map<GLuint, Tracked<ImageBinding>> mImages;		//!< Image bound to each image unit.
+		std::map<std::pair<GLenum, GLuint>, Tracked<GLuint>> mBuffers;	//!< Buffer bound to each (target, index).
+
+		Statistics mStatistics;
+	};
+}
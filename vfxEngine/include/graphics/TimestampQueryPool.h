@@ -0,0 +1,140 @@
+#pragma once
+
+#include "OGL.h"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace vfx
+{
+	/// \brief	GPU timing of named scopes using GL_TIMESTAMP queries.
+	///
+	///			Queries are allocated once and used as ring buffer of frames.
+	///			Results of frame are read when its slot is reused, latency
+	///			frames later, so CPU never waits for GPU. Frame whose results
+	///			are still not available at that point is dropped instead.
+	class TimestampQueryPool
+	{
+	public:
+		/// \brief	Timing of finished scope.
+		struct Result
+		{
+			std::string name;
+			unsigned int depth;			//!< Nesting level, 0 for outermost scopes.
+			double milliseconds;
+			uint64_t begin;				//!< GPU timestamp of begin [ns].
+			uint64_t end;				//!< GPU timestamp of end [ns].
+		};
+
+		/// \param latency Frames between recording and reading results.
+		/// \param scopesPerFrame Maximum number of scopes recorded in frame, further scopes are ignored.
+		TimestampQueryPool(unsigned int latency = 4, unsigned int scopesPerFrame = 256);
+		~TimestampQueryPool();
+
+		TimestampQueryPool(const TimestampQueryPool&) = delete;
+		TimestampQueryPool& operator=(const TimestampQueryPool&) = delete;
+
+		/// \brief	Writes timestamp starting scope, scopes may nest.
+		///
+		/// \return Scope handle, -1 if frame ran out of queries. Ignored scope
+		///			still has to be ended to keep nesting of following scopes.
+		int beginScope(const std::string& name);
+
+		/// \brief	Writes timestamp ending scope.
+		///
+		/// \param scope Handle returned by beginScope, including -1.
+		void endScope(int scope);
+
+		/// \brief	Finishes frame, reads results of frame recorded latency frames ago.
+		///
+		/// \return True if results were replaced by those of read frame.
+		bool nextFrame();
+
+		/// \brief	Results of most recently read frame in order scopes began.
+		const std::vector<Result>& getResults() const { return mResults; }
+
+		/// \brief	True if last nextFrame read results, otherwise results are
+		///			those already reported for earlier frame.
+		bool hasNewResults() const { return mHasNewResults; }
+
+		/// \brief	Index of frame being recorded, incremented by nextFrame.
+		uint64_t getFrameIndex() const { return mFrameIndex; }
+
+		/// \brief	Index of frame results were read from.
+		uint64_t getResultsFrame() const { return mResultsFrame; }
+
+		/// \brief	Frames between recording and reading results.
+		unsigned int getLatency() const { return static_cast<unsigned int>(mFrames.size()); }
+
+		/// \brief	Number of frames dropped because results were not available in time.
+		uint64_t getDroppedFrames() const { return mDroppedFrames; }
+
+	private:
+		/// \brief	Scope recorded in frame, queries are indices to mQueries.
+		struct Scope
+		{
+			std::string name;
+			unsigned int depth;
+			unsigned int begin;
+			unsigned int end;
+			bool closed;
+		};
+
+		/// \brief	Slot of ring buffer.
+		struct Frame
+		{
+			std::vector<Scope> scopes;
+			unsigned int firstQuery;	//!< First query of slot.
+			unsigned int usedQueries;	//!< Queries reserved by scopes of frame.
+			unsigned int lastQuery;		//!< Last query written in frame.
+			uint64_t index;				//!< Frame recorded in slot.
+		};
+
+		/// \brief	Reads results of frame, returns false if they are not available yet.
+		bool readResults(const Frame& frame);
+
+	private:
+		std::vector<GLuint> mQueries;		//!< Queries of all slots.
+		std::vector<Frame> mFrames;			//!< Ring buffer of frames.
+		std::vector<Result> mResults;		//!< Results of last read frame.
+		unsigned int mScopesPerFrame;
+		unsigned int mCurrentFrame;			//!< Slot being recorded.
+		unsigned int mDepth;				//!< Nesting level of next scope.
+		uint64_t mDroppedFrames;
+		uint64_t mFrameIndex;				//!< Frame being recorded.
+		uint64_t mResultsFrame;				//!< Frame of current results.
+		bool mHasNewResults;				//!< Results were read by last nextFrame.
+	};
+
+	/// \brief	Times enclosing block, ends scope on destruction unless ended explicitly.
+	class TimestampScope
+	{
+	public:
+		TimestampScope(TimestampQueryPool& pool, const std::string& name)
+			: mPool(pool)
+			, mScope(pool.beginScope(name))
+			, mIsOpen(true)
+		{
+		}
+
+		~TimestampScope() { end(); }
+
+		TimestampScope(const TimestampScope&) = delete;
+		TimestampScope& operator=(const TimestampScope&) = delete;
+
+		/// \brief	Ends scope before end of block.
+		void end()
+		{
+			if (!mIsOpen) return;
+
+			mPool.endScope(mScope);
+			mIsOpen = false;
+		}
+
+	private:
+		TimestampQueryPool& mPool;
+		int mScope;
+		bool mIsOpen;
+	};
+}
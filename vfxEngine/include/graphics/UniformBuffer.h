@@ -0,0 +1,55 @@
+#pragma once
+
+#include "INonCopy.h"
+#include "OGL.h"
+
+#include <vector>
+
+namespace vfx
+{
+	/// \brief	Persistently mapped uniform buffer used as ring of per-frame regions.
+	///
+	///			Parameter blocks (std140 structures) are copied into region of
+	///			the current frame and bound by range, upload is single memcpy.
+	///			Region is reused after fence of the frame that wrote it has
+	///			been signaled, so CPU never overwrites data GPU still reads.
+	class UniformBuffer : public INonCopy
+	{
+	public:
+		/// \param frameCapacity Size of region available for one frame in bytes.
+		/// \param frames Number of regions (frames in flight).
+		UniformBuffer(GLsizeiptr frameCapacity = 64 * 1024, unsigned int frames = 3);
+		~UniformBuffer();
+
+		/// \brief	Copies parameter block to ring buffer and binds it to uniform block binding.
+		///
+		/// \param binding Uniform block binding point.
+		/// \param block Parameter block, layout must match std140 block of shader.
+		template<typename T>
+		void upload(GLuint binding, const T& block)
+		{
+			upload(binding, &block, sizeof(T));
+		}
+
+		/// \brief	Copies data to ring buffer and binds it to uniform block binding.
+		///
+		/// \param binding Uniform block binding point.
+		/// \param data Uploaded data.
+		/// \param size Size of data in bytes.
+		void upload(GLuint binding, const void* data, GLsizeiptr size);
+
+		/// \brief	Fences region of current frame and moves to the next one.
+		void nextFrame();
+
+	private:
+		GLuint mObjectID;				//!< Buffer handle.
+		unsigned char* mMappedData;		//!< Persistently mapped buffer memory.
+
+		GLsizeiptr mFrameCapacity;		//!< Size of one region.
+		GLsizeiptr mOffset;				//!< Write offset within current region.
+		GLint mAlignment;				//!< Uniform buffer offset alignment.
+
+		unsigned int mFrame;			//!< Index of current region.
+		std::vector<GLsync> mFences;	//!< Fences of regions written by previous frames.
+	};
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "OGL.h"
+
+#include "glm/glm.hpp"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace vfx
+{
+	/// \brief	Selects work group size of compute stages by measurement.
+	///
+	///			While tuning, each stage is dispatched with every candidate
+	///			size over several frames and timed with GL_TIMESTAMP queries.
+	///			Fastest size is stored per device in cache file, stages are
+	///			keyed by name and grid size as optimum depends on resolution.
+	///			Stages without stored size use 8x8x8, stage that stops being
+	///			dispatched while tuned keeps it as well. Stored sizes exceeding
+	///			limits of device are rejected and their stages are tuned again.
+	class WorkGroupTuner
+	{
+	public:
+		/// \param file Cache file, read on construction and written when tuning finishes.
+		WorkGroupTuner(const std::string& file = "workgroups.json");
+		~WorkGroupTuner();
+
+		/// \brief	Work group sizes tried during tuning.
+		static const std::vector<glm::uvec3>& getCandidates();
+
+		/// \brief	Size used by stages not tuned yet.
+		static glm::uvec3 getDefaultSize() { return glm::uvec3(8, 8, 8); }
+
+		/// \brief	Starts tuning of stages dispatched from now on, their previous
+		///			results are replaced.
+		void start();
+
+		/// \brief	True until every dispatched stage tried all candidates.
+		bool isTuning() const { return mIsTuning; }
+
+		/// \brief	Returns work group size of stage, candidate being measured while tuning.
+		///
+		/// \param stage Stage key, see getStageKey.
+		glm::uvec3 getWorkGroupSize(const std::string& stage);
+
+		/// \brief	Key of stage dispatched over given grid.
+		static std::string getStageKey(const std::string& pipelineName, const glm::uvec3& gridSize);
+
+		/// \brief	Writes timestamp preceding dispatch of stage, no-op if not tuning.
+		void beginMeasurement(const std::string& stage);
+
+		/// \brief	Writes timestamp following dispatch of stage, no-op if not tuning.
+		void endMeasurement();
+
+		/// \brief	Collects available timestamps and advances candidates, called once per frame.
+		///			Never blocks.
+		void update();
+
+	private:
+		/// \brief	Measurement state of stage.
+		struct Stage
+		{
+			glm::uvec3 size = getDefaultSize();	//!< Selected size.
+			bool tuned = true;					//!< All candidates measured.
+			unsigned int generation = 0;		//!< Tuning run stage was last tuned in.
+			unsigned int idleFrames = 0;		//!< Frames since last dispatch while tuning.
+			size_t candidate = 0;				//!< Candidate being measured.
+			std::vector<double> time;			//!< Accumulated time of candidates [ms].
+			std::vector<unsigned int> samples;	//!< Measured dispatches of candidates.
+		};
+
+		/// \brief	Timestamp queries around single dispatch.
+		struct Measurement
+		{
+			std::string stage;
+			size_t candidate;
+			GLuint queries[2];
+		};
+
+		void load();
+		void save() const;
+
+		/// \brief	True if size is non-zero and within compute limits of device.
+		bool isSupported(const glm::uvec3& size) const;
+
+		/// \brief	Selects fastest candidate of stage.
+		void finishStage(const std::string& key, Stage& stage);
+
+	private:
+		std::string mFile;								//!< Cache file.
+		std::string mDevice;							//!< Vendor, renderer and version of driver.
+		std::map<std::string, Stage> mStages;			//!< Stages of this device.
+		std::map<std::string, std::map<std::string, glm::uvec3>> mOtherDevices;	//!< Cached sizes of other devices, kept on save.
+		std::vector<Measurement> mMeasurements;			//!< Measurements waiting for results, in submission order.
+		glm::uvec3 mMaxSize;							//!< GL_MAX_COMPUTE_WORK_GROUP_SIZE.
+		unsigned int mMaxInvocations;					//!< GL_MAX_COMPUTE_WORK_GROUP_INVOCATIONS.
+		bool mIsTuning = false;
+		bool mTuneAll = false;							//!< Tuning run replaces sizes of all stages, not only rejected ones.
+		bool mIsMeasuring = false;						//!< Measurement waits for end timestamp.
+		unsigned int mGeneration = 0;					//!< Tuning run, incremented by start.
+	};
+}
@@ -2,6 +2,7 @@
 
 #include "Singleton.h"
 
+#include <mutex>
 #include <string>
 #include <sstream>
 #include <vector>
@@ -72,6 +73,7 @@ namespace vfx
 		bool initialize();
 		bool shutDown();
 
+		/// \brief Records and prints message, may be called from any thread.
 		void Log(const std::string& msg, LogType type, unsigned int lineNumber, const std::string& fileName);
 
 	private:
@@ -79,5 +81,6 @@ namespace vfx
 
 	private:
 		std::vector<vfx::Log> mLogs;
+		std::mutex mMutex;		//!< Serializes logs of worker threads and main thread.
 	};
 }
\ No newline at end of file
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "ISystem.h"
+#include "Singleton.h"
+#include "WorkStealingScheduler.h"
+#include "glm/vec3.hpp"
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <vector>
+
+namespace vfx { namespace system
+{
+	/// \brief	Number of unfinished jobs.
+	///
+	///			Scheduling increments counter and finished job decrements it, both
+	///			by single atomic operation, so counters never block. Counter has
+	///			to outlive jobs counted by it.
+	class JobCounter
+	{
+	public:
+		JobCounter() : mValue(0) {}
+
+		JobCounter(const JobCounter&) = delete;
+		JobCounter& operator=(const JobCounter&) = delete;
+
+		unsigned int getValue() const { return mValue.load(std::memory_order_acquire); }
+		bool isDone() const { return getValue() == 0; }
+
+	private:
+		friend class JobSystem;
+
+		std::atomic<unsigned int> mValue;
+	};
+
+	/// \brief	Box [begin, end) of 3D index space, e.g. voxels of volume.
+	struct Range3D
+	{
+		glm::uvec3 begin = glm::uvec3(0);
+		glm::uvec3 end = glm::uvec3(0);
+
+		Range3D() = default;
+		Range3D(const glm::uvec3& begin_, const glm::uvec3& end_) : begin(begin_), end(end_) {}
+
+		glm::uvec3 getSize() const { return end - begin; }
+		bool isEmpty() const { return end.x <= begin.x || end.y <= begin.y || end.z <= begin.z; }
+	};
+
+	/// \brief	Tasks with dependencies, task starts once all tasks it depends on
+	///			have finished. Graph has to be acyclic and can be run repeatedly.
+	class TaskGraph
+	{
+	public:
+		typedef size_t TaskId;
+
+		/// \brief	Adds task to graph.
+		///
+		/// \param name Trace zone of task, has to be string literal.
+		/// \param function Work of task.
+		/// \return Identifier of task used by addDependency.
+		TaskId add(const char* name, const std::function<void()>& function);
+
+		/// \brief	Task after starts once task before has finished.
+		void addDependency(TaskId before, TaskId after);
+
+		size_t getTaskCount() const { return mTasks.size(); }
+
+	private:
+		friend class JobSystem;
+
+		struct Task
+		{
+			const char* name;
+			std::function<void()> function;
+			std::vector<TaskId> successors;
+			unsigned int dependencies = 0;				//!< Number of tasks task depends on.
+			std::atomic<unsigned int> pending{ 0 };		//!< Dependencies not finished in current run.
+		};
+
+		std::deque<Task> mTasks;						//!< Deque keeps atomics of tasks in place.
+	};
+
+	/// \brief	Work-stealing job scheduler of engine.
+	///
+	///			Jobs are scheduled by own instance of WorkStealingScheduler, CPU
+	///			simulation thread pool instantiates the same template with its own
+	///			deques and workers. Waiting thread executes jobs until its
+	///			counter reaches zero and sleeps while none is queued, so jobs may
+	///			wait for nested jobs and work runs on calling thread even without
+	///			workers. Jobs must not use GL context of main thread.
+	class JobSystem : public Singleton<JobSystem>, public ISystem
+	{
+	public:
+		typedef std::function<void()> JobFunction;
+		typedef std::function<void(const Range3D& range)> RangeFunction;
+
+		JobSystem();
+		~JobSystem();
+
+		/// \brief	Starts one worker less than hardware threads, waiting thread
+		///			is the last one.
+		void initialize() override;
+
+		/// \brief	Stops workers, jobs still queued run on waiting threads.
+		void shutdown() override;
+
+		unsigned int getWorkerCount() const { return mScheduler.getWorkerCount(); }
+
+		/// \brief	Schedules job.
+		///
+		/// \param job Work of job.
+		/// \param counter Counter incremented now and decremented once job has finished.
+		/// \param name Trace zone of job, has to be string literal.
+		void run(const JobFunction& job, JobCounter& counter, const char* name = "job");
+
+		/// \brief	Schedules tasks of graph without dependencies, other tasks are
+		///			scheduled as their dependencies finish. Graph must not be changed
+		///			or run again until counter reaches zero.
+		///
+		/// \param graph Tasks to be run.
+		/// \param counter Counter reaching zero once all tasks have finished.
+		void run(TaskGraph& graph, JobCounter& counter);
+
+		/// \brief	Executes jobs on calling thread until counter reaches zero,
+		///			sleeps while no job is queued.
+		void wait(const JobCounter& counter);
+
+		/// \brief	Calls function for subranges of range and waits until whole
+		///			range is processed. Range is halved along axis spanning most
+		///			grains until subrange fits into grain.
+		///
+		/// \param range Processed index space.
+		/// \param grain Subranges up to this size are not split further.
+		/// \param function Function processing subrange.
+		void parallelFor(const Range3D& range, const glm::uvec3& grain, const RangeFunction& function);
+
+	private:
+		struct Job
+		{
+			JobFunction function;
+			JobCounter* counter;
+			const char* name;
+		};
+
+		void execute(Job& job);
+
+		/// \brief	Pushes job running task of graph.
+		void scheduleTask(TaskGraph& graph, TaskGraph::TaskId task, JobCounter& counter);
+
+		/// \brief	Runs task of graph and schedules successors it was last dependency of.
+		void runTask(TaskGraph& graph, TaskGraph::TaskId task, JobCounter& counter);
+
+		/// \brief	Splits range down to grain, schedules upper halves and processes rest.
+		void split(Range3D range, const glm::uvec3& grain, const RangeFunction& function, JobCounter& counter);
+
+	private:
+		jobs::WorkStealingScheduler<Job> mScheduler;
+	};
+} }
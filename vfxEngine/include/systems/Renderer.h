@@ -2,16 +2,31 @@
 
 #include "Singleton.h"
 #include "ISystem.h"
+#include "graphics/ShaderPreprocessor.h"
+
+#include "glm/glm.hpp"
 
 #include <map>
+#include <set>
 #include <string>
 #include <memory>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+struct GLFWwindow;
 
 namespace vfx
 {
 	// Forward declarations.
 	class Shader;
 	class Pipeline;
+	class UniformBuffer;
+	class ProgramBinaryCache;
+	class WorkGroupTuner;
+	class TimestampQueryPool;
 }
 
 namespace vfx { namespace system
@@ -19,8 +34,8 @@ namespace vfx { namespace system
 	class Renderer : public Singleton<Renderer>, public ISystem
 	{
 	public:
-		Renderer() {}
-		virtual ~Renderer() {}
+		Renderer();
+		virtual ~Renderer();
 
 		void initialize() override;
 		void shutdown() override;
@@ -28,12 +43,110 @@ namespace vfx { namespace system
 		// shaders & pipelines
 		std::shared_ptr<Shader> addShaderModule(const std::string& file, const std::string& type, const std::string& shaderFile = "");
 		void createShaders(const std::string& shaderFolder = "shaders");
-		void createPipelines(const std::string& shaderFolder = "shaders");
+		/// \brief Creates pipelines listed in config.json.
+		///
+		/// \param shaderFolder Folder with shader sources.
+		/// \param async Only submits compilation of pipelines missing in binary cache,
+		///				 they stay pending until ready or first requested.
+		void createPipelines(const std::string& shaderFolder = "shaders", bool async = false);
 
 		const std::shared_ptr<Shader>& getShaderByName(const std::string& shaderName) const;
-		const std::shared_ptr<Pipeline>& getPipelineByName(const std::string& pipelineName) const;
+
+		/// \brief Returns pipeline, blocks until pending pipeline is linked.
+		const std::shared_ptr<Pipeline>& getPipelineByName(const std::string& pipelineName);
+
+		/// \brief Returns variant of pipeline compiled with additional definitions,
+		///		   variants are created on first request (or loaded from binary cache).
+		///
+		/// \param pipelineName Name of pipeline in config.json.
+		/// \param defines Definitions of variant, they override pipeline definitions.
+		const std::shared_ptr<Pipeline>& getPipelineVariant(const std::string& pipelineName, const ShaderDefines& defines);
+
+		/// \brief Returns compute pipeline compiled with work group size selected
+		///		   for stage dispatched over given grid.
+		///
+		/// \param pipelineName Name of pipeline in config.json, shader uses LOCAL_SIZE_* definitions.
+		/// \param gridSize Number of invocations in each dimension.
+		const std::shared_ptr<Pipeline>& getComputePipeline(const std::string& pipelineName, const glm::uvec3& gridSize);
+
+		/// \brief Dispatches bound pipeline returned by getComputePipeline, work group
+		///		   count is rounded up so shader has to check grid bounds.
+		///
+		/// \param pipelineName Name of pipeline in config.json.
+		/// \param gridSize Number of invocations in each dimension.
+		void dispatchCompute(const std::string& pipelineName, const glm::uvec3& gridSize);
+
+		/// \brief Work group sizes of compute stages, created on first use.
+		WorkGroupTuner& getWorkGroupTuner();
+
+		/// \brief Returns true if pipeline is linked, finishes it when its
+		///		   compilation completed. Never blocks.
+		bool isPipelineReady(const std::string& pipelineName);
+
+		/// \brief Number of pipelines still being compiled.
+		size_t getPendingPipelineCount() const { return mPendingPipelines.size() + mWorkerPipelines.size(); }
+
+		/// \brief Finishes pending pipelines whose compilation completed. Never blocks.
+		void updatePendingPipelines();
+
+		/// \brief Ring buffer for pipeline parameter blocks, created on first use.
+		UniformBuffer& getUniformBuffer();
+
+		/// \brief GPU timestamps of profiled scopes, created on first use.
+		TimestampQueryPool& getTimestampQueries();
+
+		/// \brief Finishes frame, advances per-frame resources.
+		void endFrame();
 
 	private:
+		/// \brief Shader files and definitions of pipeline from config.json.
+		struct PipelineDescription
+		{
+			std::vector<std::string> shaderFiles;
+			ShaderDefines defines;
+		};
+
+		/// \brief Reads shader files of pipeline and preprocesses them with given definitions.
+		std::vector<std::string> preprocessSources(const PipelineDescription& description, const ShaderDefines& defines) const;
+
+		/// \brief Creates pipeline from binary cache, returns false on miss.
+		bool loadCachedPipeline(uint64_t key, std::shared_ptr<Pipeline>& pipeline) const;
+
+		/// \brief Compiles and links pipeline, stores its binary to cache.
+		std::shared_ptr<Pipeline> compilePipeline(const std::vector<std::string>& shaderFiles, const std::vector<std::string>& shaderSources, uint64_t key);
+
+		/// \brief Pipeline with compilation submitted but not finished.
+		struct PendingPipeline
+		{
+			std::shared_ptr<Pipeline> pipeline;
+			std::vector<std::string> shaderFiles;
+			std::vector<std::string> shaderSources;
+			std::vector<std::shared_ptr<Shader>> shaders;
+			uint64_t key;
+		};
+
+		typedef std::map<std::string, PendingPipeline> PendingPipelineMap;
+
+		/// \brief Submits compilation of all shaders first and links pending pipelines
+		///		   afterwards, on context current on calling thread.
+		void submitPendingPipelines(PendingPipelineMap& pipelines) const;
+
+		/// \brief Checks compilation, registers pipeline and stores its binary.
+		///
+		/// \param name Pipeline name.
+		/// \param wait Block until compilation completes.
+		/// \return False if pipeline is still compiling.
+		bool finishPipeline(const std::string& name, bool wait);
+
+		/// \brief Takes pipelines handed back by compile worker into pending pipelines.
+		///
+		/// \param wait Block until worker finishes.
+		/// \return False if worker is still compiling.
+		bool collectCompileWorker(bool wait);
+
+		/// \brief Waits for compile worker and releases its context.
+		void joinCompileWorker();
+
 		unsigned int convertExtToGLShaderStage(const std::string& extension) const;
 			
 		template <typename T>
@@ -43,5 +156,23 @@ namespace vfx { namespace system
 	private:
 		std::map<std::string, std::shared_ptr<Shader>> mShaderMap;
 		std::map<std::string, std::shared_ptr<Pipeline>> mPipelineMap;
+		std::unique_ptr<UniformBuffer> mUniformBuffer;
+		std::unique_ptr<ProgramBinaryCache> mProgramCache;	//!< Linked programs of previous runs.
+		std::unique_ptr<ShaderPreprocessor> mPreprocessor;	//!< Resolves includes and definitions of shader sources.
+		std::unique_ptr<WorkGroupTuner> mWorkGroupTuner;	//!< Measured work group sizes of compute stages.
+		std::unique_ptr<TimestampQueryPool> mTimestampQueries;	//!< Profiled scopes of recent frames.
+		unsigned int mTraceSession = 0;						//!< Tracer session GPU zones are reported to.
+		uint64_t mTraceFirstFrame = 0;						//!< First frame recorded entirely while tracing.
+
+		std::map<std::string, PipelineDescription> mPipelineDescriptions;	//!< Descriptions of enabled pipelines.
+		std::map<std::string, std::shared_ptr<Pipeline>> mVariantMap;		//!< Pipeline variants keyed by name and definitions.
+
+		PendingPipelineMap mPendingPipelines;			//!< Pipelines being compiled, accessed by main thread only.
+		std::set<std::string> mWorkerPipelines;			//!< Names of pipelines owned by compile worker.
+		PendingPipelineMap mCompiledPipelines;			//!< Pipelines handed back by compile worker.
+		std::mutex mCompileMutex;						//!< Guards hand back of compiled pipelines.
+		std::thread mCompileWorker;						//!< Compiles pending pipelines when driver lacks parallel compile.
+		std::atomic<bool> mCompileWorkerDone;			//!< Worker handed back its pipelines.
+		GLFWwindow* mCompileContext = nullptr;			//!< Hidden context shared with main context, current on worker.
 	};
 } }
\ No newline at end of file
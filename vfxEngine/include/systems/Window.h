@@ -20,6 +20,13 @@ namespace vfx { namespace system
 		bool shutdownRequested() const;
 		void swapBuffers() const;
 
+		/// \brief Creates hidden window whose context shares objects with main
+		///		   window context, used by worker threads. Main thread only.
+		GLFWwindow* createSharedContext() const;
+
+		/// \brief Destroys context created by createSharedContext. Main thread only.
+		void destroySharedContext(GLFWwindow* context) const;
+
 	private:
 		GLFWwindow* mWindow;
 	};
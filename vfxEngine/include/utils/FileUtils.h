@@ -10,5 +10,8 @@ namespace vfx
 		std::string getExtention(const std::string& file);
 		std::string getBaseNameWithoutExt(const std::string& file);
 		std::string getBaseName(const std::string& file);
+
+		/// \brief Creates directory, succeeds also when directory already exists.
+		bool createDirectory(const std::string& directory);
 	}
 }
\ No newline at end of file
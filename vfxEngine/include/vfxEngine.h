@@ -5,10 +5,16 @@
 #include "systems/Input.h"
 #include "systems/Window.h"
 #include "systems/Renderer.h"
+#include "systems/JobSystem.h"
 #include "systems/Time.h"
 #include "Singleton.h"
 #include "graphics/Pipeline.h"
+#include "graphics/UniformBuffer.h"
+#include "graphics/StateCache.h"
+#include "graphics/WorkGroupTuner.h"
+#include "graphics/TimestampQueryPool.h"
 #include "core/ApplicationBase.h"
+#include "core/Tracer.h"
 #include "logger/Logger.h"
 #include "graphics/Quad.h"
 #include "scene/Transform.h"
@@ -6,11 +6,14 @@
 #include "GLFW/glfw3.h"
 
 #include "Input.h"
+#include "JobSystem.h"
 #include "Window.h"
 #include "Renderer.h"
+#include "StateCache.h"
 #include "ApplicationBase.h"
 
 #include "Time.h"
+#include "Tracer.h"
 #include "Channel.h"
 #include "EngineEvents.h"
 #include "Logger.h"
@@ -39,6 +42,7 @@ namespace vfx { namespace engine
 		vfx::system::Window::getInstance().initialize();
 		vfx::system::Input::getInstance().setupCallbacks(vfx::system::Window::getInstance().getWindowHandle());
 		vfx::system::Renderer::getInstance().initialize();
+		vfx::system::JobSystem::getInstance().initialize();
 
 		glewInit();
 	}
@@ -51,8 +55,12 @@ namespace vfx { namespace engine
 
 		Channel<event::EnginePostInit>::notify(event::EnginePostInit{});
 
+		Tracer::getInstance().setThreadName("Main");
+
 		while (!system::Window::getInstance().shutdownRequested())
 		{
+			TRACE_ZONE("frame");
+
 			Time::deltaTime = glfwGetTime() - Time::previousTime;
 			Time::previousTime = glfwGetTime();
 
@@ -62,7 +70,15 @@ namespace vfx { namespace engine
 			render(dt);
 			renderUI();
 
-			system::Window::getInstance().swapBuffers();
+			// User interface and other libraries change GL state behind the cache
+			StateCache::getInstance().invalidate();
+
+			{
+				TRACE_ZONE("swap buffers");
+				system::Window::getInstance().swapBuffers();
+			}
+
+			system::Renderer::getInstance().endFrame();
 			glfwPollEvents();
 		}
 
@@ -71,23 +87,30 @@ namespace vfx { namespace engine
 
 	void Engine::update(float delta_time)
 	{
+		TRACE_ZONE("update");
 		engine::Channel<event::EngineUpdate>::notify(event::EngineUpdate(delta_time));
 	}
 
 	void Engine::render(float deltaTime)
 	{
+		TRACE_ZONE("render");
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 		engine::Channel<event::EngineRender>::notify(event::EngineRender(deltaTime));
 	}
 
 	void Engine::renderUI()
 	{
+		TRACE_ZONE("render ui");
 		engine::Channel<event::EngineRenderUI>::notify(event::EngineRenderUI());
 	}
 
 	void Engine::shutdown()
 	{
 		engine::Channel<event::EngineShutdown>::notify(event::EngineShutdown());
+		system::JobSystem::getInstance().shutdown();
+
+		// Compile worker and GL objects of renderer need the context alive
+		system::Renderer::getInstance().shutdown();
 		glfwTerminate();
 	}
 
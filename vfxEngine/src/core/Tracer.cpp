@@ -0,0 +1,211 @@
+#include "Tracer.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+
+#include "ostreamwrapper.h"
+#include "writer.h"
+
+namespace vfx
+{
+	namespace
+	{
+		const size_t ZONES_PER_THREAD = 1 << 16;		//!< Capacity of thread buffer, ~1.5 MB.
+		const uint64_t CALIBRATION_PERIOD = 1000000000;	//!< GPU clock drift is corrected every second [ns].
+
+		/// \brief	Buffer of calling thread and session it was last used in.
+		thread_local void* threadBuffer = nullptr;
+		thread_local unsigned int threadSession = 0;
+
+		/// \brief	Name given to calling thread before its buffer was registered.
+		thread_local std::string threadName;
+	}
+
+	uint64_t Tracer::now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	void Tracer::start()
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		// Thread buffers are reset lazily by their owners, see getThreadBuffer
+		++mSession;
+		mGpuZones.clear();
+		mLastCalibration = 0;
+		mStartTime = now();
+
+		mEnabled.store(true, std::memory_order_release);
+		LOG_INFO("Tracer - Tracing started");
+	}
+
+	bool Tracer::stop(const std::string& file)
+	{
+		mEnabled.store(false, std::memory_order_release);
+
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		std::ofstream ofs(file, std::ios::out | std::ios::trunc);
+		if (!ofs.is_open())
+		{
+			LOG_WARNING("Tracer - Failed to write trace file: " + file);
+			return false;
+		}
+
+		rapidjson::OStreamWrapper osw(ofs);
+		rapidjson::Writer<rapidjson::OStreamWrapper> writer(osw);
+
+		const uint64_t startTime = mStartTime;
+		const unsigned int gpuThreadId = 0;
+		uint64_t dropped = 0;
+
+		auto writeZone = [&writer, startTime](const char* name, uint64_t begin, uint64_t end, unsigned int threadId)
+		{
+			// Zones may begin before start, e.g. frame zone enclosing start
+			begin = std::max(begin, startTime);
+			end = std::max(end, begin);
+
+			writer.StartObject();
+			writer.Key("name"); writer.String(name);
+			writer.Key("ph"); writer.String("X");
+			writer.Key("ts"); writer.Double((begin - startTime) * 1e-3);
+			writer.Key("dur"); writer.Double((end - begin) * 1e-3);
+			writer.Key("pid"); writer.Uint(1);
+			writer.Key("tid"); writer.Uint(threadId);
+			writer.EndObject();
+		};
+
+		auto writeThreadName = [&writer](const std::string& name, unsigned int threadId)
+		{
+			writer.StartObject();
+			writer.Key("name"); writer.String("thread_name");
+			writer.Key("ph"); writer.String("M");
+			writer.Key("pid"); writer.Uint(1);
+			writer.Key("tid"); writer.Uint(threadId);
+			writer.Key("args");
+			writer.StartObject();
+			writer.Key("name"); writer.String(name.c_str());
+			writer.EndObject();
+			writer.EndObject();
+		};
+
+		writer.StartObject();
+		writer.Key("traceEvents");
+		writer.StartArray();
+
+		writeThreadName("GPU", gpuThreadId);
+		for (const auto& zone : mGpuZones)
+			writeZone(zone.name.c_str(), zone.begin, zone.end, gpuThreadId);
+
+		for (const auto& buffer : mBuffers)
+		{
+			if (buffer->session.load(std::memory_order_acquire) != mSession) continue;
+
+			writeThreadName(buffer->name, buffer->threadId);
+
+			// Zones below count are complete, writer may still be appending
+			auto count = buffer->count.load(std::memory_order_acquire);
+			for (size_t i = 0; i < count; ++i)
+				writeZone(buffer->zones[i].name, buffer->zones[i].begin, buffer->zones[i].end, buffer->threadId);
+
+			dropped += buffer->dropped.load(std::memory_order_relaxed);
+		}
+
+		writer.EndArray();
+		writer.Key("displayTimeUnit"); writer.String("ms");
+		writer.EndObject();
+
+		if (dropped > 0)
+			LOG_WARNING("Tracer - " + std::to_string(dropped) + " zones dropped, thread buffers are full");
+
+		LOG_INFO("Tracer - Trace written to " + file);
+		return true;
+	}
+
+	void Tracer::setThreadName(const std::string& name)
+	{
+		auto buffer = static_cast<ThreadBuffer*>(threadBuffer);
+
+		// Threads that never record zone do not get buffer
+		if (!buffer)
+		{
+			threadName = name;
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(mMutex);
+		buffer->name = name;
+	}
+
+	void Tracer::addZone(const char* name, uint64_t begin, uint64_t end)
+	{
+		auto& buffer = getThreadBuffer();
+
+		// Only owner writes, export reads zones published by count
+		auto count = buffer.count.load(std::memory_order_relaxed);
+		if (count >= buffer.zones.size())
+		{
+			buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		buffer.zones[count] = { name, begin, end };
+		buffer.count.store(count + 1, std::memory_order_release);
+	}
+
+	void Tracer::addGpuZone(const std::string& name, uint64_t begin, uint64_t end)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		GpuZone zone;
+		zone.name = name;
+		zone.begin = begin + mGpuClockOffset;
+		zone.end = end + mGpuClockOffset;
+		mGpuZones.push_back(zone);
+	}
+
+	bool Tracer::needsGpuCalibration() const
+	{
+		return isEnabled() && (mLastCalibration == 0 || now() - mLastCalibration > CALIBRATION_PERIOD);
+	}
+
+	void Tracer::calibrateGpuClock(uint64_t gpuTime)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		mLastCalibration = now();
+		mGpuClockOffset = static_cast<int64_t>(mLastCalibration) - static_cast<int64_t>(gpuTime);
+	}
+
+	Tracer::ThreadBuffer& Tracer::getThreadBuffer()
+	{
+		auto buffer = static_cast<ThreadBuffer*>(threadBuffer);
+
+		if (!buffer)
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+
+			mBuffers.push_back(std::make_unique<ThreadBuffer>());
+			buffer = mBuffers.back().get();
+			buffer->zones.resize(ZONES_PER_THREAD);
+			buffer->threadId = static_cast<unsigned int>(mBuffers.size());
+			buffer->name = threadName.empty() ? "Thread " + std::to_string(buffer->threadId) : threadName;
+			threadBuffer = buffer;
+		}
+
+		// First zone of thread in new session discards previous one
+		auto session = mSession.load(std::memory_order_relaxed);
+		if (threadSession != session)
+		{
+			buffer->count.store(0, std::memory_order_relaxed);
+			buffer->dropped.store(0, std::memory_order_relaxed);
+			buffer->session.store(session, std::memory_order_release);
+			threadSession = session;
+		}
+
+		return *buffer;
+	}
+}
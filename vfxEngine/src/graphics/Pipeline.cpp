@@ -1,5 +1,6 @@
 #include "Pipeline.h"
-#include "Shader.h"
+#include "Shader.h"
+#include "StateCache.h"
 
 #include "Logger.h"
 
@@ -13,14 +14,74 @@ namespace vfx
 
 	Pipeline::~Pipeline()
 	{
-		GL_CHECK(glDeleteProgram(mObjectID));
+		StateCache::getInstance().deleteProgram(mObjectID);
 		LOG_DEBUG("Destroyed pipeline object");
 	}
 
 	void Pipeline::Create()
 	{
-		Link();
+		CreateAsync();
+		Finish();
+	}
+
+	void Pipeline::CreateAsync()
+	{
+		// Allows program binary cache to retrieve linked binary
+		GL_CHECK(glProgramParameteri(mObjectID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+		GL_CHECK(glLinkProgram(mObjectID));
+	}
+
+	bool Pipeline::IsLinkComplete() const
+	{
+		if (!HasParallelShaderCompile())
+			return true;
+
+		GLint complete = GL_TRUE;
+		GL_CHECK(glGetProgramiv(mObjectID, GL_COMPLETION_STATUS_ARB, &complete));
+
+		return complete == GL_TRUE;
+	}
+
+	bool Pipeline::Finish()
+	{
+		if (!CheckLinkStatus())
+			return false;
+
 		QueryUniforms();
+		return true;
+	}
+
+	bool Pipeline::CreateFromBinary(GLenum format, const std::vector<char>& binary)
+	{
+		GL_CHECK(glProgramBinary(mObjectID, format, binary.data(), static_cast<GLsizei>(binary.size())));
+
+		GLint status;
+		GL_CHECK(glGetProgramiv(mObjectID, GL_LINK_STATUS, &status));
+
+		if (!status)
+		{
+			LOG_DEBUG("Pipeline: program binary rejected by driver");
+			return false;
+		}
+
+		QueryUniforms();
+		LOG_DEBUG("Pipeline: created from program binary");
+
+		return true;
+	}
+
+	bool Pipeline::GetBinary(GLenum& format, std::vector<char>& binary) const
+	{
+		GLint status, length = 0;
+		GL_CHECK(glGetProgramiv(mObjectID, GL_LINK_STATUS, &status));
+		GL_CHECK(glGetProgramiv(mObjectID, GL_PROGRAM_BINARY_LENGTH, &length));
+
+		if (!status || length <= 0) return false;
+
+		binary.resize(length);
+		GL_CHECK(glGetProgramBinary(mObjectID, length, nullptr, &format, binary.data()));
+
+		return true;
 	}
 
 	void Pipeline::AddStage(const std::shared_ptr<Shader>& shader)
@@ -29,10 +90,8 @@ namespace vfx
 		LOG_DEBUG("Pipeline : added new stage");
 	}
 
-	void Pipeline::Link()
+	bool Pipeline::CheckLinkStatus() const
 	{
-		GL_CHECK(glLinkProgram(mObjectID));
-		
 		GLint status;
 		GL_CHECK(glGetProgramiv(mObjectID, GL_LINK_STATUS, &status));
 		
@@ -47,9 +106,12 @@ namespace vfx
 				LOG_ERROR("Failed to link pipeline, Error: " + std::string(info));
 				delete[] info;
 			}
+
+			return false;
 		}
 	
 		LOG_DEBUG("Pipeline: successfully linked");
+		return true;
 	}
 
 	void Pipeline::QueryUniforms()
@@ -75,16 +137,13 @@ namespace vfx
 
 	void Pipeline::Bind() const
 	{
-		GLint activePipeline;
-		GL_CHECK(glGetIntegerv(GL_CURRENT_PROGRAM, &activePipeline));
-		
-		if(activePipeline != mObjectID)
-			GL_CHECK(glUseProgram(mObjectID));
-	}
-
-	void Pipeline::Unbind() const
-	{
-		GL_CHECK(glUseProgram(0));
+		StateCache::getInstance().useProgram(mObjectID);
+	}
+
+	void Pipeline::Unbind() const
+	{
+		// Program stays current, binding it again for next stage is filtered by
+		// state cache. Every draw and dispatch binds its own pipeline first
 	}
 
 	int Pipeline::GetLocation(const std::string& rUniformName) const
@@ -0,0 +1,134 @@
+#include "ProgramBinaryCache.h"
+#include "FileUtils.h"
+#include "Logger.h"
+
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+
+namespace vfx
+{
+	namespace
+	{
+		const uint64_t FNV_PRIME = 1099511628211ull;
+
+		const uint32_t ENTRY_MAGIC = 0x42584656;	// "VFXB"
+		const uint32_t ENTRY_VERSION = 1;
+
+		/// \brief	Header preceding binary data of each entry.
+		struct EntryHeader
+		{
+			uint32_t magic;
+			uint32_t version;
+			uint32_t format;
+			uint32_t size;
+			uint64_t key;
+		};
+
+		std::string getString(GLenum name)
+		{
+			auto value = reinterpret_cast<const char*>(glGetString(name));
+			return value ? value : "";
+		}
+	}
+
+	ProgramBinaryCache::ProgramBinaryCache(const std::string& directory)
+		: mDirectory(directory)
+	{
+		GLint formats = 0;
+		GL_CHECK(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats));
+		mIsSupported = formats > 0;
+
+		mDriver = getString(GL_VENDOR) + "|" + getString(GL_RENDERER) + "|" + getString(GL_VERSION);
+
+		if (!mIsSupported)
+			LOG_WARNING("ProgramBinaryCache - Driver does not support program binaries, programs are compiled from source");
+	}
+
+	uint64_t ProgramBinaryCache::computeKey(const std::vector<std::string>& sources, const std::string& defines) const
+	{
+		uint64_t key = hash(mDriver);
+		key = hash(defines, key);
+
+		for (const auto& source : sources)
+		{
+			// Separator keeps boundaries between stages significant
+			key = hash(source, key);
+			key = hash(std::string(1, '\0'), key);
+		}
+
+		return key;
+	}
+
+	bool ProgramBinaryCache::load(uint64_t key, GLenum& format, std::vector<char>& binary) const
+	{
+		if (!mIsSupported) return false;
+
+		std::ifstream file(getEntryPath(key), std::ios::in | std::ios::binary);
+		if (!file.is_open()) return false;
+
+		EntryHeader header;
+		file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+		if (!file || header.magic != ENTRY_MAGIC || header.version != ENTRY_VERSION || header.key != key)
+		{
+			LOG_WARNING("ProgramBinaryCache - Invalid entry: " + getEntryPath(key));
+			return false;
+		}
+
+		binary.resize(header.size);
+		file.read(binary.data(), header.size);
+
+		if (!file)
+		{
+			LOG_WARNING("ProgramBinaryCache - Truncated entry: " + getEntryPath(key));
+			return false;
+		}
+
+		format = header.format;
+		return true;
+	}
+
+	void ProgramBinaryCache::store(uint64_t key, GLenum format, const std::vector<char>& binary) const
+	{
+		if (!mIsSupported || binary.empty()) return;
+
+		if (!file::createDirectory(mDirectory))
+		{
+			LOG_WARNING("ProgramBinaryCache - Failed to create directory: " + mDirectory);
+			return;
+		}
+
+		std::ofstream file(getEntryPath(key), std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+		{
+			LOG_WARNING("ProgramBinaryCache - Failed to write entry: " + getEntryPath(key));
+			return;
+		}
+
+		EntryHeader header = { ENTRY_MAGIC, ENTRY_VERSION, format, static_cast<uint32_t>(binary.size()), key };
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(binary.data(), binary.size());
+	}
+
+	uint64_t ProgramBinaryCache::hash(const std::string& data, uint64_t seed)
+	{
+		uint64_t value = seed;
+
+		for (unsigned char c : data)
+		{
+			value ^= c;
+			value *= FNV_PRIME;
+		}
+
+		return value;
+	}
+
+	std::string ProgramBinaryCache::getEntryPath(uint64_t key) const
+	{
+		std::stringstream path;
+		path << mDirectory << "/" << std::hex << std::setw(16) << std::setfill('0') << key << ".bin";
+
+		return path.str();
+	}
+}
@@ -8,7 +8,7 @@
 
 namespace vfx
 {
-	Shader::Shader(GLenum type, const std::string& source, const std::string& shaderFile)
+	Shader::Shader(GLenum type, const std::string& source, const std::string& shaderFile, bool deferStatusCheck)
 		: mFileName(shaderFile)
 		, mSource(source)
 		, mType(type)
@@ -28,6 +28,23 @@ namespace vfx
 		GL_CHECK(glShaderSource(mObjectID, 1, &pSource, nullptr));
 		GL_CHECK(glCompileShader(mObjectID));
 
+		if (!deferStatusCheck)
+			checkCompileStatus();
+	}
+
+	bool Shader::isCompileComplete() const
+	{
+		if (!HasParallelShaderCompile())
+			return true;
+
+		GLint complete = GL_TRUE;
+		GL_CHECK(glGetShaderiv(mObjectID, GL_COMPLETION_STATUS_ARB, &complete));
+
+		return complete == GL_TRUE;
+	}
+
+	void Shader::checkCompileStatus() const
+	{
 		GLint status;
 		glGetShaderiv(mObjectID, GL_COMPILE_STATUS, &status);
 		if (!status)
@@ -45,7 +62,7 @@ namespace vfx
 			}
 		}
 
-		LOG_DEBUG("Shader: " + shaderFile + " - compiled successfully");
+		LOG_DEBUG("Shader: " + mFileName + " - compiled successfully");
 	}
 
 	Shader::~Shader()
@@ -0,0 +1,113 @@
+#include "ShaderPreprocessor.h"
+#include "FileUtils.h"
+#include "Logger.h"
+
+#include <sstream>
+#include <stdexcept>
+
+namespace vfx
+{
+	namespace
+	{
+		const unsigned int MAX_INCLUDE_DEPTH = 16;
+		const std::string UTF8_BOM = "\xEF\xBB\xBF";
+
+		std::string stripBom(const std::string& source)
+		{
+			return (source.compare(0, UTF8_BOM.size(), UTF8_BOM) == 0) ? source.substr(UTF8_BOM.size()) : source;
+		}
+
+		/// \brief	Returns included file name if line is #include "file" directive.
+		bool parseInclude(const std::string& line, std::string& file)
+		{
+			auto directive = line.find_first_not_of(" \t");
+			if (directive == std::string::npos || line.compare(directive, 8, "#include") != 0)
+				return false;
+
+			auto begin = line.find('"', directive);
+			auto end = (begin == std::string::npos) ? std::string::npos : line.find('"', begin + 1);
+
+			if (end == std::string::npos)
+				throw std::runtime_error("Malformed include directive: " + line);
+
+			file = line.substr(begin + 1, end - begin - 1);
+			return true;
+		}
+	}
+
+	ShaderPreprocessor::ShaderPreprocessor(const std::string& includeFolder)
+		: mIncludeFolder(includeFolder)
+	{
+	}
+
+	std::string ShaderPreprocessor::process(const std::string& source, const ShaderDefines& defines) const
+	{
+		std::set<std::string> included;
+		auto resolved = resolveIncludes(stripBom(source), included, 0);
+
+		std::stringstream defineBlock;
+		for (const auto& define : defines)
+			defineBlock << "#define " << define.first << " " << define.second << "\n";
+
+		// Definitions must follow #version, which has to be first directive
+		auto version = resolved.find("#version");
+		if (version == std::string::npos)
+			return defineBlock.str() + resolved;
+
+		auto lineEnd = resolved.find('\n', version);
+		if (lineEnd == std::string::npos)
+			return resolved + "\n" + defineBlock.str();
+
+		// Line following #version keeps its number
+		unsigned int versionLine = 1;
+		for (size_t i = 0; i < version; ++i)
+			if (resolved[i] == '\n') ++versionLine;
+
+		return resolved.substr(0, lineEnd + 1) + defineBlock.str() + "#line " + std::to_string(versionLine + 1) + "\n" + resolved.substr(lineEnd + 1);
+	}
+
+	std::string ShaderPreprocessor::serialize(const ShaderDefines& defines)
+	{
+		std::string result;
+		for (const auto& define : defines)
+			result += "|" + define.first + "=" + define.second;
+
+		return result;
+	}
+
+	std::string ShaderPreprocessor::resolveIncludes(const std::string& source, std::set<std::string>& included, unsigned int depth) const
+	{
+		if (depth > MAX_INCLUDE_DEPTH)
+			throw std::runtime_error("Shader include depth exceeded, recursive include?");
+
+		std::stringstream input(source);
+		std::stringstream output;
+		std::string line;
+		unsigned int lineNumber = 0;
+
+		while (std::getline(input, line))
+		{
+			++lineNumber;
+
+			std::string file;
+			if (!parseInclude(line, file))
+			{
+				output << line << "\n";
+				continue;
+			}
+
+			if (included.insert(file).second)
+			{
+				auto content = file::read(mIncludeFolder + "/" + file, std::ios::ate | std::ios::in);
+				if (content.empty())
+					LOG_WARNING("ShaderPreprocessor - Empty or missing include: " + file);
+
+				output << "#line 1\n" << resolveIncludes(stripBom(content), included, depth + 1);
+			}
+
+			output << "#line " << lineNumber + 1 << "\n";
+		}
+
+		return output.str();
+	}
+}
@@ -0,0 +1,88 @@
+#include "StateCache.h"
+
+namespace vfx
+{
+	StateCache& StateCache::getInstance()
+	{
+		thread_local StateCache cache;
+		return cache;
+	}
+
+	void StateCache::useProgram(GLuint program)
+	{
+		if (update(mProgram, program))
+			GL_CHECK(glUseProgram(program));
+	}
+
+	void StateCache::bindTexture(GLuint unit, GLuint texture)
+	{
+		auto& binding = mTextures[unit];
+
+		if (update(binding, texture))
+			GL_CHECK(glBindTextureUnit(unit, texture));
+	}
+
+	void StateCache::bindImageTexture(GLuint unit, GLuint texture, GLint level, GLboolean layered, GLint layer, GLenum access, GLenum format)
+	{
+		auto& binding = mImages[unit];
+
+		if (update(binding, std::make_tuple(texture, level, layered, layer, access, format)))
+			GL_CHECK(glBindImageTexture(unit, texture, level, layered, layer, access, format));
+	}
+
+	void StateCache::bindBufferBase(GLenum target, GLuint index, GLuint buffer)
+	{
+		auto& binding = mBuffers[std::make_pair(target, index)];
+
+		if (update(binding, buffer))
+			GL_CHECK(glBindBufferBase(target, index, buffer));
+	}
+
+	void StateCache::bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+	{
+		mBuffers.erase(std::make_pair(target, index));
+		++mStatistics.issued;
+
+		GL_CHECK(glBindBufferRange(target, index, buffer, offset, size));
+	}
+
+	void StateCache::deleteTextures(GLsizei count, const GLuint* textures)
+	{
+		for (GLsizei i = 0; i < count; ++i)
+		{
+			for (auto& binding : mTextures)
+				if (binding.second.value == textures[i]) binding.second.valid = false;
+
+			for (auto& binding : mImages)
+				if (std::get<0>(binding.second.value) == textures[i]) binding.second.valid = false;
+		}
+
+		GL_CHECK(glDeleteTextures(count, textures));
+	}
+
+	void StateCache::deleteBuffers(GLsizei count, const GLuint* buffers)
+	{
+		for (GLsizei i = 0; i < count; ++i)
+		{
+			for (auto& binding : mBuffers)
+				if (binding.second.value == buffers[i]) binding.second.valid = false;
+		}
+
+		GL_CHECK(glDeleteBuffers(count, buffers));
+	}
+
+	void StateCache::deleteProgram(GLuint program)
+	{
+		if (mProgram.value == program) mProgram.valid = false;
+
+		GL_CHECK(glDeleteProgram(program));
+	}
+
+	void StateCache::invalidate()
+	{
+		mProgram.valid = false;
+		mTextures.clear();
+		mImages.clear();
+		mBuffers.clear();
+	}
+}
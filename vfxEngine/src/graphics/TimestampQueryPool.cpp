@@ -0,0 +1,126 @@
+#include "TimestampQueryPool.h"
+
+namespace vfx
+{
+	TimestampQueryPool::TimestampQueryPool(unsigned int latency, unsigned int scopesPerFrame)
+		: mScopesPerFrame(scopesPerFrame)
+		, mCurrentFrame(0)
+		, mDepth(0)
+		, mDroppedFrames(0)
+		, mFrameIndex(0)
+		, mResultsFrame(0)
+		, mHasNewResults(false)
+	{
+		// Each scope writes begin and end timestamp
+		mQueries.resize(latency * scopesPerFrame * 2);
+		GL_CHECK(glGenQueries(static_cast<GLsizei>(mQueries.size()), mQueries.data()));
+
+		mFrames.resize(latency);
+		for (unsigned int i = 0; i < latency; ++i)
+		{
+			mFrames[i].firstQuery = i * scopesPerFrame * 2;
+			mFrames[i].usedQueries = 0;
+			mFrames[i].lastQuery = 0;
+			mFrames[i].index = 0;
+			mFrames[i].scopes.reserve(scopesPerFrame);
+		}
+	}
+
+	TimestampQueryPool::~TimestampQueryPool()
+	{
+		glDeleteQueries(static_cast<GLsizei>(mQueries.size()), mQueries.data());
+	}
+
+	int TimestampQueryPool::beginScope(const std::string& name)
+	{
+		auto& frame = mFrames[mCurrentFrame];
+
+		// Ignored scope still counts for nesting, endScope of its handle balances it
+		if (frame.scopes.size() >= mScopesPerFrame)
+		{
+			++mDepth;
+			return -1;
+		}
+
+		Scope scope;
+		scope.name = name;
+		scope.depth = mDepth++;
+		scope.begin = frame.firstQuery + frame.usedQueries++;
+		scope.end = frame.firstQuery + frame.usedQueries++;
+		scope.closed = false;
+
+		GL_CHECK(glQueryCounter(mQueries[scope.begin], GL_TIMESTAMP));
+		frame.lastQuery = scope.begin;
+		frame.scopes.push_back(scope);
+
+		// Handle identifies slot as well, scope may outlive frame
+		return static_cast<int>(mCurrentFrame * mScopesPerFrame + frame.scopes.size() - 1);
+	}
+
+	void TimestampQueryPool::endScope(int scope)
+	{
+		// Scope begun in earlier frame, nesting has been reset since
+		if (scope >= 0 && static_cast<unsigned int>(scope) / mScopesPerFrame != mCurrentFrame) return;
+
+		if (mDepth > 0) --mDepth;
+		if (scope < 0) return;
+
+		auto& frame = mFrames[mCurrentFrame];
+		auto& record = frame.scopes[scope % mScopesPerFrame];
+		GL_CHECK(glQueryCounter(mQueries[record.end], GL_TIMESTAMP));
+		frame.lastQuery = record.end;
+		record.closed = true;
+	}
+
+	bool TimestampQueryPool::nextFrame()
+	{
+		mCurrentFrame = (mCurrentFrame + 1) % mFrames.size();
+		mDepth = 0;
+
+		// Oldest slot is reused, its results are read first
+		auto& frame = mFrames[mCurrentFrame];
+
+		bool read = false;
+		if (!frame.scopes.empty() && !(read = readResults(frame)))
+			++mDroppedFrames;
+
+		if (read)
+			mResultsFrame = frame.index;
+
+		frame.scopes.clear();
+		frame.usedQueries = 0;
+		frame.index = ++mFrameIndex;
+
+		mHasNewResults = read;
+		return read;
+	}
+
+	bool TimestampQueryPool::readResults(const Frame& frame)
+	{
+		// Timestamps complete in order, last one being available implies all are
+		GLint available = GL_FALSE;
+		GL_CHECK(glGetQueryObjectiv(mQueries[frame.lastQuery], GL_QUERY_RESULT_AVAILABLE, &available));
+		if (!available) return false;
+
+		mResults.clear();
+
+		for (const auto& scope : frame.scopes)
+		{
+			if (!scope.closed) continue;
+
+			GLuint64 begin = 0, end = 0;
+			GL_CHECK(glGetQueryObjectui64v(mQueries[scope.begin], GL_QUERY_RESULT, &begin));
+			GL_CHECK(glGetQueryObjectui64v(mQueries[scope.end], GL_QUERY_RESULT, &end));
+
+			Result result;
+			result.name = scope.name;
+			result.depth = scope.depth;
+			result.milliseconds = (end - begin) * 1e-6;
+			result.begin = begin;
+			result.end = end;
+			mResults.push_back(result);
+		}
+
+		return true;
+	}
+}
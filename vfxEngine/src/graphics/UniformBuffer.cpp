@@ -0,0 +1,82 @@
+#include "UniformBuffer.h"
+#include "StateCache.h"
+
+#include <cassert>
+#include <cstring>
+
+namespace vfx
+{
+	UniformBuffer::UniformBuffer(GLsizeiptr frameCapacity, unsigned int frames)
+		: mFrameCapacity(frameCapacity)
+		, mOffset(0)
+		, mAlignment(256)
+		, mFrame(0)
+		, mFences(frames, nullptr)
+	{
+		assert(frames > 0);
+
+		GL_CHECK(glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &mAlignment));
+
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+		GL_CHECK(glCreateBuffers(1, &mObjectID));
+		GL_CHECK(glNamedBufferStorage(mObjectID, mFrameCapacity * frames, nullptr, flags));
+		GL_CHECK(mMappedData = static_cast<unsigned char*>(glMapNamedBufferRange(mObjectID, 0, mFrameCapacity * frames, flags)));
+
+		LOG_INFO("UniformBuffer - Created ring buffer of " + std::to_string(frames) + " regions, " + std::to_string(mFrameCapacity) + " bytes each");
+	}
+
+	UniformBuffer::~UniformBuffer()
+	{
+		for (auto fence : mFences)
+		{
+			if (fence) GL_CHECK(glDeleteSync(fence));
+		}
+
+		GL_CHECK(glUnmapNamedBuffer(mObjectID));
+		StateCache::getInstance().deleteBuffers(1, &mObjectID);
+	}
+
+	void UniformBuffer::upload(GLuint binding, const void* data, GLsizeiptr size)
+	{
+		assert(size <= mFrameCapacity);
+
+		GLsizeiptr offset = (mOffset + mAlignment - 1) / mAlignment * mAlignment;
+
+		// Region of current frame is exhausted, continue in the next one
+		if (offset + size > mFrameCapacity)
+		{
+			LOG_WARNING("UniformBuffer - Frame region exhausted, consider larger capacity");
+			nextFrame();
+			offset = 0;
+		}
+
+		GLsizeiptr address = mFrame * mFrameCapacity + offset;
+		std::memcpy(mMappedData + address, data, size);
+
+		StateCache::getInstance().bindBufferRange(GL_UNIFORM_BUFFER, binding, mObjectID, address, size);
+
+		mOffset = offset + size;
+	}
+
+	void UniformBuffer::nextFrame()
+	{
+		GL_CHECK(mFences[mFrame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+
+		mFrame = (mFrame + 1) % mFences.size();
+		mOffset = 0;
+
+		// Wait until GPU has finished reading region written frames in flight ago
+		if (GLsync fence = mFences[mFrame])
+		{
+			GLenum status;
+			GL_CHECK(status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000));
+
+			if (status == GL_TIMEOUT_EXPIRED || status == GL_WAIT_FAILED)
+				LOG_WARNING("UniformBuffer - Waiting for frame region failed");
+
+			GL_CHECK(glDeleteSync(fence));
+			mFences[mFrame] = nullptr;
+		}
+	}
+}
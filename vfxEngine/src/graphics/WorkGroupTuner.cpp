@@ -0,0 +1,327 @@
+#include "WorkGroupTuner.h"
+#include "Logger.h"
+
+#include <fstream>
+
+#include "document.h"
+#include "istreamwrapper.h"
+#include "ostreamwrapper.h"
+#include "prettywriter.h"
+
+namespace vfx
+{
+	namespace
+	{
+		const unsigned int WARMUP_SAMPLES = 1;			//!< Dispatches ignored after candidate switch.
+		const unsigned int CANDIDATE_SAMPLES = 16;		//!< Dispatches measured per candidate.
+		const unsigned int MAX_IDLE_FRAMES = 120;		//!< Frames without dispatch after which stage tuning is abandoned.
+
+		std::string getString(GLenum name)
+		{
+			auto value = reinterpret_cast<const char*>(glGetString(name));
+			return value ? value : "";
+		}
+
+		std::string toString(const glm::uvec3& size)
+		{
+			return std::to_string(size.x) + "x" + std::to_string(size.y) + "x" + std::to_string(size.z);
+		}
+	}
+
+	WorkGroupTuner::WorkGroupTuner(const std::string& file)
+		: mFile(file)
+	{
+		mDevice = getString(GL_VENDOR) + "|" + getString(GL_RENDERER) + "|" + getString(GL_VERSION);
+
+		GLint maxSize[3] = { 0, 0, 0 };
+		GLint maxInvocations = 0;
+
+		for (GLuint i = 0; i < 3; ++i)
+			GL_CHECK(glGetIntegeri_v(GL_MAX_COMPUTE_WORK_GROUP_SIZE, i, &maxSize[i]));
+
+		GL_CHECK(glGetIntegerv(GL_MAX_COMPUTE_WORK_GROUP_INVOCATIONS, &maxInvocations));
+
+		mMaxSize = glm::uvec3(maxSize[0], maxSize[1], maxSize[2]);
+		mMaxInvocations = static_cast<unsigned int>(maxInvocations);
+
+		load();
+	}
+
+	WorkGroupTuner::~WorkGroupTuner()
+	{
+		for (auto& measurement : mMeasurements)
+			glDeleteQueries(2, measurement.queries);
+	}
+
+	const std::vector<glm::uvec3>& WorkGroupTuner::getCandidates()
+	{
+		// All within minimum limits guaranteed by GL 4.3 (1024 invocations, 64 in z)
+		static const std::vector<glm::uvec3> candidates =
+		{
+			glm::uvec3(4, 4, 4),
+			glm::uvec3(8, 8, 4),
+			glm::uvec3(8, 8, 8),
+			glm::uvec3(16, 8, 2),
+			glm::uvec3(16, 16, 1),
+			glm::uvec3(32, 4, 1),
+		};
+
+		return candidates;
+	}
+
+	void WorkGroupTuner::start()
+	{
+		// Stages are reset on first dispatch, stages not dispatched keep cached size
+		++mGeneration;
+		mIsTuning = true;
+		mTuneAll = true;
+		LOG_INFO("WorkGroupTuner - Tuning started");
+	}
+
+	glm::uvec3 WorkGroupTuner::getWorkGroupSize(const std::string& stage)
+	{
+		auto it = mStages.find(stage);
+
+		if (it == mStages.end())
+			it = mStages.emplace(stage, Stage()).first;
+
+		if (mIsTuning && mTuneAll && it->second.generation != mGeneration)
+		{
+			it->second = Stage();
+			it->second.tuned = false;
+			it->second.generation = mGeneration;
+		}
+
+		if (it->second.tuned)
+			return it->second.size;
+
+		return getCandidates()[it->second.candidate];
+	}
+
+	std::string WorkGroupTuner::getStageKey(const std::string& pipelineName, const glm::uvec3& gridSize)
+	{
+		return pipelineName + "@" + toString(gridSize);
+	}
+
+	void WorkGroupTuner::beginMeasurement(const std::string& stage)
+	{
+		if (!mIsTuning) return;
+
+		auto it = mStages.find(stage);
+		if (it == mStages.end() || it->second.tuned) return;
+
+		Measurement measurement;
+		measurement.stage = stage;
+		measurement.candidate = it->second.candidate;
+
+		GL_CHECK(glGenQueries(2, measurement.queries));
+		GL_CHECK(glQueryCounter(measurement.queries[0], GL_TIMESTAMP));
+
+		it->second.idleFrames = 0;
+		mMeasurements.push_back(measurement);
+		mIsMeasuring = true;
+	}
+
+	void WorkGroupTuner::endMeasurement()
+	{
+		if (!mIsMeasuring) return;
+
+		GL_CHECK(glQueryCounter(mMeasurements.back().queries[1], GL_TIMESTAMP));
+		mIsMeasuring = false;
+	}
+
+	void WorkGroupTuner::update()
+	{
+		if (!mIsTuning) return;
+
+		// Results become available in submission order
+		size_t collected = 0;
+		for (; collected < mMeasurements.size(); ++collected)
+		{
+			auto& measurement = mMeasurements[collected];
+
+			GLint available = GL_FALSE;
+			GL_CHECK(glGetQueryObjectiv(measurement.queries[1], GL_QUERY_RESULT_AVAILABLE, &available));
+			if (!available) break;
+
+			GLuint64 begin = 0, end = 0;
+			GL_CHECK(glGetQueryObjectui64v(measurement.queries[0], GL_QUERY_RESULT, &begin));
+			GL_CHECK(glGetQueryObjectui64v(measurement.queries[1], GL_QUERY_RESULT, &end));
+			GL_CHECK(glDeleteQueries(2, measurement.queries));
+
+			auto& stage = mStages[measurement.stage];
+			if (stage.tuned || measurement.candidate != stage.candidate) continue;
+
+			if (stage.samples.empty())
+			{
+				stage.time.assign(getCandidates().size(), 0.0);
+				stage.samples.assign(getCandidates().size(), 0);
+			}
+
+			auto& samples = stage.samples[stage.candidate];
+			if (samples++ >= WARMUP_SAMPLES)
+				stage.time[stage.candidate] += (end - begin) * 1e-6;
+
+			if (samples >= WARMUP_SAMPLES + CANDIDATE_SAMPLES && ++stage.candidate == getCandidates().size())
+				finishStage(measurement.stage, stage);
+		}
+
+		mMeasurements.erase(mMeasurements.begin(), mMeasurements.begin() + collected);
+
+		bool dispatched = false;
+		bool finished = true;
+
+		for (auto& stage : mStages)
+		{
+			if (stage.second.generation != mGeneration) continue;
+			dispatched = true;
+
+			if (stage.second.tuned) continue;
+
+			// Stage disabled during tuning (e.g. feature turned off)
+			if (++stage.second.idleFrames > MAX_IDLE_FRAMES)
+			{
+				stage.second.tuned = true;
+				LOG_WARNING("WorkGroupTuner - " + stage.first + " is not dispatched anymore, using default size");
+				continue;
+			}
+
+			finished = false;
+		}
+
+		if (!dispatched || !finished) return;
+
+		mIsTuning = false;
+		mTuneAll = false;
+		save();
+
+		LOG_INFO("WorkGroupTuner - Tuning finished, results stored in " + mFile);
+	}
+
+	void WorkGroupTuner::finishStage(const std::string& key, Stage& stage)
+	{
+		size_t best = 0;
+		for (size_t i = 1; i < stage.time.size(); ++i)
+			if (stage.time[i] < stage.time[best]) best = i;
+
+		stage.size = getCandidates()[best];
+		stage.tuned = true;
+
+		LOG_INFO("WorkGroupTuner - " + key + ": " + toString(stage.size) + ", " + std::to_string(stage.time[best] / CANDIDATE_SAMPLES) + " ms");
+	}
+
+	void WorkGroupTuner::load()
+	{
+		std::ifstream ifs(mFile, std::ios::in);
+		if (!ifs.is_open()) return;
+
+		rapidjson::Document document;
+		rapidjson::IStreamWrapper isw(ifs);
+		document.ParseStream(isw);
+
+		if (document.HasParseError() || !document.IsObject())
+		{
+			LOG_WARNING("WorkGroupTuner - Invalid cache file: " + mFile);
+			return;
+		}
+
+		size_t rejected = 0;
+
+		for (auto& device : document.GetObject())
+		{
+			if (!device.value.IsObject()) continue;
+
+			bool isCurrent = mDevice == device.name.GetString();
+
+			for (auto& entry : device.value.GetObject())
+			{
+				const auto& value = entry.value;
+				bool isValid = value.IsArray() && value.Size() == 3 && value[0].IsUint() && value[1].IsUint() && value[2].IsUint();
+
+				glm::uvec3 size(0);
+				if (isValid)
+					size = glm::uvec3(value[0].GetUint(), value[1].GetUint(), value[2].GetUint());
+
+				// Limits of other devices are unknown, their entries are only kept for save
+				if (!isCurrent)
+				{
+					if (isValid && size.x > 0 && size.y > 0 && size.z > 0)
+						mOtherDevices[device.name.GetString()][entry.name.GetString()] = size;
+
+					continue;
+				}
+
+				auto& stage = mStages[entry.name.GetString()];
+
+				if (isValid && isSupported(size))
+				{
+					stage.size = size;
+					continue;
+				}
+
+				// Stage is tuned again from its next dispatch, other stages keep cached sizes
+				stage.tuned = false;
+				stage.generation = mGeneration + 1;
+				++rejected;
+
+				LOG_WARNING("WorkGroupTuner - Rejected cached work group size of " + std::string(entry.name.GetString()) + ", stage is tuned again");
+			}
+		}
+
+		if (rejected > 0)
+		{
+			++mGeneration;
+			mIsTuning = true;
+		}
+	}
+
+	bool WorkGroupTuner::isSupported(const glm::uvec3& size) const
+	{
+		if (size.x == 0 || size.y == 0 || size.z == 0) return false;
+		if (glm::any(glm::greaterThan(size, mMaxSize))) return false;
+
+		return static_cast<uint64_t>(size.x) * size.y * size.z <= mMaxInvocations;
+	}
+
+	void WorkGroupTuner::save() const
+	{
+		std::ofstream ofs(mFile, std::ios::out | std::ios::trunc);
+		if (!ofs.is_open())
+		{
+			LOG_WARNING("WorkGroupTuner - Failed to write cache file: " + mFile);
+			return;
+		}
+
+		rapidjson::OStreamWrapper osw(ofs);
+		rapidjson::PrettyWriter<rapidjson::OStreamWrapper> writer(osw);
+
+		auto writeSize = [&writer](const std::string& key, const glm::uvec3& size)
+		{
+			writer.Key(key.c_str());
+			writer.StartArray();
+			writer.Uint(size.x);
+			writer.Uint(size.y);
+			writer.Uint(size.z);
+			writer.EndArray();
+		};
+
+		writer.StartObject();
+
+		for (auto& device : mOtherDevices)
+		{
+			writer.Key(device.first.c_str());
+			writer.StartObject();
+			for (auto& entry : device.second)
+				writeSize(entry.first, entry.second);
+			writer.EndObject();
+		}
+
+		writer.Key(mDevice.c_str());
+		writer.StartObject();
+		for (auto& stage : mStages)
+			writeSize(stage.first, stage.second.size);
+		writer.EndObject();
+
+		writer.EndObject();
+	}
+}
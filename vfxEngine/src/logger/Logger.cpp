@@ -7,6 +7,7 @@
 
 #ifdef _WIN32
 #include <Windows.h>
+#endif
 
 namespace detail
 {
@@ -62,10 +63,20 @@ namespace detail
 
 // the filename with extension but no path
 constexpr auto filename = detail::strip_path(__FILE__);
-constexpr auto basename = detail::basename_impl(filename, detail::last_dot_of(filename));
+constexpr auto fileBasename = detail::basename_impl(filename, detail::last_dot_of(filename));
 
 namespace vfx
 {
+	static void setConsoleColor(ConsoleColors color)
+	{
+#ifdef _WIN32
+		SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), static_cast<WORD>(color));
+#else
+		// Colors are console attributes of Windows, other terminals print plain text
+		(void)color;
+#endif
+	}
+
 	Logger::~Logger()
 	{
 	}
@@ -79,12 +90,17 @@ namespace vfx
 	bool Logger::shutDown()
 	{
 		Log("Shutting down logger", LOGTYPE_INFO);
+
+		std::lock_guard<std::mutex> lock(mMutex);
 		mLogs.clear();
 		return false;
 	}
 
 	void Logger::Log(const std::string& msg, LogType type, unsigned int lineNumber, const std::string& fileName)
 	{
+		// Console color, history and output stay consistent per message
+		std::lock_guard<std::mutex> lock(mMutex);
+
 		std::stringstream buffer;
 
 		buffer << filename << ": ";
@@ -94,39 +110,32 @@ namespace vfx
 		switch (type)
 		{
 		case LogType::Info:
-			SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE),
-				static_cast<WORD>(ConsoleColors::White));
+			setConsoleColor(ConsoleColors::White);
 			buffer << "[INFO] ";
 			break;
 		case LogType::Debug:
-			SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE),
-				static_cast<WORD>(ConsoleColors::Yellow));
+			setConsoleColor(ConsoleColors::Yellow);
 			buffer << "[DEBUG] ";
 			break;
 		case LogType::ValidationLayer:
-			SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE),
-				static_cast<WORD>(ConsoleColors::Lightred));
+			setConsoleColor(ConsoleColors::Lightred);
 			buffer << "[VALIDATION_LAYER] ";
 			break;
 		case LogType::Error:
-			SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE),
-				static_cast<WORD>(ConsoleColors::Lightred));
+			setConsoleColor(ConsoleColors::Lightred);
 			buffer << "[ERROR] ";
 			break;
 		case LogType::Critical:
-			SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE),
-				static_cast<WORD>(ConsoleColors::Red));
+			setConsoleColor(ConsoleColors::Red);
 			buffer << "[CRITICAL] ";
 			break;
 		case LogType::Warning:
-			SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE),
-				static_cast<WORD>(ConsoleColors::Lightred));
+			setConsoleColor(ConsoleColors::Lightred);
 			buffer << "[WARNING] ";
 			break;
 
 		default:
-			SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE),
-				static_cast<WORD>(ConsoleColors::White));
+			setConsoleColor(ConsoleColors::White);
 		}
 
 		buffer << msg << "\n";
@@ -135,8 +144,7 @@ namespace vfx
 		std::cout << buffer.str();
 		buffer.clear();
 
-		SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE),
-			static_cast<WORD>(ConsoleColors::White));
+		setConsoleColor(ConsoleColors::White);
 	}
 
 	std::string Logger::getTime() const
@@ -147,5 +155,4 @@ namespace vfx
 		timeStr << std::put_time(std::localtime(&timeNow), "%y-%m-%d %OH:%OM:%OS");
 		return timeStr.str();
 	}
-}
-#endif
\ No newline at end of file
+}
\ No newline at end of file
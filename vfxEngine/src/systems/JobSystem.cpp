@@ -0,0 +1,170 @@
+#include "JobSystem.h"
+
+#include "Tracer.h"
+#include "Logger.h"
+#include "glm/glm.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <string>
+#include <thread>
+
+namespace vfx { namespace system
+{
+	TaskGraph::TaskId TaskGraph::add(const char* name, const std::function<void()>& function)
+	{
+		mTasks.emplace_back();
+		mTasks.back().name = name;
+		mTasks.back().function = function;
+
+		return mTasks.size() - 1;
+	}
+
+	void TaskGraph::addDependency(TaskId before, TaskId after)
+	{
+		assert(before < mTasks.size() && after < mTasks.size() && before != after);
+
+		mTasks[before].successors.push_back(after);
+		++mTasks[after].dependencies;
+	}
+
+	JobSystem::JobSystem()
+		: mScheduler([this](Job& job, unsigned int) { execute(job); })
+	{
+	}
+
+	JobSystem::~JobSystem()
+	{
+		mScheduler.stop();
+	}
+
+	void JobSystem::initialize()
+	{
+		if (mScheduler.isRunning())
+			return;
+
+		const unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+
+		mScheduler.start(threads, [](unsigned int queue)
+		{
+			Tracer::getInstance().setThreadName("Worker " + std::to_string(queue));
+		});
+
+		LOG_INFO("Initialized job system with " + std::to_string(mScheduler.getWorkerCount()) + " workers");
+	}
+
+	void JobSystem::shutdown()
+	{
+		mScheduler.stop();
+		LOG_INFO("Shutting down job system");
+	}
+
+	void JobSystem::run(const JobFunction& job, JobCounter& counter, const char* name)
+	{
+		counter.mValue.fetch_add(1, std::memory_order_relaxed);
+		mScheduler.push({ job, &counter, name });
+	}
+
+	void JobSystem::run(TaskGraph& graph, JobCounter& counter)
+	{
+		if (graph.mTasks.empty())
+			return;
+
+		counter.mValue.fetch_add(static_cast<unsigned int>(graph.mTasks.size()), std::memory_order_relaxed);
+
+		// All dependencies are reset before first task may finish
+		for (auto& task : graph.mTasks)
+			task.pending.store(task.dependencies, std::memory_order_relaxed);
+
+		bool scheduled = false;
+
+		for (TaskGraph::TaskId id = 0; id < graph.mTasks.size(); ++id)
+		{
+			if (graph.mTasks[id].dependencies == 0)
+			{
+				scheduleTask(graph, id, counter);
+				scheduled = true;
+			}
+		}
+
+		assert(scheduled && "Task graph has to be acyclic");
+	}
+
+	void JobSystem::wait(const JobCounter& counter)
+	{
+		mScheduler.wait([&counter]() { return counter.isDone(); });
+	}
+
+	void JobSystem::parallelFor(const Range3D& range, const glm::uvec3& grain, const RangeFunction& function)
+	{
+		if (range.isEmpty())
+			return;
+
+		JobCounter counter;
+		split(range, glm::max(grain, glm::uvec3(1)), function, counter);
+		wait(counter);
+	}
+
+	void JobSystem::execute(Job& job)
+	{
+		{
+			TraceZone zone(job.name);
+			job.function();
+		}
+
+		// Waiting thread may return and release counter once it reaches zero
+		if (job.counter->mValue.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			mScheduler.notify();
+	}
+
+	void JobSystem::scheduleTask(TaskGraph& graph, TaskGraph::TaskId task, JobCounter& counter)
+	{
+		// Counter already counts tasks of graph
+		mScheduler.push({ [this, &graph, task, &counter]() { runTask(graph, task, counter); }, &counter, graph.mTasks[task].name });
+	}
+
+	void JobSystem::runTask(TaskGraph& graph, TaskGraph::TaskId task, JobCounter& counter)
+	{
+		graph.mTasks[task].function();
+
+		for (TaskGraph::TaskId successor : graph.mTasks[task].successors)
+		{
+			if (graph.mTasks[successor].pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				scheduleTask(graph, successor, counter);
+		}
+	}
+
+	void JobSystem::split(Range3D range, const glm::uvec3& grain, const RangeFunction& function, JobCounter& counter)
+	{
+		while (true)
+		{
+			const glm::uvec3 size = range.getSize();
+
+			// Axis spanning most grains is halved, so subranges stay close to shape of grain
+			int axis = -1;
+			unsigned int grains = 1;
+
+			for (int i = 0; i < 3; ++i)
+			{
+				unsigned int count = (size[i] + grain[i] - 1) / grain[i];
+				if (count > grains)
+				{
+					grains = count;
+					axis = i;
+				}
+			}
+
+			if (axis < 0)
+				break;
+
+			Range3D upper = range;
+			upper.begin[axis] = range.begin[axis] + size[axis] / 2;
+			range.end[axis] = upper.begin[axis];
+
+			run([this, upper, grain, &function, &counter]() { split(upper, grain, function, counter); }, counter, "parallel for");
+		}
+
+		function(range);
+	}
+
+} }
@@ -5,8 +5,17 @@
 #include "Shader.h"
 #include "FileUtils.h"
 #include "Pipeline.h"
+#include "UniformBuffer.h"
+#include "ProgramBinaryCache.h"
+#include "ShaderPreprocessor.h"
+#include "WorkGroupTuner.h"
+#include "TimestampQueryPool.h"
+#include "Tracer.h"
+#include "Window.h"
 #include "Logger.h"
 
+#include "GLFW/glfw3.h"
+
 #include <algorithm>
 #include <memory>
 
@@ -15,6 +24,39 @@
 
 namespace vfx { namespace system
 {
+	namespace
+	{
+		// GLEW exposes only ARB entry point of parallel shader compile
+		typedef void (GLAPIENTRY* MaxShaderCompilerThreadsFunction)(GLuint count);
+
+		/// \brief Lets driver use all compiler threads, through whichever
+		///		   of ARB and KHR extensions is supported.
+		void setMaxShaderCompilerThreads()
+		{
+			if (GLEW_ARB_parallel_shader_compile)
+			{
+				GL_CHECK(glMaxShaderCompilerThreadsARB(0xFFFFFFFF));
+				return;
+			}
+
+			auto maxShaderCompilerThreadsKHR = reinterpret_cast<MaxShaderCompilerThreadsFunction>(glfwGetProcAddress("glMaxShaderCompilerThreadsKHR"));
+
+			if (maxShaderCompilerThreadsKHR)
+				GL_CHECK(maxShaderCompilerThreadsKHR(0xFFFFFFFF));
+		}
+	}
+
+	Renderer::Renderer()
+		: mCompileWorkerDone(false)
+	{
+	}
+
+	Renderer::~Renderer()
+	{
+		if (mCompileWorker.joinable())
+			mCompileWorker.join();
+	}
+
 	std::shared_ptr<Shader> Renderer::addShaderModule(const std::string & source, const std::string & type, const std::string& shaderFile)
 	{
 		auto shaderTypeGL = convertExtToGLShaderStage(type);
@@ -68,11 +110,89 @@ namespace vfx { namespace system
 
 	void Renderer::shutdown()
 	{
+		collectCompileWorker(true);
+		mPendingPipelines.clear();
+		mVariantMap.clear();
+
+		// Programs are deleted through state cache of main thread while context is alive
+		mPipelineMap.clear();
+		mShaderMap.clear();
+
+		mWorkGroupTuner = nullptr;
+		mTimestampQueries = nullptr;
+		mUniformBuffer = nullptr;
+		mProgramCache = nullptr;
+	}
+
+	UniformBuffer& Renderer::getUniformBuffer()
+	{
+		if (!mUniformBuffer)
+			mUniformBuffer = std::make_unique<UniformBuffer>();
 
+		return *mUniformBuffer;
 	}
 
-	void Renderer::createPipelines(const std::string& shaderFolder)
+	WorkGroupTuner& Renderer::getWorkGroupTuner()
 	{
+		if (!mWorkGroupTuner)
+			mWorkGroupTuner = std::make_unique<WorkGroupTuner>();
+
+		return *mWorkGroupTuner;
+	}
+
+	TimestampQueryPool& Renderer::getTimestampQueries()
+	{
+		if (!mTimestampQueries)
+			mTimestampQueries = std::make_unique<TimestampQueryPool>();
+
+		return *mTimestampQueries;
+	}
+
+	void Renderer::endFrame()
+	{
+		TRACE_ZONE("end frame");
+
+		auto& tracer = Tracer::getInstance();
+
+		// GPU zones of new trace are mapped by offset of this trace
+		if (tracer.needsGpuCalibration())
+		{
+			GLint64 gpuTime = 0;
+			GL_CHECK(glGetInteger64v(GL_TIMESTAMP, &gpuTime));
+			tracer.calibrateGpuClock(static_cast<uint64_t>(gpuTime));
+		}
+
+		if (mTimestampQueries)
+		{
+			// Frame trace started in may have scopes preceding start, results
+			// are read latency frames later when tracer is already enabled
+			if (tracer.isEnabled() && mTraceSession != tracer.getSession())
+			{
+				mTraceSession = tracer.getSession();
+				mTraceFirstFrame = mTimestampQueries->getFrameIndex() + 1;
+			}
+
+			if (mTimestampQueries->nextFrame() && tracer.isEnabled() && mTimestampQueries->getResultsFrame() >= mTraceFirstFrame)
+			{
+				for (const auto& result : mTimestampQueries->getResults())
+					tracer.addGpuZone(result.name, result.begin, result.end);
+			}
+		}
+
+		if (mUniformBuffer)
+			mUniformBuffer->nextFrame();
+
+		if (mWorkGroupTuner)
+			mWorkGroupTuner->update();
+
+		if (!mPendingPipelines.empty())
+			updatePendingPipelines();
+	}
+
+	void Renderer::createPipelines(const std::string& shaderFolder, bool async)
+	{
+		TRACE_ZONE("create pipelines");
+
 		rapidjson::Document document;
 		std::ifstream ifs("config.json", std::ios::in);
 
@@ -87,37 +207,370 @@ namespace vfx { namespace system
 			exit(1);
 		}
 
+		if (!mProgramCache)
+			mProgramCache = std::make_unique<ProgramBinaryCache>();
+
+		mPreprocessor = std::make_unique<ShaderPreprocessor>(shaderFolder);
+
+		unsigned int cachedPipelines = 0;
+
 		for (auto& pipeline : document["pipelines"].GetObject())
 		{
 			bool enabled = false;
-			std::vector<std::string> shaderFiles;
-			std::vector<std::shared_ptr<Shader>> shaders;
+			PipelineDescription description;
 
 			for (auto& member : pipeline.value.GetObject())
 			{
 				if (member.value.IsBool())
 					enabled = member.value.GetBool();
-				else if(member.value.IsString())
-					shaderFiles.push_back(shaderFolder + "\//" + member.value.GetString());
+				else if (member.value.IsString())
+					description.shaderFiles.push_back(shaderFolder + "\//" + member.value.GetString());
+				else if (member.value.IsObject() && std::string(member.name.GetString()) == "defines")
+				{
+					for (auto& define : member.value.GetObject())
+					{
+						if (define.value.IsString())
+							description.defines[define.name.GetString()] = define.value.GetString();
+						else if (define.value.IsInt())
+							description.defines[define.name.GetString()] = std::to_string(define.value.GetInt());
+						else if (define.value.IsBool())
+							description.defines[define.name.GetString()] = define.value.GetBool() ? "1" : "0";
+					}
+				}
 			}
 				
 			if (enabled)
 			{
-				auto pipelineObject = std::make_shared<vfx::Pipeline>();
-					
-				for (auto& shaderFile : shaderFiles)
+				mPipelineDescriptions.emplace(pipeline.name.GetString(), description);
+
+				auto shaderSources = preprocessSources(description, description.defines);
+				auto key = mProgramCache->computeKey(shaderSources, ShaderPreprocessor::serialize(description.defines));
+
+				std::shared_ptr<Pipeline> pipelineObject;
+
+				if (loadCachedPipeline(key, pipelineObject))
+				{
+					++cachedPipelines;
+				}
+				else if (async)
 				{
-					auto shaderSource = file::read(shaderFile, std::ios::ate | std::ios::in);
-					auto shaderType = file::getExtention(shaderFile);
-					auto shader = addShaderModule(shaderSource, shaderType, shaderFile);
+					PendingPipeline pending;
+					pending.pipeline = std::make_shared<vfx::Pipeline>();
+					pending.shaderFiles = description.shaderFiles;
+					pending.shaderSources = shaderSources;
+					pending.key = key;
 
-					pipelineObject->AddStage(shader);
+					mPendingPipelines.emplace(pipeline.name.GetString(), pending);
+					continue;
+				}
+				else
+				{
+					pipelineObject = compilePipeline(description.shaderFiles, shaderSources, key);
 				}
 
-				pipelineObject->Create();
 				mPipelineMap.emplace(pipeline.name.GetString(), pipelineObject);
 			}
 		}
+
+		LOG_INFO("Renderer - " + std::to_string(cachedPipelines) + " of " + std::to_string(mPipelineMap.size() + mPendingPipelines.size()) + " pipelines loaded from program binary cache");
+
+		if (mPendingPipelines.empty()) return;
+
+		if (HasParallelShaderCompile())
+		{
+			// Driver compiles in background, submission returns immediately
+			setMaxShaderCompilerThreads();
+
+			submitPendingPipelines(mPendingPipelines);
+			LOG_INFO("Renderer - " + std::to_string(mPendingPipelines.size()) + " pipelines compiled in parallel by driver");
+			return;
+		}
+
+		collectCompileWorker(true);
+		mCompileContext = system::Window::getInstance().createSharedContext();
+
+		if (mCompileContext)
+		{
+			// Worker owns pipelines it compiles until it hands them back,
+			// main thread keeps only their names
+			PendingPipelineMap batch;
+
+			for (auto it = mPendingPipelines.begin(); it != mPendingPipelines.end();)
+			{
+				if (!it->second.shaders.empty())
+				{
+					++it;
+					continue;
+				}
+
+				mWorkerPipelines.insert(it->first);
+				batch.insert(std::move(*it));
+				it = mPendingPipelines.erase(it);
+			}
+
+			const size_t count = batch.size();
+
+			mCompileWorkerDone = false;
+			mCompileWorker = std::thread([this, batch = std::move(batch)]() mutable
+			{
+				Tracer::getInstance().setThreadName("Compile worker");
+				glfwMakeContextCurrent(mCompileContext);
+
+				try
+				{
+					submitPendingPipelines(batch);
+				}
+				catch (const std::exception& e)
+				{
+					LOG_ERROR("Renderer - compile worker failed: " + std::string(e.what()));
+				}
+
+				// Objects must be complete before main context uses them
+				GL_CHECK(glFinish());
+				glfwMakeContextCurrent(nullptr);
+
+				{
+					std::lock_guard<std::mutex> lock(mCompileMutex);
+					for (auto& compiled : batch)
+						mCompiledPipelines.insert(std::move(compiled));
+				}
+
+				mCompileWorkerDone = true;
+			});
+
+			LOG_INFO("Renderer - " + std::to_string(count) + " pipelines compiled on worker thread");
+		}
+		else
+		{
+			// Without shared context pipelines are compiled here and finished on first use
+			submitPendingPipelines(mPendingPipelines);
+		}
+	}
+
+	std::vector<std::string> Renderer::preprocessSources(const PipelineDescription& description, const ShaderDefines& defines) const
+	{
+		std::vector<std::string> sources;
+
+		for (auto& shaderFile : description.shaderFiles)
+			sources.push_back(mPreprocessor->process(file::read(shaderFile, std::ios::ate | std::ios::in), defines));
+
+		return sources;
+	}
+
+	bool Renderer::loadCachedPipeline(uint64_t key, std::shared_ptr<Pipeline>& pipeline) const
+	{
+		GLenum binaryFormat;
+		std::vector<char> binary;
+
+		if (!mProgramCache->load(key, binaryFormat, binary))
+			return false;
+
+		pipeline = std::make_shared<vfx::Pipeline>();
+		return pipeline->CreateFromBinary(binaryFormat, binary);
+	}
+
+	std::shared_ptr<Pipeline> Renderer::compilePipeline(const std::vector<std::string>& shaderFiles, const std::vector<std::string>& shaderSources, uint64_t key)
+	{
+		auto pipeline = std::make_shared<vfx::Pipeline>();
+
+		for (size_t i = 0; i < shaderFiles.size(); ++i)
+		{
+			auto shaderType = file::getExtention(shaderFiles[i]);
+			auto shader = addShaderModule(shaderSources[i], shaderType, shaderFiles[i]);
+
+			pipeline->AddStage(shader);
+		}
+
+		pipeline->Create();
+
+		GLenum binaryFormat;
+		std::vector<char> binary;
+
+		if (pipeline->GetBinary(binaryFormat, binary))
+			mProgramCache->store(key, binaryFormat, binary);
+
+		return pipeline;
+	}
+
+	const std::shared_ptr<Pipeline>& Renderer::getPipelineVariant(const std::string& pipelineName, const ShaderDefines& defines)
+	{
+		if (defines.empty())
+			return getPipelineByName(pipelineName);
+
+		auto variantName = pipelineName + ShaderPreprocessor::serialize(defines);
+
+		auto variant = mVariantMap.find(variantName);
+		if (variant != mVariantMap.end())
+			return variant->second;
+
+		auto description = mPipelineDescriptions.find(pipelineName);
+		if (description == mPipelineDescriptions.end())
+			throw std::runtime_error("Requested variant of invalid pipeline");
+
+		// Variant definitions override definitions of pipeline
+		auto variantDefines = defines;
+		variantDefines.insert(description->second.defines.begin(), description->second.defines.end());
+
+		TRACE_ZONE("compile pipeline variant");
+
+		auto shaderSources = preprocessSources(description->second, variantDefines);
+		auto key = mProgramCache->computeKey(shaderSources, ShaderPreprocessor::serialize(variantDefines));
+
+		std::shared_ptr<Pipeline> pipeline;
+		if (!loadCachedPipeline(key, pipeline))
+			pipeline = compilePipeline(description->second.shaderFiles, shaderSources, key);
+
+		LOG_INFO("Renderer - created pipeline variant: " + variantName);
+
+		return mVariantMap.emplace(variantName, pipeline).first->second;
+	}
+
+	const std::shared_ptr<Pipeline>& Renderer::getComputePipeline(const std::string& pipelineName, const glm::uvec3& gridSize)
+	{
+		auto size = getWorkGroupTuner().getWorkGroupSize(WorkGroupTuner::getStageKey(pipelineName, gridSize));
+
+		// Shaders default to 8x8x8, no variant is needed
+		if (size == WorkGroupTuner::getDefaultSize())
+			return getPipelineByName(pipelineName);
+
+		ShaderDefines defines;
+		defines["LOCAL_SIZE_X"] = std::to_string(size.x);
+		defines["LOCAL_SIZE_Y"] = std::to_string(size.y);
+		defines["LOCAL_SIZE_Z"] = std::to_string(size.z);
+
+		return getPipelineVariant(pipelineName, defines);
+	}
+
+	void Renderer::dispatchCompute(const std::string& pipelineName, const glm::uvec3& gridSize)
+	{
+		auto stage = WorkGroupTuner::getStageKey(pipelineName, gridSize);
+		auto& tuner = getWorkGroupTuner();
+
+		auto size = tuner.getWorkGroupSize(stage);
+		auto groups = (gridSize + size - glm::uvec3(1)) / size;
+
+		TRACE_ZONE("dispatch compute");
+
+		tuner.beginMeasurement(stage);
+		GL_CHECK(glDispatchCompute(groups.x, groups.y, groups.z));
+		tuner.endMeasurement();
+	}
+
+	void Renderer::submitPendingPipelines(PendingPipelineMap& pipelines) const
+	{
+		TRACE_ZONE("submit pipelines");
+
+		// Pipelines with shaders have been submitted by earlier call
+		std::vector<PendingPipeline*> submitted;
+
+		for (auto& pending : pipelines)
+			if (pending.second.shaders.empty()) submitted.push_back(&pending.second);
+
+		// All compilations are in flight before first link waits for them
+		for (auto* entry : submitted)
+		{
+			for (size_t i = 0; i < entry->shaderFiles.size(); ++i)
+			{
+				auto shaderType = convertExtToGLShaderStage(file::getExtention(entry->shaderFiles[i]));
+				entry->shaders.push_back(std::make_shared<Shader>(shaderType, entry->shaderSources[i], entry->shaderFiles[i], true));
+			}
+		}
+
+		for (auto* entry : submitted)
+		{
+			for (auto& shader : entry->shaders)
+				entry->pipeline->AddStage(shader);
+
+			entry->pipeline->CreateAsync();
+		}
+	}
+
+	bool Renderer::finishPipeline(const std::string& name, bool wait)
+	{
+		// Pipeline compiled by worker is pending again once worker hands it back
+		if (mWorkerPipelines.count(name) && !collectCompileWorker(wait))
+			return false;
+
+		auto found = mPendingPipelines.find(name);
+		if (found == mPendingPipelines.end()) return true;
+
+		auto& entry = found->second;
+
+		if (!wait)
+		{
+			for (auto& shader : entry.shaders)
+				if (!shader->isCompileComplete()) return false;
+
+			if (!entry.pipeline->IsLinkComplete()) return false;
+		}
+
+		for (size_t i = 0; i < entry.shaders.size(); ++i)
+		{
+			entry.shaders[i]->checkCompileStatus();
+			mShaderMap.emplace(vfx::file::getBaseNameWithoutExt(entry.shaderFiles[i]), entry.shaders[i]);
+		}
+
+		if (entry.pipeline->Finish())
+		{
+			GLenum binaryFormat;
+			std::vector<char> binary;
+
+			if (entry.pipeline->GetBinary(binaryFormat, binary))
+				mProgramCache->store(entry.key, binaryFormat, binary);
+		}
+
+		mPipelineMap.emplace(name, entry.pipeline);
+		mPendingPipelines.erase(found);
+
+		LOG_DEBUG("Renderer - pipeline ready: " + name);
+		return true;
+	}
+
+	bool Renderer::isPipelineReady(const std::string& pipelineName)
+	{
+		if (mPipelineMap.find(pipelineName) != mPipelineMap.end()) return true;
+
+		return finishPipeline(pipelineName, false) && mPipelineMap.find(pipelineName) != mPipelineMap.end();
+	}
+
+	void Renderer::updatePendingPipelines()
+	{
+		std::vector<std::string> names;
+		for (const auto& pending : mPendingPipelines)
+			names.push_back(pending.first);
+
+		for (const auto& name : names)
+			finishPipeline(name, false);
+	}
+
+	bool Renderer::collectCompileWorker(bool wait)
+	{
+		if (!mCompileWorker.joinable()) return true;
+		if (!wait && !mCompileWorkerDone) return false;
+
+		joinCompileWorker();
+
+		std::lock_guard<std::mutex> lock(mCompileMutex);
+
+		for (auto& compiled : mCompiledPipelines)
+			mPendingPipelines.insert(std::move(compiled));
+
+		mCompiledPipelines.clear();
+		mWorkerPipelines.clear();
+
+		return true;
+	}
+
+	void Renderer::joinCompileWorker()
+	{
+		if (mCompileWorker.joinable())
+			mCompileWorker.join();
+
+		if (mCompileContext)
+		{
+			system::Window::getInstance().destroySharedContext(mCompileContext);
+			mCompileContext = nullptr;
+		}
 	}
 
 	GLenum Renderer::convertExtToGLShaderStage(const std::string & extension) const
@@ -151,8 +604,11 @@ namespace vfx { namespace system
 		}
 	}
 		
-	const std::shared_ptr<Pipeline>& Renderer::getPipelineByName(const std::string & pipelineName) const
+	const std::shared_ptr<Pipeline>& Renderer::getPipelineByName(const std::string & pipelineName)
 	{
+		// Pipeline requested before its compilation finished
+		finishPipeline(pipelineName, true);
+
 		auto it = mPipelineMap.find(pipelineName);
 
 		if (it != mPipelineMap.end())
@@ -44,6 +44,24 @@ namespace vfx { namespace system
 		return glfwSwapBuffers(mWindow);
 	}
 
+	GLFWwindow* Window::createSharedContext() const
+	{
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+		GLFWwindow* context = glfwCreateWindow(1, 1, "", nullptr, mWindow);
+		glfwDefaultWindowHints();
+
+		if (!context)
+			LOG_WARNING("Failed to create shared GLFW3 context!");
+
+		return context;
+	}
+
+	void Window::destroySharedContext(GLFWwindow* context) const
+	{
+		if (context)
+			glfwDestroyWindow(context);
+	}
+
 	void Window::initialize()
 	{
 		LOG_INFO("Initializing GLFW window");
@@ -1,6 +1,13 @@
 #include "FileUtils.h"
 
 #include <vector>
+#include <cerrno>
+
+#ifdef _WIN32
+#	include <direct.h>
+#else
+#	include <sys/stat.h>
+#endif
 
 #include "Logger.h"
 
@@ -59,5 +66,15 @@ namespace vfx
 			unsigned found = file.find_last_of("/\\");
 			return file.substr(found + 1);
 		}
+
+		bool createDirectory(const std::string& directory)
+		{
+#ifdef _WIN32
+			int result = _mkdir(directory.c_str());
+#else
+			int result = mkdir(directory.c_str(), 0755);
+#endif
+			return result == 0 || errno == EEXIST;
+		}
 	}
 }
\ No newline at end of file
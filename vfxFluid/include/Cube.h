@@ -7,7 +7,7 @@ namespace vfx
 	class Cube : public Obstacle
 	{
 	public:
-		Cube(const std::shared_ptr<Image3D>& volume, const glm::vec3& workGroupSize);
+		Cube(IComputeDevice& device, const std::shared_ptr<IVolume>& volume);
 		virtual ~Cube();
 
 		void bindProperties() const override;
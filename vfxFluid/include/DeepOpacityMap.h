@@ -0,0 +1,55 @@
+#pragma once
+
+#include "glm/vec3.hpp"
+#include "GL/glew.h"
+
+namespace vfx
+{
+	class Image3D;
+
+	/// \brief	Deep opacity map shadowing technique.
+	///
+	///			Light space 2D texture array storing optical length (density * distance)
+	///			accumulated from the light at fixed number of depth layers. Covers bounding
+	///			sphere of the simulation domain, so memory grows with N^2 * layers
+	///			instead of N^3 of full lighting volume.
+	class DeepOpacityMap
+	{
+	public:
+		DeepOpacityMap(unsigned int resolution, unsigned int layers);
+		~DeepOpacityMap();
+
+		/// \brief	Marches density from the light and stores optical length of each layer.
+		///
+		/// \param density Density volume image.
+		/// \param obstacle Obstacle volume image.
+		/// \param lightPosition Position of light source in volume texture space.
+		/// \param step Marching step size.
+		/// \param jitter Jittering of ray start.
+		/// \param factor Density factor.
+		void update(const Image3D& density, const Image3D& obstacle, const glm::vec3& lightPosition, float step, float jitter, float factor);
+
+		/// \brief	Binds the map.
+		///
+		/// \param textureUnit Selected texture unit.
+		void bind(int textureUnit) const;
+
+		/// \brief	Light space basis getters.
+		const glm::vec3& getLightDirection() const { return mLightDirection; }
+		const glm::vec3& getLightTangent() const { return mLightTangent; }
+		const glm::vec3& getLightBitangent() const { return mLightBitangent; }
+
+		/// \brief	Number of depth layers getter.
+		unsigned int getLayers() const { return mLayers; }
+
+	private:
+		unsigned int mResolution;		//!< Width and height of each layer.
+		unsigned int mLayers;			//!< Number of depth layers.
+
+		glm::vec3 mLightDirection;		//!< Direction from domain center to light.
+		glm::vec3 mLightTangent;		//!< Light space horizontal axis.
+		glm::vec3 mLightBitangent;		//!< Light space vertical axis.
+
+		GLuint mObjectID;				//!< 2D texture array handle.
+	};
+}
@@ -7,6 +7,12 @@ namespace vfx
 	class DensityInjection : public IInjection
 	{
 	public:
+		/// \param device Device executing injection kernel.
+		DensityInjection(IComputeDevice& device);
+
 		void inject(Quantity* quantity, const glm::vec3& position, float deltaTime) override;
+
+	private:
+		IComputeDevice& mDevice;	//!< Device executing injection kernel.
 	};
 }
\ No newline at end of file
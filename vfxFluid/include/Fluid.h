@@ -1,8 +1,9 @@
 #pragma once
 
-#include "IAdvection.h"
 #include "SimProperties.h"
 #include "RendererProperties.h"
+#include "SimulationGraph.h"
+#include "SimulationStatistics.h"
 
 #include <vector>
 #include <memory>
@@ -17,6 +18,11 @@
 //#	define VFX_API __declspec(dllimport)  
 //#endif
 
+namespace profile
+{
+	struct TestData;
+}
+
 namespace vfx 
 {
 	namespace gfx
@@ -26,10 +32,12 @@ namespace vfx
 	}
 
 	class Image3D;
-	class Quantity;
-	class Obstacle;
+	class GLComputeDevice;
+	class FluidSimulation;
 	class Volume;
-	class IInjection;
+	class TransferFunction;
+	class DeepOpacityMap;
+	class LightDiffusion;
 
 	class Fluid
 	{
@@ -52,17 +60,55 @@ namespace vfx
 		float getDensityDecay() const;
 		float getTemperatureDecay() const;
 		
-		int getActiveObtacle() const { return mActiveObstacleIndex; }
+		int getActiveObtacle() const;
 
 		glm::vec3 getObstaclePosition() const;
-		std::vector<InjectionProperties>& getInjectionProperties() { return mInjectionProps; }
+		std::vector<InjectionProperties>& getInjectionProperties();
 
 		void changeObstacle(unsigned int idx = 0);
 		void resize(const glm::ivec3& size);
 		void render(float deltaTime, gfx::ICamera* camera);
 		void reset();
 
-		void advect(float deltaTime);
+		/// \brief Exports density and temperature volumes for offline rendering.
+		///
+		/// \param prefix Output files prefix, volumes are written to <prefix>_density.vfxv and <prefix>_temperature.vfxv.
+		/// \return True if both volumes have been written.
+		bool exportVolumes(const std::string& prefix) const;
+
+		/// \brief Measures separable and recursive blur of density volume for range of kernel sizes and logs results.
+		void benchmarkBlur() const;
+
+		/// \brief Applies features and sample counts of profiling scenario.
+		void applySettings(const profile::TestData& settings);
+
+		/// \brief Returns true once pipelines of simulation stages are linked, simulate
+		///		   skips steps until then. Never blocks.
+		bool isSimulationReady() const;
+
+		/// \brief Executes simulation step as graph of enabled stages, stages
+		///		   disabled by features are culled.
+		///
+		/// \param deltaTime Time step.
+		void simulate(float deltaTime);
+
+		/// \brief Executes simulation step with separate injection time step.
+		///
+		/// \param deltaTime Time step.
+		/// \param injectionTimeStep Time step of injection, injection is culled when not positive.
+		void simulate(float deltaTime, float injectionTimeStep);
+
+		// Simulation stages below time stages of FluidSimulation, they do not issue
+		// barriers after their last dispatch, results are ordered by simulation graph
+
+		/// \brief Advects velocity by Semi-Lagrangian advection.
+		void advectVelocity(float deltaTime);
+
+		/// \brief Advects temperature by selected advection.
+		void advectTemperature(float deltaTime);
+
+		/// \brief Advects density by selected advection.
+		void advectDensity(float deltaTime);
 
 		/// \brief Injects 
 		///
@@ -90,11 +136,18 @@ namespace vfx
 		/// \brief Project pressure to velocity and subtract gradient.
 		void projectAndSubtract();
 
+		/// \brief Reduces health counters of projected step, results are read back frames later.
+		///
+		/// \param deltaTime Time step.
+		void computeStatistics(float deltaTime);
+
+		/// \brief Latest health counters, updated while statistics feature is enabled.
+		const SimulationStatistics::Values& getStatistics() const;
 
-	private:
-		void advect(Quantity* quantity, float dissipation, float decay, float deltaTime);
 
-		
+	private:
+		/// \brief Copies stage properties edited on this instance to simulation, validates them first.
+		void applySimulationSettings();
 
 		/// \brief Computes lighting and shadows.
 		///
@@ -105,11 +158,24 @@ namespace vfx
 		/// \param lightPosition Position of light source.
 		void computeShadows(float jittering, float sampling, float absorbtion, float factor, const glm::vec3& lightPosition);
 
-		void prepareTextures();
-		void prepareDefaultQuantities();
-		void prepareObstacles();
+		/// \brief Computes per brick maximum density and gradient used by adaptive ray marching.
+		///
+		/// \param blurredDensity Use blurred density volume.
+		void computeOccupancy(bool blurredDensity);
+
+		/// \brief Obstacle texture sampled by rendering, blurred one if obstacle blur is enabled.
+		unsigned int getObstacleTextureID() const;
+
+		/// \brief Computes multiple scattered light by diffusion in downsampled volumes.
+		void computeScattering();
 
-		void updateSettings();
+		/// \brief Resolves automatic shadow technique selection by domain size.
+		ShadowTechnique getShadowTechnique() const;
+
+		/// \brief Declares simulation stages and volumes they access.
+		void prepareSimulationGraph();
+
+		void prepareTextures();
 
 	public:
 		glm::vec3 position;
@@ -125,6 +191,9 @@ namespace vfx
 		BuoyancyProperties buoyancy;		//!< Buoyant force properties.
 		VorticityProperties vorticity;		//!< Vorticity confinement properties.
 		PressureProperties pressure;		//!< Pressure solver properties.
+		AdaptiveStepProperties adaptiveStep;	//!< Adaptive ray marching properties.
+		ShadowProperties shadows;				//!< Shadowing technique properties.
+		ScatteringProperties scattering;		//!< Multiple scattering properties.
 
 		int shadowsSamples = 64;			//!< Number of samples used for rendering shadows.
 		int densitySamples = 128;
@@ -141,39 +210,26 @@ namespace vfx
 	private:
 		glm::vec3 mVolumeResolution;
 		glm::vec3 mWorkGroupSize;
-		glm::uvec3 mDispatchSize;
-
-		std::unique_ptr<gfx::Quad> mRenderQuad;
+		glm::uvec3 mGridSize;			//!< Simulation grid size, dispatches round it up to whole work groups.
 
-		vfx::IAdvection* mAdvection;
+		std::unique_ptr<GLComputeDevice> mDevice;		//!< Device of simulation, rendering reads its volumes as images.
+		std::unique_ptr<FluidSimulation> mSimulation;	//!< Simulation stages executed on device.
 
-		std::unique_ptr<IAdvection> mSemiLagrangian;
-		std::unique_ptr<IAdvection> mMacCormack;
-
-		// Basic smoke & fire advection & injection quantities
-		std::shared_ptr<Quantity> mVelocity;
-		std::shared_ptr<Quantity> mDensity;
-		std::shared_ptr<Quantity> mTemperature;
-		std::shared_ptr<Quantity> mPressure;
-
-		// Volume used as compute target for obstacles
-		std::shared_ptr<Image3D> mObstacleImage;
+		std::unique_ptr<gfx::Quad> mRenderQuad;
+		std::unique_ptr<TransferFunction> mTransferFunction;
 
-		// Stage volume images
-		std::shared_ptr<Image3D> mDivergenceImage;
-		std::shared_ptr<Image3D> mVorticityImage;
-		std::shared_ptr<Image3D> mLightingImage;
-		
-		// Obstacles container
-		std::vector<std::unique_ptr<vfx::Obstacle>> mObstacles;
+		SimulationGraph mSimulationGraph;	//!< Simulation step stages.
+		float mInjectionTimeStep = 0.0f;	//!< Injection time step of current simulation step.
 
-		// Injection properties
-		std::vector<InjectionProperties> mInjectionProps;
+		// Render stage volume images
+		std::shared_ptr<Image3D> mLightingImage;			//!< Allocated only for volume shadow technique.
+		std::unique_ptr<DeepOpacityMap> mDeepOpacityMap;	//!< Allocated only for deep opacity map shadow technique.
+		std::shared_ptr<Image3D> mOccupancyImage;
+		std::unique_ptr<LightDiffusion> mLightDiffusion;	//!< Allocated when scattering is enabled.
+		std::unique_ptr<SimulationStatistics> mStatistics;	//!< Health counters of simulation.
 
 		bool mIsInitialized = false;
 		bool mObstacleHasMoved = false;
-	
-		int mActiveObstacleIndex = 0;
 	};
 
 }
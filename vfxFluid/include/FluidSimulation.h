@@ -0,0 +1,119 @@
+#pragma once
+
+#include "SimProperties.h"
+#include "glm/vec3.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace vfx
+{
+	class IVolume;
+	class IComputeDevice;
+	class IAdvection;
+	class Quantity;
+	class Obstacle;
+
+	/// \brief	Simulation stages of Fluid executed on compute device.
+	///
+	///			Stages bind kernels and volumes of injected device only, all volumes
+	///			including obstacle are allocated by it, so GPU simulation of Fluid and
+	///			CPU reference run the same stage sequence. Stages do not issue barriers
+	///			after their last dispatch, Fluid orders them by simulation graph and
+	///			simulate by barrier after each stage.
+	class FluidSimulation
+	{
+	public:
+		/// \param device Device executing stages, has to outlive simulation.
+		explicit FluidSimulation(IComputeDevice& device);
+		~FluidSimulation();
+
+		/// \brief	Reallocates volumes, quantities are cleared and obstacles recreated.
+		void resize(const glm::uvec3& size);
+
+		/// \brief	Releases volumes and resets obstacle properties.
+		void reset();
+
+		/// \brief	Selects and fills obstacle: 0 - boundary, 1 - sphere, 2 - box.
+		///			Obstacles are created by resize.
+		void changeObstacle(unsigned int index);
+
+		/// \brief	Moves and refills active obstacle.
+		void moveObstacle(const glm::vec3& position);
+
+		/// \brief	Executes simulation step, stages disabled by features are skipped.
+		///
+		/// \param deltaTime Time step.
+		/// \param injectionTimeStep Time step of injection, injection is skipped when not positive.
+		void simulate(float deltaTime, float injectionTimeStep);
+
+		/// \brief Advects velocity by Semi-Lagrangian advection.
+		void advectVelocity(float deltaTime);
+
+		/// \brief Advects temperature by selected advection.
+		void advectTemperature(float deltaTime);
+
+		/// \brief Advects density by selected advection.
+		void advectDensity(float deltaTime);
+
+		/// \brief Injects density, temperature and velocity of all injection sources.
+		void inject(float deltaTime);
+
+		void computeBuoyancy(float deltaTime);
+		void computeVorticity();
+		void computeConfinement(float deltaTime);
+		void computeDivergence();
+
+		/// \brief Solves pressure by Jacobi method, starting from zero pressure.
+		void solvePressure();
+
+		/// \brief Subtracts pressure gradient from velocity.
+		void projectAndSubtract();
+
+		IComputeDevice& getDevice() const { return mDevice; }
+		const glm::uvec3& getSize() const { return mSize; }
+
+		Quantity& getVelocity() const { return *mVelocity; }
+		Quantity& getDensity() const { return *mDensity; }
+		Quantity& getTemperature() const { return *mTemperature; }
+		Quantity& getPressure() const { return *mPressure; }
+
+		const IVolume& getObstacleVolume() const { return *mObstacleVolume; }
+		const IVolume& getDivergenceVolume() const { return *mDivergenceVolume; }
+		const IVolume& getVorticityVolume() const { return *mVorticityVolume; }
+
+		unsigned int getActiveObstacleIndex() const { return mActiveObstacleIndex; }
+		glm::vec3 getObstaclePosition() const;
+
+	public:
+		Features features;
+		BuoyancyProperties buoyancy;					//!< Buoyant force properties.
+		VorticityProperties vorticity;					//!< Vorticity confinement properties.
+		PressureProperties pressure;					//!< Pressure solver properties.
+		std::vector<InjectionProperties> injections;	//!< Injection sources, one by default.
+
+		bool useMacCormackAdvection = true;				//!< Advection of temperature and density.
+
+	private:
+		void advect(IAdvection& advection, Quantity& quantity, float dissipation, float decay, float deltaTime);
+
+	private:
+		IComputeDevice& mDevice;
+		glm::uvec3 mSize;
+
+		std::unique_ptr<IAdvection> mSemiLagrangian;
+		std::unique_ptr<IAdvection> mMacCormack;
+
+		std::unique_ptr<Quantity> mVelocity;
+		std::unique_ptr<Quantity> mDensity;
+		std::unique_ptr<Quantity> mTemperature;
+		std::unique_ptr<Quantity> mPressure;
+
+		std::shared_ptr<IVolume> mObstacleVolume;		//!< Shared by obstacles, filled by active one.
+		std::shared_ptr<IVolume> mDivergenceVolume;
+		std::shared_ptr<IVolume> mVorticityVolume;
+
+		std::vector<std::unique_ptr<Obstacle>> mObstacles;
+		unsigned int mActiveObstacleIndex = 0;
+	};
+}
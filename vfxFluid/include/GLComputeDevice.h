@@ -0,0 +1,50 @@
+#pragma once
+
+#include "IComputeDevice.h"
+#include "GL/glew.h"
+
+namespace vfx
+{
+	class Image3D;
+	class Pipeline;
+
+	/// \brief	Compute device running kernels as compute pipelines of system::Renderer.
+	///
+	///			Volumes are Image3D textures, kernel parameters are uploaded through
+	///			uniform ring buffer of renderer.
+	class GLComputeDevice : public IComputeDevice
+	{
+	public:
+		/// \brief	Returns image of volume allocated by this device, volume is
+		///			a handle so image is mutable for passes writing its content.
+		static Image3D& getImage(const IVolume& volume);
+
+		/// \brief	Texture format of volume format.
+		static GLenum getTextureFormat(VolumeFormat format);
+
+		std::shared_ptr<IVolume> createVolume(const glm::uvec3& size, VolumeFormat format) override;
+
+		void bindKernel(const std::string& name, const glm::uvec3& gridSize) override;
+		void unbindKernel() override;
+
+		void bindVolume(unsigned int unit, const IVolume& volume) override;
+		void bindTarget(unsigned int unit, const IVolume& volume) override;
+
+		void setParameters(const void* data, std::size_t size) override;
+		using IComputeDevice::setParameters;
+
+		void setUniform(const std::string& name, float value) override;
+		void setUniform(const std::string& name, const glm::vec3& value) override;
+		void setUniform(const std::string& name, const glm::vec4& value) override;
+
+		void dispatch() override;
+		void barrier(Barrier barrier) override;
+		void clear(const IVolume& volume) override;
+		void readback(const IVolume& volume, Volume& data) override;
+
+	private:
+		std::shared_ptr<Pipeline> mPipeline;	//!< Pipeline of bound kernel.
+		std::string mKernel;					//!< Name of bound kernel.
+		glm::uvec3 mGridSize;					//!< Grid of bound kernel.
+	};
+}
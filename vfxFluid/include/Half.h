@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace vfx
+{
+	/// \brief	Converts float to IEEE 754 half, rounds to nearest even.
+	///
+	///			Matches hardware conversion (F16C, GPU) bit for bit, overflow
+	///			gives infinity, NaN stays quiet NaN.
+	inline uint16_t floatToHalf(float value)
+	{
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+
+		const uint32_t sign = (bits >> 16) & 0x8000u;
+		const uint32_t magnitude = bits & 0x7fffffffu;
+
+		// Infinity and NaN
+		if (magnitude >= 0x7f800000u)
+			return static_cast<uint16_t>(sign | 0x7c00u | (magnitude > 0x7f800000u ? 0x0200u | ((magnitude >> 13) & 0x03ffu) : 0u));
+
+		// Rounds to infinity from 65520
+		if (magnitude >= 0x477ff000u)
+			return static_cast<uint16_t>(sign | 0x7c00u);
+
+		// Rounds to zero up to 2^-25
+		if (magnitude <= 0x33000000u)
+			return static_cast<uint16_t>(sign);
+
+		const uint32_t exponent = magnitude >> 23;
+		uint32_t mantissa = magnitude & 0x007fffffu;
+		uint32_t shift = 13;
+		uint32_t half;
+
+		if (exponent < 113)
+		{
+			// Subnormal half, implicit bit becomes part of mantissa
+			mantissa |= 0x00800000u;
+			shift = 126 - exponent;
+			half = mantissa >> shift;
+		}
+		else
+		{
+			half = ((exponent - 112) << 10) | (mantissa >> shift);
+		}
+
+		// Round to nearest even, carry may propagate to exponent
+		const uint32_t remainder = mantissa & ((1u << shift) - 1);
+		const uint32_t halfway = 1u << (shift - 1);
+
+		if (remainder > halfway || (remainder == halfway && (half & 1u)))
+			++half;
+
+		return static_cast<uint16_t>(sign | half);
+	}
+
+	/// \brief	Converts IEEE 754 half to float, conversion is exact except NaN,
+	///			which is quieted as by hardware.
+	inline float halfToFloat(uint16_t value)
+	{
+		const uint32_t sign = static_cast<uint32_t>(value & 0x8000u) << 16;
+		uint32_t exponent = (value >> 10) & 0x1fu;
+		uint32_t mantissa = value & 0x03ffu;
+		uint32_t bits;
+
+		if (exponent == 0x1fu)
+		{
+			bits = sign | 0x7f800000u | (mantissa ? 0x00400000u | (mantissa << 13) : 0u);
+		}
+		else if (exponent != 0)
+		{
+			bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+		}
+		else if (mantissa != 0)
+		{
+			// Subnormal half is normal float
+			exponent = 1;
+			while (!(mantissa & 0x0400u))
+			{
+				mantissa <<= 1;
+				--exponent;
+			}
+
+			bits = sign | ((exponent + 112) << 23) | ((mantissa & 0x03ffu) << 13);
+		}
+		else
+		{
+			bits = sign;
+		}
+
+		float result;
+		std::memcpy(&result, &bits, sizeof(result));
+		return result;
+	}
+
+	/// \brief	16-bit floating point value, layout of R16F texel.
+	///
+	///			Storage type only, arithmetic converts to float. Arrays
+	///			should be converted by convertToFloat and convertToHalf.
+	struct Half
+	{
+		uint16_t bits;		//!< IEEE 754 binary16 representation.
+
+		Half() = default;
+
+		Half(float value)
+			: bits(floatToHalf(value))
+		{
+		}
+
+		operator float() const { return halfToFloat(bits); }
+	};
+
+	static_assert(sizeof(Half) == 2, "Half has to be tightly packed");
+
+	/// \brief	Converts array of floats to halves, vectorized by F16C if enabled.
+	///
+	/// \param source Converted floats.
+	/// \param destination Halves, must not overlap source.
+	/// \param count Number of values.
+	void convertToHalf(const float* source, Half* destination, size_t count);
+
+	/// \brief	Converts array of halves to floats, vectorized by F16C if enabled.
+	///
+	/// \param source Converted halves.
+	/// \param destination Floats, must not overlap source.
+	/// \param count Number of values.
+	void convertToFloat(const Half* source, float* destination, size_t count);
+
+	/// \brief	Instruction set of array conversions.
+	const char* getHalfConversionName();
+}
@@ -3,11 +3,12 @@
 namespace vfx
 {
 	// Forward declarations,
-	class Image3D;
+	class IVolume;
 
 	class IAdvection
 	{
 	public:
+		virtual ~IAdvection() {}
 
 		/// \brief Advection algorithm interface.
 		///
@@ -18,10 +19,10 @@ namespace vfx
 		/// \param dissipation Quantity dissipation property.
 		/// \param decay	   Quantity decay property.
 		/// \param dt		   Delta time.
-		virtual void advect(const Image3D& obstacle,
-							const Image3D& velocity,
-							const Image3D& source,
-							const Image3D& target,
+		virtual void advect(const IVolume& obstacle,
+							const IVolume& velocity,
+							const IVolume& source,
+							const IVolume& target,
 							float dissipation,
 							float decay,
 							float dt) = 0;
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace vfx
+{
+	struct Volume;
+
+	/// \brief	Storage format of simulation volume.
+	enum class VolumeFormat
+	{
+		R8,			//!< Normalized scalar, obstacles.
+		R16F,		//!< Scalar quantity.
+		RG16F,		//!< Two component quantity.
+		RGBA16F,	//!< Vector quantity.
+		R32F,		//!< Full precision scalar quantity.
+		RG32F,		//!< Full precision two component quantity.
+		RGBA32F		//!< Full precision vector quantity.
+	};
+
+	/// \brief	Number of channels of volume format.
+	inline unsigned int getFormatChannels(VolumeFormat format)
+	{
+		switch (format)
+		{
+		case VolumeFormat::RG16F:
+		case VolumeFormat::RG32F:
+			return 2;
+		case VolumeFormat::RGBA16F:
+		case VolumeFormat::RGBA32F:
+			return 4;
+		default: return 1;
+		}
+	}
+
+	/// \brief	Ordering of dispatch results for following dispatches.
+	enum class Barrier
+	{
+		TextureFetch,	//!< Written volume is sampled by next dispatch.
+		ImageAccess,	//!< Written volume is loaded or stored as image by next dispatch.
+		All
+	};
+
+	/// \brief	Volume allocated by compute device.
+	///
+	///			Volume is a handle, dispatches write its content even through
+	///			const reference as GPU images do.
+	class IVolume
+	{
+	public:
+		virtual ~IVolume() {}
+
+		/// \brief	Volume size getter.
+		virtual glm::vec3 getSize() const = 0;
+
+		/// \brief	Volume format getter.
+		virtual VolumeFormat getVolumeFormat() const = 0;
+
+		/// \brief	Releases volume storage.
+		virtual void reset() = 0;
+	};
+
+	/// \brief	Backend executing simulation kernels.
+	///
+	///			Kernels are addressed by pipeline names of config.json. Volumes bound
+	///			to sampler units are read with linear filtering and clamp to edge,
+	///			volumes bound to image units are written. Bindings and parameters
+	///			are valid between bindKernel and unbindKernel, dispatches are ordered
+	///			by barriers only.
+	class IComputeDevice
+	{
+	public:
+		virtual ~IComputeDevice() {}
+
+		/// \brief	Allocates volume, content is undefined until cleared or written.
+		///
+		/// \param size Volume size.
+		/// \param format Volume format.
+		virtual std::shared_ptr<IVolume> createVolume(const glm::uvec3& size, VolumeFormat format) = 0;
+
+		/// \brief	Binds kernel for following dispatches.
+		///
+		/// \param name Name of kernel pipeline.
+		/// \param gridSize Number of invocations in each dimension.
+		virtual void bindKernel(const std::string& name, const glm::uvec3& gridSize) = 0;
+
+		/// \brief	Unbinds kernel and releases its bindings.
+		virtual void unbindKernel() = 0;
+
+		/// \brief	Binds volume to sampler unit of bound kernel.
+		virtual void bindVolume(unsigned int unit, const IVolume& volume) = 0;
+
+		/// \brief	Binds volume to image unit of bound kernel.
+		virtual void bindTarget(unsigned int unit, const IVolume& volume) = 0;
+
+		/// \brief	Sets parameter block of bound kernel (see UniformBlocks.h).
+		virtual void setParameters(const void* data, std::size_t size) = 0;
+
+		template<typename T>
+		void setParameters(const T& block)
+		{
+			setParameters(&block, sizeof(T));
+		}
+
+		/// \brief	Sets named uniform of bound kernel.
+		virtual void setUniform(const std::string& name, float value) = 0;
+		virtual void setUniform(const std::string& name, const glm::vec3& value) = 0;
+		virtual void setUniform(const std::string& name, const glm::vec4& value) = 0;
+
+		/// \brief	Dispatches bound kernel over its grid.
+		virtual void dispatch() = 0;
+
+		/// \brief	Makes results of previous dispatches visible to following ones.
+		virtual void barrier(Barrier barrier) = 0;
+
+		/// \brief	Fills volume with zeros.
+		virtual void clear(const IVolume& volume) = 0;
+
+		/// \brief	Reads volume content back to CPU memory.
+		///
+		/// \param volume Volume allocated by this device.
+		/// \param data Volume filled by content.
+		virtual void readback(const IVolume& volume, Volume& data) = 0;
+	};
+}
@@ -5,6 +5,7 @@
 namespace vfx
 {
 	class Quantity;
+	class IComputeDevice;
 
 	class IInjection
 	{
@@ -1,11 +1,20 @@
 #pragma once
 
+#include "IComputeDevice.h"
+#include "SimProperties.h"
 #include "glm/vec3.hpp"
 #include "GL/glew.h"
 #include <vector>
+#include <string>
+#include <map>
+#include <utility>
+#include <tuple>
 
 namespace vfx
 {
+	struct Volume;
+	struct Half;
+
 	enum class BlurStage
 	{
 		Horizontal,
@@ -13,11 +22,10 @@ namespace vfx
 		Depth
 	};
 
-	class Image3D
+	class Image3D : public IVolume
 	{
 	public:
 		Image3D(const glm::uvec3& rSize,
-				bool blurrable = false,
 				GLenum format = GL_RGBA16F,
 				GLenum magFilter = GL_LINEAR,
 				GLenum minFilter = GL_LINEAR,
@@ -26,56 +34,128 @@ namespace vfx
 				GLint maxLevel = 0);
 		virtual ~Image3D();
 
-		/// \brief	Initializer for shared blur targets.
-		static void createBlurTempTargets(const glm::uvec3& size, GLenum format = GL_RGBA16F, GLenum magFilter = GL_LINEAR, GLenum minFilter = GL_LINEAR, GLenum wrapMode = GL_CLAMP_TO_EDGE, GLint baseLevel = 0, GLint maxLevel = 0);
+		/// \brief	Releases pooled blur scratch targets, they are recreated on demand.
+		static void releaseBlurScratch();
 
 		/// \brief	Binds the image.
-		///
-		/// \param textureUnit Selected texture unit.
+		///
+		/// \param textureUnit Selected texture unit index.
 		void bind(int textureUnit) const;
 
 		/// \brief	Unbinds image.
-		void unbind() const;
+		///
+		/// \param textureUnit Texture unit index the image is bound to.
+		void unbind(int textureUnit) const;
 
 		/// \brief	Image size getter.
-		glm::vec3 getSize() const;
+		glm::vec3 getSize() const override;
 
-		/// \brief	Image format getter.
+		/// \brief	Image format getter.
 		GLenum getFormat() const;
 
+		/// \brief	Image format getter in terms of compute device.
+		VolumeFormat getVolumeFormat() const override;
+
 		/// \brief	Blurred image handle getter.
 		GLuint getBlurredObjectID() const;
 
 		/// \brief	Image handle getter.
 		GLuint getObjectID() const;
 
-		/// \brief	Applies 3D gaussian blur filter on this image
-		///
+		/// \brief	Applies 3D gaussian blur filter on this image
+		///
+		/// \param sigma Blur strength amplifier.
+		/// \param size Size of the kernel (ignored by recursive filter).
+		/// \param mode Filter implementation.
+		void blur(float sigma, unsigned int size, BlurMode mode = BlurMode::Automatic);
+
+		/// \brief	Resolves automatic blur mode selection.
+		///
 		/// \param sigma Blur strength amplifier.
 		/// \param size Size of the kernel.
-		void blur(float sigma, unsigned int size);
+		static BlurMode selectBlurMode(float sigma, unsigned int size);
+
+		/// \brief	Number of channels of image format.
+		unsigned int getChannels() const;
+
+		/// \brief	Reads image content back to CPU memory.
+		///
+		/// \param volume Volume filled by image data.
+		void readback(Volume& volume) const;
+
+		/// \brief	Reads image content back as halves, channels interleaved.
+		///			Lossless for 16F formats.
+		///
+		/// \param data Halves filled by image data.
+		void readback(std::vector<Half>& data) const;
+
+		/// \brief	Whether image is stored in 16-bit floating point format.
+		bool isHalfFormat() const;
+
+		/// \brief	Reads image content back and writes it to volume file,
+		///			16F images are written as halves.
+		///
+		/// \param filename Output file path.
+		/// \return True if volume has been written.
+		bool exportVolume(const std::string& filename) const;
 
 		/// \brief	Clears texture by filling witih predefined value (0)
 		void clear() const;
 
 		/// \brief	Resets this instance by deleting wrapped texture
 		///			and reseting its properties.
-		void reset();
+		void reset() override;
 
 	private:
-		void createTexture(GLuint& handle, GLenum magFilter = GL_LINEAR, GLenum minFilter = GL_LINEAR, GLenum wrapMode = GL_CLAMP_TO_EDGE, GLint baseLevel = 0, GLint maxLevel = 0);
+		/// \brief Pair of scratch targets blur passes ping-pong between.
+		struct BlurScratch
+		{
+			GLuint ping;	//!< Temporary storage texture for blurring.
+			GLuint pong;	//!< Temporary storage texture for blurring.
+		};
 
-		/// \brief Computes kernel mask for gaussian blur.
-		///
+		static void createTexture(GLuint& handle, const glm::uvec3& size, GLenum format, GLenum magFilter = GL_LINEAR, GLenum minFilter = GL_LINEAR, GLenum wrapMode = GL_CLAMP_TO_EDGE, GLint baseLevel = 0, GLint maxLevel = 0);
+
+		/// \brief Returns scratch targets matching size and format of blurred image,
+		///		   targets are created on first request and shared by images afterwards.
+		///
+		/// \param size Size of blurred image.
+		/// \param format Format of blurred image.
+		static const BlurScratch& getBlurScratch(const glm::uvec3& size, GLenum format);
+
+		/// \brief Computes kernel mask for gaussian blur.
+		///
 		/// \param size Size of kernel.
 		/// \param sigma Blur strength amplifier.
-		std::vector<float> computeFilterKernel(int size, float sigma) const;
+		static std::vector<float> computeFilterKernel(int size, float sigma);
 
-		/// \brief Computes offsets for current pass of separated gaussian blur filter.
+		/// \brief Returns shader storage buffer with kernel weights, kernel is computed
+		///		   and uploaded only when it is not cached yet.
 		///
-		/// \param stage Filter stage (separated)
 		/// \param size Size of kernel.
-		std::vector<glm::ivec3> computeBlurOffsets(BlurStage stage, int size) const;
+		/// \param sigma Blur strength amplifier.
+		static GLuint getFilterKernel(unsigned int size, float sigma);
+
+		/// \brief Dispatches single pass of separated gaussian blur.
+		///
+		/// \param stage Filter stage (blurred axis).
+		/// \param source Source texture handle.
+		/// \param target Target texture handle, format matches this image.
+		void dispatchBlurPass(BlurStage stage, GLuint source, GLuint target) const;
+
+		/// \brief Applies separable convolution gaussian blur.
+		void blurSeparable(float sigma, unsigned int size);
+
+		/// \brief Applies recursive gaussian blur, forward and backward pass per axis.
+		void blurRecursive(float sigma);
+
+		/// \brief Dispatches single causal or anticausal pass of recursive gaussian blur.
+		///
+		/// \param stage Filter stage (blurred axis).
+		/// \param backward Anticausal pass flag.
+		/// \param source Source texture handle.
+		/// \param target Target texture handle, format matches this image.
+		void dispatchRecursivePass(BlurStage stage, bool backward, GLuint source, GLuint target) const;
 
 	private:
 		glm::uvec3 mSize;		//!< Image dimensions.
@@ -83,13 +163,10 @@ namespace vfx
 		bool mIsInitialized;	//!< Iinitialization flag.
 		bool mIsBlurImageInitialized;
 
-		GLuint mOffsetSSBO;		//!< Shader storage object for blur data.
-		GLuint mWeightSSBO;		//!< Shader storage object for blur data.
 		GLuint mBlurredImage;	//!< Blurred image handle
 		GLuint mObjectID;
 
-		static GLuint mBlurTempPing;	//!< Temporary storage texture for blurring.
-		static GLuint mBlurTempPong;	//!< Temporary storage texture for blurring.
-		static bool mBlurTexInitialized;
+		static std::map<std::tuple<unsigned int, unsigned int, unsigned int, GLenum>, BlurScratch> mScratchPool;	//!< Blur scratch targets keyed by (size, format).
+		static std::map<std::pair<unsigned int, float>, GLuint> mKernelCache;	//!< Kernel weights buffers keyed by (size, sigma).
 	};
 }
\ No newline at end of file
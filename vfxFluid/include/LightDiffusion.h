@@ -0,0 +1,65 @@
+#pragma once
+
+#include "SimProperties.h"
+#include "glm/vec3.hpp"
+#include "GL/glew.h"
+
+#include <vector>
+#include <memory>
+
+namespace vfx
+{
+	class Image3D;
+	class DeepOpacityMap;
+
+	/// \brief	Multiple scattering approximation by light diffusion.
+	///
+	///			Single scattered light is downsampled into mip chain of octaves
+	///			(first octave has half resolution of the domain). Light is diffused
+	///			on each octave by few Jacobi iterations, then octaves are upsampled
+	///			and combined from the coarsest one. Number of octaves and iterations
+	///			is given by scattering quality.
+	class LightDiffusion
+	{
+	public:
+		LightDiffusion(const glm::uvec3& resolution, ScatteringQuality quality);
+		~LightDiffusion();
+
+		/// \brief	Computes scattered light volume.
+		///
+		/// \param properties Scattering properties.
+		/// \param density Density volume image.
+		/// \param lighting Lighting volume image, null if not used by shadow technique.
+		/// \param deepOpacityMap Deep opacity map, null if not used by shadow technique.
+		/// \param factor Density factor.
+		/// \param absorbtion Light absorbtion factor.
+		/// \param lightIntensity Light intensity used when shadows are disabled.
+		void compute(const ScatteringProperties& properties, const Image3D& density, const Image3D* lighting, const DeepOpacityMap* deepOpacityMap, float factor, float absorbtion, float lightIntensity);
+
+		/// \brief	Combined scattered light volume handle getter.
+		GLuint getObjectID() const;
+
+		/// \brief	Quality the octaves were created for.
+		ScatteringQuality getQuality() const { return mQuality; }
+
+	private:
+		struct Octave
+		{
+			std::unique_ptr<Image3D> source;	//!< Source term (x) and extinction (y).
+			std::unique_ptr<Image3D> ping;		//!< Diffused light.
+			std::unique_ptr<Image3D> pong;		//!< Diffused light.
+		};
+
+		void computeSource(const Image3D& density, const Image3D* lighting, const DeepOpacityMap* deepOpacityMap, float factor, float absorbtion, float lightIntensity);
+		void diffuse(float albedo, float absorbtion);
+		void upsample(float octaveWeight);
+
+		/// \brief Dispatches compute task covering whole image.
+		static void dispatch(const Image3D& image);
+
+	private:
+		ScatteringQuality mQuality;			//!< Selected quality.
+		unsigned int mIterations;			//!< Diffusion iterations per octave.
+		std::vector<Octave> mOctaves;		//!< Octaves from the finest to the coarsest.
+	};
+}
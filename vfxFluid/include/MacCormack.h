@@ -8,13 +8,16 @@
 
 namespace vfx
 {
+	class IComputeDevice;
+
 	class MacCormack : public IAdvection
 	{
 	public:
 		/// \brief Constructor.
 		///
+		/// \param device Device executing advection kernels.
 		/// \param resolution Volume images resolution.
-		MacCormack(const glm::vec3& resolution);
+		MacCormack(IComputeDevice& device, const glm::vec3& resolution);
 
 		/// \brief Advection algorithm interface.
 		///
@@ -25,18 +28,20 @@ namespace vfx
 		/// \param dissipation Quantity dissipation property.
 		/// \param decay	   Quantity decay property.
 		/// \param dt		   Delta time.
-		void advect(const Image3D& obstacle,
-			const Image3D& velocity,
-			const Image3D& source,
-			const Image3D& target,
+		void advect(const IVolume& obstacle,
+			const IVolume& velocity,
+			const IVolume& source,
+			const IVolume& target,
 			float dissipation,
 			float decay,
 			float dt) override;
 
 	private:
-		std::shared_ptr<Image3D> mPhi_n1_hat_4d;	//!< Immediate product \hat{phi^{n+1}} volume texture [4D].
-		std::shared_ptr<Image3D> mPhi_n1_hat_1d;	//!< Immediate product \hat{phi^{n+1}} volume texture [1D].
-		std::shared_ptr<Image3D> mPhi_n_hat_4d;		//!< Immediate product \hat{phi^{n}} volume texture [4D].
-		std::shared_ptr<Image3D> mPhi_n_hat_1d;		//!< Immediate product \hat{phi^{n}} volume texture [1D].
+		IComputeDevice& mDevice;					//!< Device executing advection kernels.
+
+		std::shared_ptr<IVolume> mPhi_n1_hat_4d;	//!< Immediate product \hat{phi^{n+1}} volume texture [4D].
+		std::shared_ptr<IVolume> mPhi_n1_hat_1d;	//!< Immediate product \hat{phi^{n+1}} volume texture [1D].
+		std::shared_ptr<IVolume> mPhi_n_hat_4d;		//!< Immediate product \hat{phi^{n}} volume texture [4D].
+		std::shared_ptr<IVolume> mPhi_n_hat_1d;		//!< Immediate product \hat{phi^{n}} volume texture [1D].
 	};
 }
\ No newline at end of file
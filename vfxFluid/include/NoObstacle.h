@@ -7,7 +7,7 @@ namespace vfx
 	class NoObstacle : public Obstacle
 	{
 	public:
-		NoObstacle(const std::shared_ptr<Image3D>& volume, const glm::vec3& workGroupSize);
+		NoObstacle(IComputeDevice& device, const std::shared_ptr<IVolume>& volume);
 		virtual ~NoObstacle();
 
 		void bindProperties() const override;
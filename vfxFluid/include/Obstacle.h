@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <glm/vec3.hpp>
+
+namespace vfx
+{
+	class IVolume;
+	class IComputeDevice;
+
+	class Obstacle
+	{
+	public:
+		/// \param device Device executing fill kernel.
+		/// \param volume Obstacle volume allocated by device.
+		/// \param kernel Name of fill kernel.
+		Obstacle(	IComputeDevice& device,
+					const std::shared_ptr<IVolume>& volume,
+					const std::string& kernel);
+		virtual ~Obstacle() {}
+
+		virtual void reset() = 0;
+
+		/// \brief Fills obstacle volume with predefined value, using fill kernel.
+		void fill();
+
+		/// \brief Volume getter.
+		///
+		/// \returns Obstacle volume.
+		const std::shared_ptr<IVolume>& getVolume() const { return mVolume; }
+
+	private:
+		/// \brief Sets uniforms of bound fill kernel.
+		virtual void bindProperties() const = 0;
+
+	public:
+		glm::vec3 position;
+
+	protected:
+		IComputeDevice& mDevice;
+		std::shared_ptr<IVolume> mVolume;
+		std::string mKernel;
+	};
+}
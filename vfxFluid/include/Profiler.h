@@ -6,16 +6,6 @@
 #include <glm/vec3.hpp>
 
 
-#if defined(_DEBUG) && defined(PROFILE)
-#define PROFILE_STAGE(stageFunction, stageName) \
-{ \
-	profile::Profiler::beginQuery(stageName); \
-	stageFunction; \
-	profile::Profiler::endQuery();\
-}
-#else
-#define PROFILE_STAGE
-#endif
 
 namespace profile
 {
@@ -28,7 +18,8 @@ namespace profile
 		Confinement,
 		Divergence,
 		Pressure,
-		SubtractGradient
+		SubtractGradient,
+		Statistics
 	};
 
 	enum class RenderStage
@@ -38,11 +29,14 @@ namespace profile
 		BlurTemperature,
 		BlurDensity,
 		BlurObstacle,
+		Occupancy,
+		Scattering,
 		RayMarching
 	};
 
 	struct TestData
 	{
+		std::string name;
 		bool shadows = false;
 		bool obstacle = false;
 		bool radiance = false;
@@ -51,6 +45,7 @@ namespace profile
 		bool blurObstacle = false;
 		bool blurTemperature = false;
 		bool blurDensity = false;
+		bool statistics = false;
 		float blurDensityFactor = 3.0f;
 		float blurTemperatureFactor = 3.0f;
 		float blurObstacleFactor = 3.0f;
@@ -59,25 +54,55 @@ namespace profile
 		float lightingSamples = 64;
 	};
 
+	/// \brief	Summary of stage times [ms].
+	struct Statistics
+	{
+		size_t samples = 0;
+		double mean = 0.0;
+		double median = 0.0;
+		double p95 = 0.0;
+		double p99 = 0.0;
+		double stddev = 0.0;
+	};
+
 	class Profiler
 	{
 	public:
-		static void beginQuery(RenderStage stage_);
-		static void beginQuery(SimulationStage stage_);
-		static void endQuery();
+		/// \brief	Appends stage times of frame read from timestamp queries, scopes
+		///			of same stage are summed. Times lag behind by query latency,
+		///			nothing is appended if no frame was read since last call.
+		static void collect();
 		static void log(const std::string& filename);
 		static void loadProfilingData(const std::string & file);
-		static glm::ivec3 getNextGridResolution();
+
+		/// \brief	Advances to next grid resolution, then to next scenario.
+		///
+		/// \param resolution Resolution to profile next.
+		/// \return False when all scenarios were profiled.
+		static bool getNextGridResolution(glm::ivec3& resolution);
 		static TestData getSettings();
 
+		static const std::vector<TestData>& getScenarios() { return scenarios; }
+		static const std::vector<glm::ivec3>& getResolutions() { return profileResolutions; }
+		static const std::map<std::string, std::vector<float>>& getStageTimes() { return stageTimes; }
+		static void clearStageTimes() { stageTimes.clear(); counters.clear(); }
+
+		/// \brief	Appends value of simulation health counter, e.g. divergence residual.
+		static void addCounter(const std::string& name, float value) { counters[name].push_back(value); }
+		static const std::map<std::string, std::vector<float>>& getCounters() { return counters; }
+
+		/// \brief	Computes statistics of samples, percentiles are nearest rank.
+		static Statistics computeStatistics(std::vector<float> samples);
+
 	public:
 		static unsigned int frames;
 		static unsigned int activeScenarioIndex;
+		static unsigned int warmupFrames;			//!< Frames run before measurement of each resolution.
+		static unsigned int measuredFrames;			//!< Frames measured for each resolution.
 
 	private:
-		static unsigned int query;
-		static std::string stage;
 		static std::map<std::string, std::vector<float>> stageTimes;
+		static std::map<std::string, std::vector<float>> counters;
 		static std::vector<glm::ivec3> profileResolutions;
 		static std::vector<TestData> scenarios;
 		static unsigned int activeGridIndex;
@@ -85,6 +110,6 @@ namespace profile
 		static const std::string delimiter;
 	};
 
-	static std::string to_string(SimulationStage);
-	static std::string to_string(RenderStage);
+	std::string to_string(SimulationStage);
+	std::string to_string(RenderStage);
 }
\ No newline at end of file
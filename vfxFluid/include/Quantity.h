@@ -2,33 +2,34 @@
 
 #include "glm/vec3.hpp"
 #include "Parameter.h"
+#include "SimProperties.h"
 
 #include <memory>
+#include <stdexcept>
+#include <string>
 #include <unordered_map>
 
 namespace vfx
 {
-	class Image3D;
+	class IVolume;
+	class IComputeDevice;
 	class IInjection;
 
 	class Quantity
 	{
 	public:
-		Quantity(const glm::vec3& resolution, short int channels);
+		/// \param device Device allocating quantity volumes.
+		/// \param resolution Volume resolution.
+		/// \param channels Number of channels, 1 or 4.
+		Quantity(IComputeDevice& device, const glm::vec3& resolution, short int channels);
 		virtual ~Quantity();
 
-		/// \brief	Returns pointer to ping image.
-		const Image3D* ping() const;
+		/// \brief	Returns pointer to ping volume.
+		const IVolume* ping() const;
 
-		/// \brief	Returns pointer to pong image.
-		const Image3D* pong() const;
+		/// \brief	Returns pointer to pong volume.
+		const IVolume* pong() const;
 
-		/// \brief	Blurs ping image.
-		///
-		/// \param sigma Blur sigma.
-		/// \param sizze Blur kernel size.
-		void blur(float sigma, unsigned int size) const;
-		
 		/// \brief	Injects data into volume
 		///
 		/// \param position Position of injection.
@@ -63,8 +64,9 @@ namespace vfx
 		void swap();
 
 	private:
-		std::shared_ptr<Image3D> mPing;		//!< First volume image.
-		std::shared_ptr<Image3D> mPong;		//!< Second volume image.
+		IComputeDevice& mDevice;			//!< Device owning volumes.
+		std::shared_ptr<IVolume> mPing;		//!< First volume image.
+		std::shared_ptr<IVolume> mPong;		//!< Second volume image.
 		std::shared_ptr<IInjection> mInjection; //!< The injection algorithm.
 
 		std::unordered_map<std::string, ParameterBase*> mProperties;	//!< Quantity properties.
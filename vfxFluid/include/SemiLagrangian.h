@@ -4,9 +4,16 @@
 
 namespace vfx
 {
+	class IComputeDevice;
+
 	class SemiLagrangian : public IAdvection
 	{
 	public:
+		/// \brief Constructor.
+		///
+		/// \param device Device executing advection kernels.
+		SemiLagrangian(IComputeDevice& device);
+
 		/// \brief Advection algorithm interface.
 		///
 		/// \param obstacle    Obstacle volume image.
@@ -16,12 +23,15 @@ namespace vfx
 		/// \param dissipation Quantity dissipation property.
 		/// \param decay	   Quantity decay property.
 		/// \param dt		   Delta time.
-		void advect(const Image3D& obstacle,
-			const Image3D& velocity,
-			const Image3D& source,
-			const Image3D& target,
+		void advect(const IVolume& obstacle,
+			const IVolume& velocity,
+			const IVolume& source,
+			const IVolume& target,
 			float dissipation,
 			float decay,
 			float dt) override;
+
+	private:
+		IComputeDevice& mDevice;	//!< Device executing advection kernels.
 	};
 }
\ No newline at end of file
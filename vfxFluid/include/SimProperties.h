@@ -25,10 +25,19 @@ namespace vfx
 		bool injectionEnabled = true;
 		bool radianceEnabled = false;
 		bool scatteringEnabled = false;
+		bool statisticsEnabled = false;		//!< Reduces health counters after projection, see SimulationStatistics.
+	};
+
+	enum class BlurMode
+	{
+		Automatic,		//!< Recursive filter for wide kernels, separable convolution otherwise.
+		Separable,		//!< Separable convolution, cost grows with kernel size.
+		Recursive		//!< Recursive (Young - van Vliet) gaussian, constant cost regardless of sigma.
 	};
 
 	struct BlurFeatures
 	{
+		BlurMode mode = BlurMode::Automatic;
 		bool radianceBlurEnabled = false;
 		bool obstacleBlurEnabled = false;
 		bool shadowsBlurEnabled = false;
@@ -58,4 +67,42 @@ namespace vfx
 		int iterations = 20;			//!< Number of Jacobi iterations.
 		float gradientScale = 1.0f;		//!< Pressure projection gradient scale.
 	};
+
+	enum class ShadowTechnique
+	{
+		Automatic,			//!< Deep opacity map for domains larger than 256^3, shadow volume otherwise.
+		Volume,				//!< Full resolution 3D lighting volume.
+		DeepOpacityMap		//!< Light space 2D texture array of opacity layers.
+	};
+
+	struct ShadowProperties
+	{
+		ShadowTechnique technique = ShadowTechnique::Automatic;	//!< Selected shadowing technique.
+		int deepOpacityLayers = 16;								//!< Number of depth layers of deep opacity map.
+	};
+
+	enum class ScatteringQuality
+	{
+		Low,		//!< 2 octaves, 2 diffusion iterations per octave.
+		Medium,		//!< 3 octaves, 4 diffusion iterations per octave.
+		High		//!< 4 octaves, 8 diffusion iterations per octave.
+	};
+
+	struct ScatteringProperties
+	{
+		ScatteringQuality quality = ScatteringQuality::Medium;	//!< Number of octaves and diffusion iterations.
+		float albedo = 0.8f;									//!< Fraction of light scattered at each diffusion step.
+		float octaveWeight = 0.5f;								//!< Weight of coarser octave when combining.
+		float intensity = 1.0f;									//!< Multiple scattering contribution to rendering.
+	};
+
+	struct AdaptiveStepProperties
+	{
+		bool enabled = true;					//!< Adaptive ray marching step size.
+		int brickSize = 4;						//!< Size of occupancy brick in voxels.
+		float minStepScale = 0.5f;				//!< Step scale at sharp density boundaries.
+		float maxStepScale = 4.0f;				//!< Step scale in low density regions.
+		float gradientThreshold = 0.5f;			//!< Gradient magnitude considered as sharp boundary.
+		float transmittanceGrowth = 2.0f;		//!< Step scale reached when transmittance drops to zero.
+	};
 }
\ No newline at end of file
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "GL/glew.h"
+#include <vector>
+#include <string>
+#include <functional>
+#include <unordered_map>
+
+namespace vfx
+{
+	/// \brief	Declarative graph of simulation stages.
+	///
+	///			Stages declare images they read and write, the graph derives
+	///			memory barriers from these declarations instead of each stage
+	///			issuing its own. Disabled stages are culled, independent
+	///			stages are moved forward to share barriers with earlier work.
+	///			Schedule is compiled once per set of enabled stages and
+	///			replayed afterwards.
+	///
+	///			Stages are responsible only for barriers between their own
+	///			dispatches, graph issues barriers between stages and flushes
+	///			pending writes at the end of execution.
+	class SimulationGraph
+	{
+	public:
+		/// \brief	Way the stage reads resource.
+		enum class Access
+		{
+			Sampled,	//!< Texture fetch through sampler.
+			Image		//!< Image load.
+		};
+
+		/// \brief	Resource read by stage.
+		struct Read
+		{
+			unsigned int resource;
+			Access access;
+
+			Read(unsigned int resource_, Access access_ = Access::Sampled) : resource(resource_), access(access_) {}
+		};
+
+		typedef std::function<void(float)> StageFunction;
+
+		/// \brief	Registers logical resource.
+		///
+		/// \param name Resource name used in log messages.
+		/// \param doubleBuffered Writes go to second image (ping-pong), stage
+		///						  writing it does not overwrite data read by earlier stages.
+		/// \return Resource index.
+		unsigned int addResource(const std::string& name, bool doubleBuffered);
+
+		/// \brief	Adds stage, declaration order defines order of dependent stages.
+		///
+		/// \param name Stage name.
+		/// \param reads Resources read by stage.
+		/// \param writes Resources written by stage.
+		/// \param function Records stage commands, receives time step.
+		/// \return Stage index, bit of this index enables stage in execution mask.
+		unsigned int addStage(const std::string& name, const std::vector<Read>& reads, const std::vector<unsigned int>& writes, const StageFunction& function);
+
+		/// \brief	Returns mask bit of stage with given name, 0 if there is none.
+		unsigned int getStageMask(const std::string& name) const;
+
+		/// \brief	Returns mask with all stages enabled.
+		unsigned int getAllStagesMask() const;
+
+		/// \brief	Executes enabled stages, schedule is compiled on first use of mask.
+		///
+		/// \param mask Enabled stages.
+		/// \param deltaTime Time step passed to stages.
+		void execute(unsigned int mask, float deltaTime);
+
+		/// \brief	Removes all stages and resources.
+		void clear();
+
+	private:
+		/// \brief	Recorded command, optional barrier followed by stage.
+		struct Command
+		{
+			GLbitfield barriers;	//!< Barriers issued before stage, 0 if none.
+			unsigned int stage;		//!< Index of executed stage.
+		};
+
+		/// \brief	Compiled schedule of single mask.
+		struct CommandList
+		{
+			std::vector<Command> commands;
+			GLbitfield flush = 0;	//!< Barriers issued after last stage.
+		};
+
+		struct Resource
+		{
+			std::string name;
+			bool doubleBuffered;
+		};
+
+		struct Stage
+		{
+			std::string name;
+			std::vector<Read> reads;
+			std::vector<unsigned int> writes;
+			StageFunction function;
+		};
+
+		/// \brief	True if stage has to wait for earlier stage.
+		bool dependsOn(const Stage& stage, const Stage& earlier) const;
+
+		/// \brief	Culls, levels and orders stages of mask and places barriers.
+		CommandList compile(unsigned int mask) const;
+
+	private:
+		std::vector<Resource> mResources;
+		std::vector<Stage> mStages;
+		std::unordered_map<unsigned int, CommandList> mCommandLists;	//!< Compiled schedules keyed by mask.
+	};
+}
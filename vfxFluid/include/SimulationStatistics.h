@@ -0,0 +1,87 @@
+#pragma once
+
+#include "glm/vec3.hpp"
+#include "GL/glew.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace vfx
+{
+	class Image3D;
+
+	/// \brief	Health counters of simulation reduced on GPU.
+	///
+	///			First pass reduces grid into partial results of work groups,
+	///			single work group then reduces partials into slot of persistently
+	///			mapped result ring. Slot is read once its fence has been signaled,
+	///			values lag few frames behind and CPU never waits for GPU.
+	class SimulationStatistics
+	{
+	public:
+		/// \brief	Counters of single simulation step.
+		struct Values
+		{
+			float divergenceL2 = 0.0f;		//!< Root mean square divergence of fluid voxels after projection.
+			float divergenceMax = 0.0f;		//!< Maximum absolute divergence after projection.
+			float mass = 0.0f;				//!< Sum of density.
+			float maxVelocity = 0.0f;		//!< Maximum velocity magnitude [voxels per time unit].
+			float cfl = 0.0f;				//!< Courant number, voxels travelled by fastest voxel in time step.
+			unsigned int activeVoxels = 0;	//!< Voxels with density above threshold.
+			unsigned int fluidVoxels = 0;	//!< Voxels not occupied by obstacles.
+			uint64_t readCount = 0;			//!< Number of results read so far, changes when values are updated.
+		};
+
+		/// \param latency Number of result slots, frames result can be in flight.
+		SimulationStatistics(unsigned int latency = 3);
+		~SimulationStatistics();
+
+		/// \brief	Reduces simulation volumes, step is skipped while result
+		///			slot is still in flight.
+		///
+		/// \param velocity Projected velocity volume image.
+		/// \param obstacle Obstacle volume image.
+		/// \param density Density volume image.
+		/// \param gridSize Simulation grid size.
+		/// \param deltaTime Time step of simulation step.
+		void compute(const Image3D& velocity, const Image3D& obstacle, const Image3D& density, const glm::uvec3& gridSize, float deltaTime);
+
+		/// \brief	Reads results of finished reductions. Never blocks.
+		void update();
+
+		/// \brief	Latest counters read back.
+		const Values& getValues() const { return mValues; }
+
+	public:
+		float activeThreshold = 1e-3f;		//!< Density above which voxel is counted as active.
+
+	private:
+		/// \brief	Reduced counters, std430 layout of reduce_stats.comp.
+		struct Partial
+		{
+			float divergenceSquared;
+			float divergenceMax;
+			float mass;
+			float velocityMax;
+			uint32_t activeVoxels;
+			uint32_t fluidVoxels;
+			uint32_t padding[2];
+		};
+
+		/// \brief	Grows partial results buffer to hold given number of work groups.
+		void reservePartials(GLuint count);
+
+	private:
+		GLuint mPartialBuffer;				//!< Partial results of first pass work groups.
+		GLuint mPartialCapacity;			//!< Number of partial results buffer holds.
+
+		GLuint mResultBuffer;				//!< Result slots.
+		const Partial* mMappedResults;		//!< Persistently mapped result slots.
+
+		unsigned int mSlot;					//!< Slot written by next reduction.
+		std::vector<GLsync> mFences;		//!< Fences of slots in flight.
+		std::vector<float> mTimeSteps;		//!< Time steps of slots in flight.
+
+		Values mValues;
+	};
+}
@@ -7,7 +7,7 @@ namespace vfx
 	class Sphere : public Obstacle
 	{
 	public:
-		Sphere(const std::shared_ptr<Image3D>& volume, const glm::vec3& workGroupSize);
+		Sphere(IComputeDevice& device, const std::shared_ptr<IVolume>& volume);
 		virtual ~Sphere();
 
 		void bindProperties() const override;
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "GL/glew.h"
+#include <vector>
+
+namespace vfx
+{
+	/// \brief	Pre-integrated lookup tables used by volume ray marching.
+	///
+	///			Radiance table is 2D texture indexed by temperature at front
+	///			and back of ray segment, storing average density colour
+	///			attenuation over the segment. Transmittance table is 1D texture
+	///			indexed by optical length (density * step) of the segment.
+	///			Tables are regenerated only when their parameters change.
+	class TransferFunction
+	{
+	public:
+		TransferFunction(unsigned int resolution = 256);
+		~TransferFunction();
+
+		/// \brief	Regenerates lookup tables if parameters have changed.
+		///
+		/// \param radianceFallOff Radiance colour fall off.
+		/// \param absorbtion Light absorbtion factor.
+		void update(float radianceFallOff, float absorbtion);
+
+		/// \brief	Binds lookup tables.
+		///
+		/// \param radianceUnit Texture unit of radiance table.
+		/// \param transmittanceUnit Texture unit of transmittance table.
+		void bind(int radianceUnit, int transmittanceUnit) const;
+
+		/// \brief	Scale mapping temperature to radiance table coordinate.
+		float getTemperatureScale() const { return 1.0f / mMaxTemperature; }
+
+		/// \brief	Scale mapping optical length to transmittance table coordinate.
+		float getOpticalLengthScale() const { return 1.0f / mMaxOpticalLength; }
+
+	private:
+		void generateRadianceTable();
+		void generateTransmittanceTable();
+
+		/// \brief Creates texture object with linear filtering and edge clamping.
+		///
+		/// \param handle Texture handle.
+		/// \param target Texture target.
+		void createTexture(GLuint& handle, GLenum target) const;
+
+	private:
+		unsigned int mResolution;		//!< Number of texels of tables along each axis.
+
+		float mFallOff = -1.0f;			//!< Radiance fall off tables were generated for.
+		float mAbsorbtion = -1.0f;		//!< Absorbtion tables were generated for.
+		float mMaxTemperature = 1.0f;	//!< Temperature mapped to the last texel.
+		float mMaxOpticalLength = 1.0f;	//!< Optical length mapped to the last texel.
+
+		GLuint mRadianceTable;			//!< 2D pre-integrated radiance table.
+		GLuint mTransmittanceTable;		//!< 1D transmittance table.
+	};
+}
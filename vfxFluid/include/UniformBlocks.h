@@ -0,0 +1,95 @@
+#pragma once
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/mat4x4.hpp>
+
+namespace vfx
+{
+	/// \brief	Parameter blocks of simulation and rendering pipelines.
+	///
+	///			Structures mirror std140 uniform blocks declared by shaders,
+	///			vec3 members are followed by scalar filling their fourth component.
+	///			Blocks are uploaded through system::Renderer uniform ring buffer.
+
+	/// \brief	Uniform block binding point of pipeline parameters.
+	const unsigned int PARAMETERS_BINDING = 0;
+
+	/// \brief	buoyancy.comp parameters
+	struct BuoyancyParameters
+	{
+		glm::vec3 direction;			//!< Buoyancy force direction.
+		float ambientTemperature;		//!< Temperature of surrounding air.
+		float deltaTime;				//!< Simulation time step.
+		float strength;					//!< Temperature lift factor.
+		float weight;					//!< Density weight factor.
+		float padding;
+	};
+
+	/// \brief	confinement.comp parameters
+	struct ConfinementParameters
+	{
+		float deltaTime;				//!< Simulation time step.
+		float strength;					//!< Vorticity confinement strength.
+		float padding[2];
+	};
+
+	/// \brief	advect_*.comp and advect_mc_*.comp parameters
+	struct AdvectionParameters
+	{
+		float deltaTime;				//!< Simulation time step, negative for backward advection.
+		float dissipation;				//!< Quantity dissipation.
+		float decay;					//!< Quantity decay.
+		float padding;
+	};
+
+	/// \brief	shadows.comp parameters
+	struct ShadowParameters
+	{
+		glm::vec3 lightPosition;		//!< Light position in texture space.
+		float step;						//!< Ray marching step.
+		float absorbtion;				//!< Light absorbtion factor.
+		float jitter;					//!< Ray start jitter.
+		float factor;					//!< Density factor.
+		float lightIntensity;			//!< Light intensity.
+	};
+
+	/// \brief	occupancy.comp parameters
+	struct OccupancyParameters
+	{
+		int brickSize;					//!< Size of occupancy brick in voxels.
+		int padding[3];
+	};
+
+	/// \brief	raytracing.frag parameters
+	struct RayTracingParameters
+	{
+		glm::mat4 invModelViewProjMatrix;
+		glm::vec3 lightColor;
+		float lightIntensity;
+		glm::vec3 lightDirection;		//!< Deep opacity map light space basis.
+		float jitter;
+		glm::vec3 lightTangent;
+		float stepSize;
+		glm::vec3 lightBitangent;
+		float scatteringIntensity;
+		glm::vec2 framebufferSize;
+		int samples;
+		int domainDebugMode;
+		float minStepScale;
+		float maxStepScale;
+		float gradientThreshold;
+		float transmittanceStepGrowth;
+		int brickSize;					//!< Size of occupancy brick in voxels.
+		float densityCoefficient;
+		float temperatureScale;
+		float opticalLengthScale;
+	};
+
+	static_assert(sizeof(BuoyancyParameters) == 32, "BuoyancyParameters does not match std140 layout");
+	static_assert(sizeof(ConfinementParameters) == 16, "ConfinementParameters does not match std140 layout");
+	static_assert(sizeof(AdvectionParameters) == 16, "AdvectionParameters does not match std140 layout");
+	static_assert(sizeof(ShadowParameters) == 32, "ShadowParameters does not match std140 layout");
+	static_assert(sizeof(OccupancyParameters) == 16, "OccupancyParameters does not match std140 layout");
+	static_assert(sizeof(RayTracingParameters) == 176, "RayTracingParameters does not match std140 layout");
+}
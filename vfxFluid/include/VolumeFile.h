@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Half.h"
+
+#include "glm/vec3.hpp"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace vfx
+{
+	/// \brief	Volume exported from simulation.
+	///
+	///			Voxels are stored as 32-bit floats, channels interleaved,
+	///			x coordinate changing fastest.
+	struct Volume
+	{
+		glm::uvec3 size = glm::uvec3(0);	//!< Volume dimensions.
+		uint32_t channels = 0;				//!< Number of channels per voxel.
+		std::vector<float> data;			//!< Voxel data.
+
+		/// \brief	Voxel channel accessor.
+		float at(uint32_t x, uint32_t y, uint32_t z, uint32_t channel = 0) const
+		{
+			return data[((static_cast<size_t>(z) * size.y + y) * size.x + x) * channels + channel];
+		}
+	};
+
+	/// \brief	Format of voxel data in volume file.
+	enum class VoxelFormat : uint32_t
+	{
+		Float32 = 0,	//!< 32-bit floats.
+		Float16 = 1		//!< Halves, layout of 16F textures.
+	};
+
+	/// \brief	Binary volume file reader & writer.
+	///
+	///			File layout: magic "VFXV", format version, width, height, depth,
+	///			number of channels, voxel format (all 32-bit unsigned) followed
+	///			by voxel data. Version 1 files have no voxel format and store
+	///			floats. Does not depend on OpenGL, so volumes can be processed
+	///			on machines without GPU.
+	class VolumeFile
+	{
+	public:
+		/// \brief	Writes volume to file.
+		///
+		/// \param filename Output file path.
+		/// \param volume Volume to be written.
+		/// \param format Format of written voxels, halves take half of the space.
+		/// \return True if volume has been written.
+		static bool write(const std::string& filename, const Volume& volume, VoxelFormat format = VoxelFormat::Float32);
+
+		/// \brief	Writes half voxels to file without conversion.
+		///
+		/// \param filename Output file path.
+		/// \param size Volume dimensions.
+		/// \param channels Number of channels per voxel.
+		/// \param data Voxel data, channels interleaved.
+		/// \return True if volume has been written.
+		static bool write(const std::string& filename, const glm::uvec3& size, uint32_t channels, const std::vector<Half>& data);
+
+		/// \brief	Reads volume from file, halves are converted to floats.
+		///
+		/// \param filename Input file path.
+		/// \param volume Volume read from file.
+		/// \return True if volume has been read.
+		static bool read(const std::string& filename, Volume& volume);
+
+	public:
+		static const uint32_t VERSION = 2;	//!< Current format version.
+	};
+}
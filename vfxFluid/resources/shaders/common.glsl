@@ -0,0 +1,30 @@
+/*	Brief:			Common definitions of compute shaders
+ *	Description:	Default values of definitions injected by pipeline variants.
+ *					CHANNELS selects channel count of processed quantity,
+ *					IMAGE_FORMAT is derived from it. LOCAL_SIZE_* define
+ *					work group size.
+ */
+
+#ifndef CHANNELS
+#define CHANNELS 4
+#endif
+
+#ifndef IMAGE_FORMAT
+#if CHANNELS == 1
+#define IMAGE_FORMAT r16f
+#else
+#define IMAGE_FORMAT rgba16f
+#endif
+#endif
+
+#ifndef LOCAL_SIZE_X
+#define LOCAL_SIZE_X 8
+#endif
+
+#ifndef LOCAL_SIZE_Y
+#define LOCAL_SIZE_Y 8
+#endif
+
+#ifndef LOCAL_SIZE_Z
+#define LOCAL_SIZE_Z 8
+#endif
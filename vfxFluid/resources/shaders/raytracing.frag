@@ -5,41 +5,80 @@ layout (binding = 1) uniform sampler3D opacityImage;
 layout (binding = 2) uniform sampler3D obstacleImage;
 layout (binding = 3) uniform sampler3D temperatureImage;
 layout (binding = 4) uniform sampler2D depthImage;
-layout (binding = 5) uniform sampler3D densityNoBlurImage;
-
-// Light properties
-uniform vec3 lightColor;
-uniform float lightIntensity;
-uniform float lightAbsorbtion;
-
-// Tracing
-uniform float jitter;
-uniform int samples;
-uniform float stepSize;
-uniform vec2 framebufferSize;
-uniform mat4 invModelViewProjMatrix;
-
-// Features
-/* Debug mode rendering flag
- * 0 - supress debug mode
- * 1 - render front faces
- * 2 - render back faces
- * 3 - render view vectors (direction texture)
- */
-uniform int domainDebugMode = 3;	
-uniform int enableShadows;
-uniform int enableRadiance;
-uniform int enableScattering;
-
-// Render properties
-uniform float radianceColorFallOff;
-uniform float densityCoefficient;
+layout (binding = 5) uniform sampler3D scatteringImage;			// Multiple scattered light (light diffusion)
+layout (binding = 6) uniform sampler3D occupancyImage;
+layout (binding = 7) uniform sampler2D radianceTable;			// Pre-integrated radiance attenuation (front, back temperature)
+layout (binding = 8) uniform sampler1D transmittanceTable;		// Transmittance of segment optical length
+layout (binding = 9) uniform sampler2DArray deepOpacityMap;		// Optical length from light at depth layers
+
+// Features, selected per pipeline variant so disabled paths compile out
+#ifndef ENABLE_SHADOWS
+#define ENABLE_SHADOWS 1
+#endif
+
+#ifndef SHADOW_TECHNIQUE
+#define SHADOW_TECHNIQUE 0				// 0 - lighting volume, 1 - deep opacity map
+#endif
+
+#ifndef ENABLE_RADIANCE
+#define ENABLE_RADIANCE 0
+#endif
+
+#ifndef ENABLE_SCATTERING
+#define ENABLE_SCATTERING 0
+#endif
+
+#ifndef ENABLE_ADAPTIVE_STEPPING
+#define ENABLE_ADAPTIVE_STEPPING 1
+#endif
+
+// Parameters, layout matches RayTracingParameters
+layout (std140, binding = 0) uniform RayTracingParameters
+{
+	mat4 invModelViewProjMatrix;
+
+	// Light properties
+	vec3 lightColor;
+	float lightIntensity;
+	vec3 lightDirection;			// Deep opacity map light space basis
+	float jitter;
+	vec3 lightTangent;
+	float stepSize;
+	vec3 lightBitangent;
+	float scatteringIntensity;
+
+	// Tracing
+	vec2 framebufferSize;
+	int samples;
+
+	// Features
+	/* Debug mode rendering flag
+	 * 0 - supress debug mode
+	 * 1 - render front faces
+	 * 2 - render back faces
+	 * 3 - render view vectors (direction texture)
+	 */
+	int domainDebugMode;
+
+	// Adaptive stepping
+	float minStepScale;				// Step scale at sharp density boundaries
+	float maxStepScale;				// Step scale in low density regions
+	float gradientThreshold;		// Gradient magnitude considered as sharp boundary
+	float transmittanceStepGrowth;	// Step scale reached when transmittance drops to zero
+	int brickSize;					// Voxels along edge of occupancy brick
+
+	// Render properties
+	float densityCoefficient;
+	float temperatureScale;			// Maps temperature to radiance table coordinate
+	float opticalLengthScale;		// Maps optical length to transmittance table coordinate
+};
 
 out vec4 outputColor;
 
 const float PI = 3.1415926535897932384626433832795;
 const vec3 OBSTACLE_COLOR = vec3(1.0);
 const vec3 AMBIENT_LIGHT = vec3(0.15, 0.15, 0.20);
+const float DOMAIN_RADIUS = 0.86602540378;
 
 // Structures
 struct Ray
@@ -98,9 +137,105 @@ vec4 debugDomain(vec3 front, vec3 back)
 	return vec4(1.0);
 }
 
-vec3 computeLighting(vec3 position, float alpha)
+// Computes occupancy brick containing given position from voxel coordinates, last
+// bricks are partially outside volume when resolution is not multiple of brick size
+ivec3 getBrick(vec3 position)
+{
+	vec3 voxel = position * vec3(textureSize(densityImage, 0));
+	return clamp(ivec3(floor(voxel / float(brickSize))), ivec3(0), textureSize(occupancyImage, 0) - 1);
+}
+
+// Computes distance to the exit point of occupancy brick containing given position
+float distanceToBrickExit(vec3 position, vec3 direction)
+{
+	vec3 brickExtent = float(brickSize) / vec3(textureSize(densityImage, 0));
+	vec3 exitPlane = (vec3(getBrick(position)) + step(vec3(0.0), direction)) * brickExtent;
+	vec3 t = (exitPlane - position) / direction;
+
+	return min(t.x, min(t.y, t.z));
+}
+
+// Computes step size from brick occupancy and accumulated transmittance
+float computeStepSize(vec3 position, vec3 direction, float T)
+{
+#if ENABLE_ADAPTIVE_STEPPING == 0
+	return stepSize;
+#else
+	vec3 occupancy = texelFetch(occupancyImage, getBrick(position), 0).xyz;
+
+	// Obstacle bricks are sampled at base step, thin obstacles are not stepped over
+	if (occupancy.z > 0.2) return stepSize;
+
+	// Steps longer than base one end just behind brick exit, so next brick is
+	// entered and checked for obstacle before anything is skipped
+	float brickExit = max(stepSize, distanceToBrickExit(position, direction) + 0.001);
+
+	// Empty brick, skip it entirely
+	float density = occupancy.x * densityCoefficient;
+	if (density < 0.01) return brickExit;
+
+	// Low density regions are sampled coarsely, sharp boundaries finely
+	float scale = mix(maxStepScale, 1.0, clamp(density, 0.0, 1.0));
+	scale = mix(scale, minStepScale, clamp(occupancy.y * densityCoefficient / gradientThreshold, 0.0, 1.0));
+
+	// Contribution of samples decreases with transmittance
+	scale *= mix(transmittanceStepGrowth, 1.0, T);
+
+	return min(stepSize * scale, brickExit);
+#endif
+}
+
+// Maps normalized lookup table value to coordinate of texel centers
+vec2 tableCoordinate(vec2 value, vec2 size)
 {
-	return lightColor * ((enableShadows == 1) ? texture(opacityImage, position).x : (1.0 * lightIntensity)) * alpha * stepSize;
+	return (clamp(value, 0.0, 1.0) * (size - 1.0) + 0.5) / size;
+}
+
+// Average radiance attenuation over segment with given front and back temperature
+float lookupRadiance(float frontTemperature, float backTemperature)
+{
+	vec2 value = abs(vec2(frontTemperature, backTemperature)) * temperatureScale;
+	return texture(radianceTable, tableCoordinate(value, vec2(textureSize(radianceTable, 0)))).x;
+}
+
+// Transmittance of segment with given optical length (density * length)
+float lookupTransmittance(float opticalLength)
+{
+	vec2 value = vec2(opticalLength * opticalLengthScale, 0.0);
+	return texture(transmittanceTable, tableCoordinate(value, vec2(textureSize(transmittanceTable, 0))).x).x;
+}
+
+// Optical length from light to given position interpolated between deep opacity map layers
+float sampleDeepOpacity(vec3 position)
+{
+	vec3 p = position - vec3(0.5);
+	vec2 uv = vec2(dot(p, lightTangent), dot(p, lightBitangent)) / (2.0 * DOMAIN_RADIUS) + 0.5;
+
+	float layers = float(textureSize(deepOpacityMap, 0).z);
+	float layer = (DOMAIN_RADIUS - dot(p, lightDirection)) / (2.0 * DOMAIN_RADIUS) * layers - 1.0;
+	float frontLayer = floor(layer);
+
+	float front = (frontLayer < 0.0) ? 0.0 : texture(deepOpacityMap, vec3(uv, frontLayer)).x;
+	float back = texture(deepOpacityMap, vec3(uv, min(frontLayer + 1.0, layers - 1.0))).x;
+
+	return mix(front, back, layer - frontLayer);
+}
+
+// Light intensity reaching given position
+float computeShadow(vec3 position)
+{
+#if ENABLE_SHADOWS == 0
+	return lightIntensity;
+#elif SHADOW_TECHNIQUE == 1
+	return lookupTransmittance(sampleDeepOpacity(position)) * lightIntensity;
+#else
+	return texture(opacityImage, position).x;
+#endif
+}
+
+vec3 computeLighting(vec3 position, float alpha, float dt)
+{
+	return lightColor * computeShadow(position) * alpha * dt;
 }
 
 bool isTextureCoordinateValid(vec3 tc)
@@ -141,16 +276,22 @@ void main()
 		float T = 1.0;
 		vec3 T0 = AMBIENT_LIGHT;
 
+		// Samples at front of current segment
+		float frontDensity = 0.0;
+		float frontTemperature = 0.0;
+
 		vec3 rayDirection = normalize(end - start);
 		float remainingRayDistance = distance(end, start);
-		vec3 step = stepSize * rayDirection;
 
-		for(int i = 0; i < samples && remainingRayDistance > 0.0; ++i, remainingRayDistance -= stepSize)
+		for(int i = 0; i < samples && remainingRayDistance > 0.0; ++i)
 		{
-			textureCoordinate += step;
+			float dt = computeStepSize(textureCoordinate, rayDirection, T);
+			remainingRayDistance -= dt;
+
+			textureCoordinate += dt * rayDirection;
 			if(!isTextureCoordinateValid(textureCoordinate)) break;
 
-			vec3 lightSample = computeLighting(textureCoordinate, T);
+			vec3 lightSample = computeLighting(textureCoordinate, T, dt);
 
 			if (texture(obstacleImage, textureCoordinate).x > 0.2)
 			{
@@ -161,21 +302,29 @@ void main()
 
 			vec4 density = texture(densityImage, textureCoordinate) * densityCoefficient;
 			float totalDensity = density.x + density.y + density.z;
-
-			if (totalDensity < 0.01) continue;
-
 			float temperature = texture(temperatureImage, textureCoordinate).x;
 
-			if(enableScattering == 1)
+			// Sample is front of next segment even if current segment is empty
+			if (totalDensity < 0.01 && frontDensity < 0.01)
 			{
-				vec3 densityNoBlurSample = texture(densityNoBlurImage, textureCoordinate).xyz * densityCoefficient;
-				density.xyz *= densityNoBlurSample;
+				frontDensity = totalDensity;
+				frontTemperature = temperature;
+				continue;
 			}
-				
-			if(enableRadiance == 1) density.xyz = mix(density.xyz, vec3(0.0) , exp(-temperature*temperature/radianceColorFallOff));
+
+#if ENABLE_RADIANCE == 1
+			density.xyz *= lookupRadiance(frontTemperature, temperature);
+#endif
+
+#if ENABLE_SCATTERING == 1
+			lightSample += lightColor * scatteringIntensity * texture(scatteringImage, textureCoordinate).x * T * dt;
+#endif
 
 			T0 += lightSample * density.xyz;
-			T *= exp(-totalDensity * stepSize * lightAbsorbtion);
+			T *= lookupTransmittance(0.5 * (frontDensity + totalDensity) * dt);
+
+			frontDensity = totalDensity;
+			frontTemperature = temperature;
 
 			if (T < 0.01) break;
 
@@ -1,8 +0,0 @@
-#version 450
-
-layout(location = 0) in vec4 in_vertex_position;
-
-void main()
-{
-	gl_Position = in_vertex_position;
-}
\ No newline at end of file
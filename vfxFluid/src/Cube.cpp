@@ -1,12 +1,11 @@
 #include "Cube.h"
 
-#include "Image3D.h"
-#include "vfxEngine.h"
+#include "IComputeDevice.h"
 
 namespace vfx
 {
-	Cube::Cube(const std::shared_ptr<Image3D>& volume, const glm::vec3& workGroupSize)
-		: Obstacle(volume, system::Renderer::getInstance().getPipelineByName("ObstacleBoxFill"), workGroupSize)
+	Cube::Cube(IComputeDevice& device, const std::shared_ptr<IVolume>& volume)
+		: Obstacle(device, volume, "ObstacleBoxFill")
 		, extent(0.2f)
 	{
 
@@ -18,8 +17,8 @@ namespace vfx
 
 	void Cube::bindProperties() const
 	{
-		mPipeline->SetUniform("boxPosition", position);
-		mPipeline->SetUniform("boxExtent", glm::vec3(extent));
+		mDevice.setUniform("boxPosition", position);
+		mDevice.setUniform("boxExtent", glm::vec3(extent));
 	}
 
 	void Cube::reset()
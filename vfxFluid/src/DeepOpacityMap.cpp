@@ -0,0 +1,72 @@
+#include "DeepOpacityMap.h"
+#include "Image3D.h"
+#include "vfxEngine.h"
+
+#include <glm/geometric.hpp>
+#include <cmath>
+
+namespace vfx
+{
+	DeepOpacityMap::DeepOpacityMap(unsigned int resolution, unsigned int layers)
+		: mResolution(resolution)
+		, mLayers(layers)
+		, mLightDirection(0.0f, 1.0f, 0.0f)
+		, mLightTangent(1.0f, 0.0f, 0.0f)
+		, mLightBitangent(0.0f, 0.0f, 1.0f)
+	{
+		assert(resolution > 0 && layers > 0);
+
+		GL_CHECK(glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &mObjectID));
+		GL_CHECK(glTextureStorage3D(mObjectID, 1, GL_R16F, mResolution, mResolution, mLayers));
+		GL_CHECK(glTextureParameteri(mObjectID, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+		GL_CHECK(glTextureParameteri(mObjectID, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+		GL_CHECK(glTextureParameteri(mObjectID, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+		GL_CHECK(glTextureParameteri(mObjectID, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+
+		LOG_INFO("DeepOpacityMap - Created " + std::to_string(mResolution) + "x" + std::to_string(mResolution) + " map with " + std::to_string(mLayers) + " layers");
+	}
+
+	DeepOpacityMap::~DeepOpacityMap()
+	{
+		StateCache::getInstance().deleteTextures(1, &mObjectID);
+	}
+
+	void DeepOpacityMap::update(const Image3D& density, const Image3D& obstacle, const glm::vec3& lightPosition, float step, float jitter, float factor)
+	{
+		// Light is treated as directional from domain center
+		glm::vec3 toLight = lightPosition - glm::vec3(0.5f);
+		mLightDirection = glm::length(toLight) > 0.0f ? glm::normalize(toLight) : glm::vec3(0.0f, 1.0f, 0.0f);
+
+		glm::vec3 up = std::abs(mLightDirection.y) < 0.99f ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
+		mLightTangent = glm::normalize(glm::cross(up, mLightDirection));
+		mLightBitangent = glm::cross(mLightDirection, mLightTangent);
+
+		auto pipeline = system::Renderer::getInstance().getPipelineByName("deepOpacity").get();
+
+		pipeline->Bind();
+		pipeline->SetUniform("lightDirection", mLightDirection);
+		pipeline->SetUniform("lightTangent", mLightTangent);
+		pipeline->SetUniform("lightBitangent", mLightBitangent);
+		pipeline->SetUniform("step", step);
+		pipeline->SetUniform("jitter", jitter);
+		pipeline->SetUniform("factor", factor);
+
+		StateCache::getInstance().bindTexture(0, density.getObjectID());
+
+		StateCache::getInstance().bindTexture(1, obstacle.getObjectID());
+
+		StateCache::getInstance().bindImageTexture(0, mObjectID, 0, GL_TRUE, 0, GL_WRITE_ONLY, GL_R16F);
+
+		GLuint dispatchSize = (mResolution + 7) / 8;
+
+		glDispatchCompute(dispatchSize, dispatchSize, 1);
+		glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+
+		pipeline->Unbind();
+	}
+
+	void DeepOpacityMap::bind(int textureUnit) const
+	{
+		StateCache::getInstance().bindTexture(textureUnit, mObjectID);
+	}
+}
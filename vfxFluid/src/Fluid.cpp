@@ -1,685 +1,774 @@
-#include "Fluid.h"
-
-#include "glm/gtc/random.hpp"
-#include "glm/gtx/color_space.hpp"
-
-// Obstacles
-#include "Cube.h"
-#include "Sphere.h"
-#include "NoObstacle.h"
-
-// Advection algorithms
-#include "SemiLagrangian.h"
-#include "MacCormack.h"
-
-// Injection algorithms
-#include "TempInjection.h"
-#include "VelocityInjection.h"
-#include "DensityInjection.h"
-
-#include "Image3D.h"
-#include "Quantity.h"
-#include "vfxEngine.h"
-
-//#define PROFILE
-#include "Profiler.h"
-
+#include "Fluid.h"
+
+#include "glm/gtc/random.hpp"
+#include "glm/gtx/color_space.hpp"
+
+#include "FluidSimulation.h"
+#include "Image3D.h"
+#include "Half.h"
+#include "VolumeFile.h"
+#include "GLComputeDevice.h"
+#include "Quantity.h"
+#include "TransferFunction.h"
+#include "DeepOpacityMap.h"
+#include "LightDiffusion.h"
+#include "UniformBlocks.h"
+#include "vfxEngine.h"
+
+//#define PROFILE
+#include "Profiler.h"
+
 int gcd(int a, int b)
 {
 	return b == 0 ? a : gcd(b, a % b);
-}
-
-#if defined(PROFILE)
-#define BEGIN_QUERY(stage) profile::Profiler::beginQuery(stage);
-#define END_QUERY profile::Profiler::endQuery();
-#else
-#define BEGIN_QUERY(stage)
-#define END_QUERY
-#endif
-
-namespace vfx
-{
-	Fluid::Fluid()
-		: mVolumeResolution(128, 128, 128)
-		, mWorkGroupSize(8, 8, 8)
-		, mDispatchSize(mVolumeResolution/mWorkGroupSize)
-		, scale(100.0f)
-	{
-	}
-
-	Fluid::~Fluid()
-	{
+}
+
+// Stages are timed in all builds, results are read frames later without stalling
+#define BEGIN_QUERY(stage) TimestampScope profileScope(system::Renderer::getInstance().getTimestampQueries(), profile::to_string(stage));
+#define END_QUERY profileScope.end();
+
+namespace vfx
+{
+	namespace
+	{
+		/// \brief Rendering passes access volumes of GL device as images.
+		Image3D& image(const IVolume& volume)
+		{
+			return GLComputeDevice::getImage(volume);
+		}
+
+		// Pipelines are compiled asynchronously, simulation and rendering start
+		// once all pipelines they dispatch are linked
+		const char* const SIMULATION_PIPELINES[] = { "advect1D", "advect4D", "advectMC41D", "advectMC4D", "injection1D", "injection4D", "injectionVelocity",
+													 "buoyancy", "vorticity", "confinement", "divergence", "jacobi", "projection", "clear",
+													 "reduceStats", "reduceStatsFinal" };
+
+		const char* const RENDER_PIPELINES[] = { "blur", "blurRecursive", "occupancy", "shadows", "deepOpacity", "scatteringSource", "scatteringDiffuse",
+												 "scatteringUpsample", "raytracing" };
+
+		/// \brief Returns true if all pipelines are linked, never blocks.
+		template<size_t N>
+		bool arePipelinesReady(const char* const (&pipelines)[N])
+		{
+			bool ready = true;
+
+			// Every pipeline is checked, completed ones are finished right away
+			for (const char* pipeline : pipelines)
+				ready = system::Renderer::getInstance().isPipelineReady(pipeline) && ready;
+
+			return ready;
+		}
+	}
+
+	Fluid::Fluid()
+		: mVolumeResolution(128, 128, 128)
+		, mWorkGroupSize(8, 8, 8)
+		, mGridSize(mVolumeResolution)
+		, scale(100.0f)
+		, mDevice(std::make_unique<GLComputeDevice>())
+	{
+		// Simulation stages run on GL device, rendering reads its volumes
+		mSimulation = std::make_unique<FluidSimulation>(*mDevice);
+	}
+
+	Fluid::~Fluid()
+	{
 	}
 
 	void Fluid::Initialize(const glm::vec3& resolution)
 	{
-		mInjectionProps.push_back(InjectionProperties());
-
-		// Load pipelines
-		system::Renderer::getInstance().createPipelines();
-		LOG_INFO("Fluid - Successfully created pipelines");
-
-		// Create quad for rendering
+		// Load pipelines
+		system::Renderer::getInstance().createPipelines("shaders", true);
+		LOG_INFO("Fluid - Submitted pipelines, simulation and rendering start once uncached ones are compiled");
+
+		// Create quad for rendering
 		mRenderQuad = std::make_unique<gfx::Quad>();
 		mRenderQuad->initialize();
 		LOG_INFO("Fluid - Created fullscreen quad for rendering");
 
+		// Create lookup tables for ray marching
+		mTransferFunction = std::make_unique<TransferFunction>();
+		LOG_INFO("Fluid - Created transfer function lookup tables");
+
+		// Partial results are sized on first reduction
+		mStatistics = std::make_unique<SimulationStatistics>();
+
+		prepareSimulationGraph();
 		resize(static_cast<glm::ivec3>(resolution));
 
-#if defined PROFILE
-		profile::Profiler::loadProfilingData("config.json");
-		updateSettings();
+#if defined PROFILE
+		profile::Profiler::loadProfilingData("config.json");
+		applySettings(profile::Profiler::getSettings());
 #endif
-	}
-
-	void Fluid::prepareDefaultQuantities()
-	{
-		Image3D::createBlurTempTargets(glm::vec3(mVolumeResolution));
-
-		mTemperature = std::make_shared<vfx::Quantity>(mVolumeResolution, 1);
-		mTemperature->setProperty<float>("dissipation", 0.001f);
-		mTemperature->setProperty<float>("decay", 0.03f);
-		mTemperature->setInjection(std::make_shared<vfx::TempInjection>());
-
-		LOG_INFO("Fluid - Temperature volumes have been set up");
-
-		mVelocity = std::make_shared<vfx::Quantity>(mVolumeResolution, 4);
-		mVelocity->setProperty<float>("dissipation", 0.001f);
-		mVelocity->setInjection(std::make_shared<vfx::VelocityInjection>());
-
-		LOG_INFO("Fluid - Velocity volumes have been set up");
-
-		mDensity = std::make_shared<vfx::Quantity>(mVolumeResolution, 4);
-		mDensity->setProperty<float>("dissipation", 0.001f);
-		mDensity->setProperty<float>("decay", 0.03f);
-		mDensity->setInjection(std::make_shared<vfx::DensityInjection>());
-
-		LOG_INFO("Fluid - Density volumes have been set up");
-
-		mPressure = std::make_unique<vfx::Quantity>(mVolumeResolution, 1);
-
-		LOG_INFO("Fluid - Pressure volumes have been set up");
-
-		mVelocity->ping()->clear();
-		mTemperature->ping()->clear();
-		mDensity->ping()->clear();
-		// presure is cleared by default when invoked jacobi
-		LOG_INFO("Fluid - Cleared source volume images");
-	}
-
-	void Fluid::reset()
-	{
-		if (!mIsInitialized)
-			return;
-
-		mVelocity->reset();
-		mDensity->reset();
-		mTemperature->reset();
-		mPressure->reset();
-		mDivergenceImage->reset();
-		mVorticityImage->reset();
-		mObstacleImage->reset();
-		mLightingImage->reset();
-
-		for (auto& obstacle : mObstacles)
-		{
-			obstacle->reset();
-		}
-
-		LOG_INFO("Fluid - Resetted images, quantities, obstacles");
-	}
-
-	void Fluid::prepareObstacles()
-	{
-		mObstacles.clear();
-		mObstacleImage = std::make_shared<vfx::Image3D>(mVolumeResolution, true, GL_R8);
-
-		mObstacles.push_back(std::make_unique<NoObstacle>(mObstacleImage, mWorkGroupSize));
-		mObstacles.push_back(std::make_unique<Sphere>(mObstacleImage, mWorkGroupSize));
-		mObstacles.push_back(std::make_unique<Cube>(mObstacleImage, mWorkGroupSize));
-
-		mObstacles[mActiveObstacleIndex]->fill();
-
-		LOG_INFO("Fluid - Obstacles has been created in order:  0 - Boundary, 1 - Sphere, 2- Box");
-	}
-
-	void Fluid::updateSettings()
-	{
-		auto testData = profile::Profiler::getSettings();
-
-		features.radianceEnabled = testData.radiance;
-		features.scatteringEnabled = testData.scattering;
-		features.shadowsEnabled = testData.shadows;
-		changeObstacle(testData.obstacle ? 1 : 0);
-
-		blurFeatures.densityBlurEnabled = testData.blurDensity;
-		blurFeatures.obstacleBlurEnabled = testData.blurObstacle;
-		blurFeatures.shadowsBlurEnabled = testData.blurShadows;
-		blurFeatures.radianceBlurEnabled = testData.blurTemperature;
-		blurFeatures.densityBlurFactor = testData.blurDensityFactor;
-		blurFeatures.radianceBlurFactor = testData.blurTemperatureFactor;
-		blurFeatures.shadowsBlurFactor = testData.blurShadowsFactor;
-		blurFeatures.obstacleBlurFactor = testData.blurObstacleFactor;
-
-		shadowsSamples = testData.shadowSamples;
+	}
+
+	void Fluid::reset()
+	{
+		if (!mIsInitialized)
+			return;
+
+		mSimulation->reset();
+		mOccupancyImage->reset();
+
+		if (mLightingImage) mLightingImage->reset();
+
+		LOG_INFO("Fluid - Resetted images, quantities, obstacles");
+	}
+
+	bool Fluid::exportVolumes(const std::string& prefix) const
+	{
+		if (!mIsInitialized)
+			return false;
+
+		// Quantities are 16F images, halves are written without conversion.
+		// Readback stays on GL thread, files are written by jobs in parallel
+		const Image3D& densityImage = image(*mSimulation->getDensity().ping());
+		const Image3D& temperatureImage = image(*mSimulation->getTemperature().ping());
+
+		std::vector<Half> density, temperature;
+		densityImage.readback(density);
+		temperatureImage.readback(temperature);
+
+		bool densityExported = false;
+		bool temperatureExported = false;
+
+		auto& jobs = system::JobSystem::getInstance();
+		system::JobCounter counter;
+
+		jobs.run([&]()
+		{
+			densityExported = VolumeFile::write(prefix + "_density.vfxv", glm::uvec3(densityImage.getSize()), densityImage.getChannels(), density);
+		}, counter, "export density");
+
+		jobs.run([&]()
+		{
+			temperatureExported = VolumeFile::write(prefix + "_temperature.vfxv", glm::uvec3(temperatureImage.getSize()), temperatureImage.getChannels(), temperature);
+		}, counter, "export temperature");
+
+		jobs.wait(counter);
+
+		if (densityExported && temperatureExported)
+			LOG_INFO("Fluid - Exported volumes: " + prefix);
+		else
+			LOG_ERROR("Fluid - Failed to export volumes: " + prefix);
+
+		return densityExported && temperatureExported;
+	}
+
+	void Fluid::benchmarkBlur() const
+	{
+		if (!mIsInitialized)
+			return;
+
+		const unsigned int kernelSizes[] = { 3, 7, 11, 15, 21, 27, 33 };
+		const BlurMode modes[] = { BlurMode::Separable, BlurMode::Recursive };
+		const unsigned int repetitions = 8;
+
+		GLuint query;
+		GL_CHECK(glGenQueries(1, &query));
+
+		for (auto size : kernelSizes)
+		{
+			// Kernel covers three standard deviations on each side
+			float sigma = size / 6.0f;
+			std::string result = "Fluid - Blur benchmark, kernel size " + std::to_string(size) + ":";
+
+			for (auto mode : modes)
+			{
+				// Warm up, creates kernel buffer and blurred image
+				image(*mSimulation->getDensity().ping()).blur(sigma, size, mode);
+
+				GL_CHECK(glBeginQuery(GL_TIME_ELAPSED, query));
+				for (unsigned int i = 0; i < repetitions; ++i)
+					image(*mSimulation->getDensity().ping()).blur(sigma, size, mode);
+				GL_CHECK(glEndQuery(GL_TIME_ELAPSED));
+
+				GLuint64 elapsed = 0;
+				GL_CHECK(glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed));
+
+				float milliseconds = elapsed / (repetitions * 1000000.0f);
+				result += (mode == BlurMode::Separable ? " separable " : " recursive ") + std::to_string(milliseconds) + " ms";
+			}
+
+			LOG_INFO(result);
+		}
+
+		GL_CHECK(glDeleteQueries(1, &query));
+	}
+
+
+	void Fluid::applySettings(const profile::TestData& testData)
+	{
+		features.radianceEnabled = testData.radiance;
+		features.scatteringEnabled = testData.scattering;
+		features.shadowsEnabled = testData.shadows;
+		changeObstacle(testData.obstacle ? 1 : 0);
+
+		blurFeatures.densityBlurEnabled = testData.blurDensity;
+		blurFeatures.obstacleBlurEnabled = testData.blurObstacle;
+		blurFeatures.shadowsBlurEnabled = testData.blurShadows;
+		blurFeatures.radianceBlurEnabled = testData.blurTemperature;
+		blurFeatures.densityBlurFactor = testData.blurDensityFactor;
+		blurFeatures.radianceBlurFactor = testData.blurTemperatureFactor;
+		blurFeatures.shadowsBlurFactor = testData.blurShadowsFactor;
+		blurFeatures.obstacleBlurFactor = testData.blurObstacleFactor;
+
+		shadowsSamples = testData.shadowSamples;
 		densitySamples = testData.lightingSamples;
-	}
-
-	void Fluid::prepareTextures()
-	{
-		mVorticityImage = std::make_shared<vfx::Image3D>(mVolumeResolution, GL_RGBA16F);
-		mDivergenceImage = std::make_shared<vfx::Image3D>(mVolumeResolution, GL_R16F);
-		mLightingImage = std::make_shared<vfx::Image3D>(mVolumeResolution, GL_R16F);
-
-		LOG_INFO("Fluid - Created stage volumes");
-
-		mSemiLagrangian = std::make_unique<SemiLagrangian>();
-		mMacCormack = std::make_unique<MacCormack>(mVolumeResolution);
-	}
-
-	void Fluid::changeObstacle(unsigned int idx)
-	{
-		assert(idx >= 0 && idx < mObstacles.size());
-
-		Obstacle* obstacle = nullptr;
-
-		obstacle = mObstacles[idx].get();
-		mActiveObstacleIndex = idx;
-			
-		obstacle->fill();
-		LOG_INFO("Fluid - Changed obstacle type to: " + std::to_string(idx));
-	}
-
-	void Fluid::advect(float deltaTime)
+
+		features.statisticsEnabled = testData.statistics;
+	}
+
+	void Fluid::prepareTextures()
+	{
+		// Shadow targets are allocated on first use by selected technique
+		mLightingImage = nullptr;
+		mDeepOpacityMap = nullptr;
+		mLightDiffusion = nullptr;
+
+		// Occupancy bricks are sampled per brick, filtering would blur empty space boundaries
+		glm::uvec3 occupancySize = (static_cast<glm::uvec3>(mVolumeResolution) + glm::uvec3(adaptiveStep.brickSize - 1)) / glm::uvec3(adaptiveStep.brickSize);
+		mOccupancyImage = std::make_shared<vfx::Image3D>(occupancySize, GL_RGBA16F, GL_NEAREST, GL_NEAREST);
+
+		LOG_INFO("Fluid - Created render stage volumes");
+	}
+
+	void Fluid::changeObstacle(unsigned int idx)
+	{
+		mSimulation->changeObstacle(idx);
+		LOG_INFO("Fluid - Changed obstacle type to: " + std::to_string(idx));
+	}
+
+	void Fluid::prepareSimulationGraph()
+	{
+		mSimulationGraph.clear();
+
+		// Stages refer to quantities through this, graph survives resize
+		const unsigned int velocity = mSimulationGraph.addResource("velocity", true);
+		const unsigned int density = mSimulationGraph.addResource("density", true);
+		const unsigned int temperature = mSimulationGraph.addResource("temperature", true);
+		const unsigned int pressure = mSimulationGraph.addResource("pressure", true);
+		const unsigned int obstacle = mSimulationGraph.addResource("obstacle", false);
+		const unsigned int vorticity = mSimulationGraph.addResource("vorticity", false);
+		const unsigned int divergence = mSimulationGraph.addResource("divergence", false);
+
+		mSimulationGraph.addStage("advectVelocity", { velocity, obstacle }, { velocity }, [this](float dt) { advectVelocity(dt); });
+		mSimulationGraph.addStage("advectTemperature", { velocity, obstacle, temperature }, { temperature }, [this](float dt) { advectTemperature(dt); });
+		mSimulationGraph.addStage("advectDensity", { velocity, obstacle, density }, { density }, [this](float dt) { advectDensity(dt); });
+		mSimulationGraph.addStage("injection", { velocity, density, temperature }, { velocity, density, temperature }, [this](float) { inject(mInjectionTimeStep); });
+		mSimulationGraph.addStage("buoyancy", { velocity, temperature, density }, { velocity }, [this](float dt) { computeBuoyancy(dt); });
+		mSimulationGraph.addStage("vorticity", { velocity }, { vorticity }, [this](float) { computeVorticity(); });
+		mSimulationGraph.addStage("confinement", { velocity, vorticity }, { velocity }, [this](float dt) { computeConfinement(dt); });
+		mSimulationGraph.addStage("divergence", { velocity, obstacle }, { divergence }, [this](float) { computeDivergence(); });
+		mSimulationGraph.addStage("pressure", { divergence, obstacle, pressure }, { pressure }, [this](float) { solvePressure(); });
+		mSimulationGraph.addStage("projection", { velocity, obstacle, pressure }, { velocity }, [this](float) { projectAndSubtract(); });
+		mSimulationGraph.addStage("statistics", { velocity, obstacle, density }, {}, [this](float dt) { computeStatistics(dt); });
+	}
+
+	bool Fluid::isSimulationReady() const
+	{
+		return arePipelinesReady(SIMULATION_PIPELINES);
+	}
+
+	void Fluid::simulate(float deltaTime)
+	{
+		simulate(deltaTime, deltaTime);
+	}
+
+	void Fluid::simulate(float deltaTime, float injectionTimeStep)
+	{
+		TRACE_ZONE("fluid simulate");
+
+		if (!arePipelinesReady(SIMULATION_PIPELINES)) return;
+
+		TimestampScope simulationScope(system::Renderer::getInstance().getTimestampQueries(), "simulation");
+
+		applySimulationSettings();
+
+		unsigned int mask = mSimulationGraph.getAllStagesMask();
+		mInjectionTimeStep = injectionTimeStep;
+
+		// Each distinct mask compiles its own schedule once
+		if (!features.injectionEnabled || injectionTimeStep <= 0.0f) mask &= ~mSimulationGraph.getStageMask("injection");
+		if (!features.buoyancyEnabled) mask &= ~mSimulationGraph.getStageMask("buoyancy");
+		if (!features.vorticityEnabled) mask &= ~(mSimulationGraph.getStageMask("vorticity") | mSimulationGraph.getStageMask("confinement"));
+		if (!features.statisticsEnabled) mask &= ~mSimulationGraph.getStageMask("statistics");
+
+		mSimulationGraph.execute(mask, deltaTime);
+	}
+
+	void Fluid::applySimulationSettings()
+	{
+		if (pressure.iterations <= 0)
+		{
+			pressure.iterations = 20;
+			LOG_WARNING("Fluid - Number of solver iterations too low! Used default value: " + std::to_string(pressure.iterations));
+		}
+
+		if (pressure.gradientScale < 0.0f)
+		{
+			pressure.gradientScale = 1.0f;
+			LOG_WARNING("Fluid - Gradient scale during projection stage is less than 0! Used default value: " + std::to_string(pressure.gradientScale));
+		}
+
+		// Stages are culled by simulation graph, features are copied for completeness
+		mSimulation->features = features;
+		mSimulation->buoyancy = buoyancy;
+		mSimulation->vorticity = vorticity;
+		mSimulation->pressure = pressure;
+		mSimulation->useMacCormackAdvection = useMacCormackAdvection;
+	}
+
+	void Fluid::advectVelocity(float deltaTime)
 	{
 		BEGIN_QUERY(profile::SimulationStage::Advection)
+		mSimulation->advectVelocity(deltaTime);
+		END_QUERY
+	}
 
-		// Velocity is advected using Semi-Lagrangian advection
-		mAdvection = mSemiLagrangian.get();
-
-		advect(mVelocity.get(), mVelocity->getProperty<float>("dissipation"), 0, deltaTime);
-
-		mAdvection = useMacCormackAdvection ? mMacCormack.get() : mSemiLagrangian.get();
-		
-		advect(mTemperature.get(), mTemperature->getProperty<float>("dissipation"), mTemperature->getProperty<float>("decay"), deltaTime);
-		advect(mDensity.get(), mDensity->getProperty<float>("dissipation"), mDensity->getProperty<float>("decay"), deltaTime);
+	void Fluid::advectTemperature(float deltaTime)
+	{
+		BEGIN_QUERY(profile::SimulationStage::Advection)
+		mSimulation->advectTemperature(deltaTime);
+		END_QUERY
+	}
 
+	void Fluid::advectDensity(float deltaTime)
+	{
+		BEGIN_QUERY(profile::SimulationStage::Advection)
+		mSimulation->advectDensity(deltaTime);
 		END_QUERY
-	}
-
-	void Fluid::moveObstacle(float x, float y, float z)
-	{
-		mObstacles[mActiveObstacleIndex]->position = glm::vec3(x, y, z);
-		mObstacles[mActiveObstacleIndex]->fill();
-
-		mObstacleHasMoved = true;
 	}
 
+	void Fluid::moveObstacle(float x, float y, float z)
+	{
+		mSimulation->moveObstacle(glm::vec3(x, y, z));
+
+		mObstacleHasMoved = true;
+	}
+
+
 	void Fluid::setTemperatureDissipation(float value)
 	{
-		mVelocity->setProperty<float>("dissipation", value);
+		mSimulation->getVelocity().setProperty<float>("dissipation", value);
 	}
 
 	void Fluid::setDensityDissipation(float value)
 	{
-		mDensity->setProperty<float>("dissipation", value);
+		mSimulation->getDensity().setProperty<float>("dissipation", value);
 	}
 
 	void Fluid::setVelocityDissipation(float value)
 	{
-		mVelocity->setProperty<float>("dissipation", value);
+		mSimulation->getVelocity().setProperty<float>("dissipation", value);
 	}
 
 	void Fluid::setDensityDecay(float value)
 	{
-		mDensity->setProperty<float>("decay", value);
+		mSimulation->getDensity().setProperty<float>("decay", value);
 	}
 
 	void Fluid::setTemperatureDecay(float value)
 	{
-		mTemperature->setProperty<float>("decay", value);
+		mSimulation->getTemperature().setProperty<float>("decay", value);
 	}
 
 	float Fluid::getTemperatureDissipation() const
 	{
-		return mVelocity->getProperty<float>("dissipation");
+		return mSimulation->getVelocity().getProperty<float>("dissipation");
 	}
 
 	float Fluid::getDensityDissipation() const
 	{
-		return mDensity->getProperty<float>("dissipation");
+		return mSimulation->getDensity().getProperty<float>("dissipation");
 	}
 
 	float Fluid::getVelocityDissipation() const
 	{
-		return mVelocity->getProperty<float>("dissipation");
+		return mSimulation->getVelocity().getProperty<float>("dissipation");
 	}
 
 	float Fluid::getDensityDecay() const
 	{
-		return mDensity->getProperty<float>("decay");
+		return mSimulation->getDensity().getProperty<float>("decay");
 	}
 
 	float Fluid::getTemperatureDecay() const
 	{
-		return mTemperature->getProperty<float>("decay");
+		return mSimulation->getTemperature().getProperty<float>("decay");
+	}
+
+	int Fluid::getActiveObtacle() const
+	{
+		return static_cast<int>(mSimulation->getActiveObstacleIndex());
 	}
 
 	glm::vec3 Fluid::getObstaclePosition() const
 	{
-		if (mObstacles.size())
-			return mObstacles[mActiveObstacleIndex]->position;
-		else
-			return glm::vec3(0.0f);
-	}
-
-	void Fluid::advect(vfx::Quantity* quantity, float dissipation, float decay, float deltaTime)
-	{
-		mAdvection->advect(*mObstacleImage, *mVelocity->ping(), *quantity->ping(), *quantity->pong(), dissipation, decay, deltaTime);
-		quantity->swap();
-	}
-
-	void Fluid::inject(float deltaTime)
-	{
-		BEGIN_QUERY(profile::SimulationStage::Injection)
-
-		if (!features.injectionEnabled) return;
-
-		for (const auto& injection : mInjectionProps)
-		{
-			// Inject density
-			mDensity->setProperty<float>("sigma", injection.densitySigma);
-			mDensity->setProperty<float>("intensity", injection.densityIntensity);
-			mDensity->setProperty<glm::vec3>("color", injection.color);
-			mDensity->inject(injection.position, deltaTime);
-
-			// Inject temperature
-			mTemperature->setProperty<float>("sigma", injection.temperatureSigma);
-			mTemperature->setProperty<float>("intensity", injection.temperatureIntensity);
-			mTemperature->inject(injection.position, deltaTime);
-
-			// Inject velocity
-			mVelocity->setProperty<float>("sigma", injection.velocitySigma);
-			mVelocity->setProperty<float>("intensity", injection.velocityIntensity);
-			mVelocity->inject(injection.position, deltaTime);
-		}
-
-		END_QUERY
-	}
-	
-	void Fluid::computeBuoyancy(float deltaTime)
-	{
-		BEGIN_QUERY(profile::SimulationStage::Buoyancy)
-
-		if (!features.buoyancyEnabled) return;
-
-		// Get pipeline, bind it, setup uniforms & images
-		auto pipeline = system::Renderer::getInstance().getPipelineByName("buoyancy");
-		pipeline->Bind();
-		pipeline->SetUniform("ambientTemperature", buoyancy.ambientTemperature);
-		pipeline->SetUniform("deltaTime", deltaTime);
-		pipeline->SetUniform("strength", buoyancy.strength);
-		pipeline->SetUniform("weight", buoyancy.weight);
-		pipeline->SetUniform("direction", buoyancy.direction);
-
-		// Bind velocity image
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_3D, mVelocity->ping()->getObjectID());
-
-		// Bind temperature image
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_3D, mTemperature->ping()->getObjectID());
-
-		// Bind density image
-		glActiveTexture(GL_TEXTURE2);
-		glBindTexture(GL_TEXTURE_3D, mDensity->ping()->getObjectID());
-
-		// Dispatch compute task
-		glBindImageTexture(0, mVelocity->pong()->getObjectID(), 0, GL_TRUE, 0, GL_WRITE_ONLY, mVelocity->pong()->getFormat());
-		glDispatchCompute(mDispatchSize.x, mDispatchSize.y, mDispatchSize.z);
-		glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
-
-		// Swap surfaces
-		mVelocity->swap();
-
-		// Unbind pipeline
-		pipeline->Unbind();
-
-		END_QUERY
+		return mSimulation->getObstaclePosition();
+	}
+
+	std::vector<InjectionProperties>& Fluid::getInjectionProperties()
+	{
+		return mSimulation->injections;
+	}
+
+	void Fluid::inject(float deltaTime)
+	{
+		BEGIN_QUERY(profile::SimulationStage::Injection)
+		mSimulation->inject(deltaTime);
+		END_QUERY
+	}
+
+	void Fluid::computeBuoyancy(float deltaTime)
+	{
+		BEGIN_QUERY(profile::SimulationStage::Buoyancy)
+		mSimulation->computeBuoyancy(deltaTime);
+		END_QUERY
 	}
 
 	void Fluid::computeVorticity()
 	{
 		BEGIN_QUERY(profile::SimulationStage::Vorticity)
+		mSimulation->computeVorticity();
+		END_QUERY
+	}
+
+	void Fluid::computeConfinement(float deltaTime)
+	{
+		BEGIN_QUERY(profile::SimulationStage::Confinement)
+		mSimulation->computeConfinement(deltaTime);
+		END_QUERY
+	}
+
+	void Fluid::computeDivergence()
+	{
+		BEGIN_QUERY(profile::SimulationStage::Divergence)
+		mSimulation->computeDivergence();
+		END_QUERY
+	}
+
+	void Fluid::solvePressure()
+	{
+		BEGIN_QUERY(profile::SimulationStage::Pressure)
+		mSimulation->solvePressure();
+		END_QUERY
+	}
+
+	void Fluid::projectAndSubtract()
+	{
+		BEGIN_QUERY(profile::SimulationStage::SubtractGradient)
+		mSimulation->projectAndSubtract();
+		END_QUERY
+	}
+
+	void Fluid::computeStatistics(float deltaTime)
+	{
+		BEGIN_QUERY(profile::SimulationStage::Statistics)
+
+		// Reduction runs on GL images, statistics are diagnostics of GPU simulation
+		mStatistics->compute(image(*mSimulation->getVelocity().ping()), image(mSimulation->getObstacleVolume()), image(*mSimulation->getDensity().ping()), mGridSize, deltaTime);
+
+
+		END_QUERY
+	}
+
+	const SimulationStatistics::Values& Fluid::getStatistics() const
+	{
+		return mStatistics->getValues();
+	}
+
+	ShadowTechnique Fluid::getShadowTechnique() const
+	{
+		if (shadows.technique != ShadowTechnique::Automatic)
+			return shadows.technique;
+
+		const float maxVolumeShadowResolution = 256.0f;
+
+		if (mVolumeResolution.x > maxVolumeShadowResolution ||
+			mVolumeResolution.y > maxVolumeShadowResolution ||
+			mVolumeResolution.z > maxVolumeShadowResolution)
+		{
+			return ShadowTechnique::DeepOpacityMap;
+		}
+
+		return ShadowTechnique::Volume;
+	}
+
+	void Fluid::computeShadows(float jittering, float sampling, float absorbtion, float factor, const glm::vec3& lightPosition)
+	{
+		if (!features.shadowsEnabled) return;
+
+		BEGIN_QUERY(profile::RenderStage::Shadows)
+
+		if (getShadowTechnique() == ShadowTechnique::DeepOpacityMap)
+		{
+			// Light volume is not needed, release its memory
+			mLightingImage = nullptr;
+
+			if (!mDeepOpacityMap || mDeepOpacityMap->getLayers() != static_cast<unsigned int>(shadows.deepOpacityLayers))
+			{
+				unsigned int resolution = static_cast<unsigned int>(glm::max(mVolumeResolution.x, glm::max(mVolumeResolution.y, mVolumeResolution.z)));
+				mDeepOpacityMap = std::make_unique<DeepOpacityMap>(resolution, shadows.deepOpacityLayers);
+			}
+
+			mDeepOpacityMap->update(image(*mSimulation->getDensity().ping()), image(mSimulation->getObstacleVolume()), lightPosition, sampling, jittering, factor);
+			return;
+		}
+
+		mDeepOpacityMap = nullptr;
+
+		if (!mLightingImage)
+		{
+			mLightingImage = std::make_shared<vfx::Image3D>(mVolumeResolution, GL_R16F);
+			LOG_INFO("Fluid - Created lighting volume");
+		}
+
+		auto gridSize = static_cast<glm::uvec3>(mLightingImage->getSize());
+		auto pipeline = system::Renderer::getInstance().getComputePipeline("shadows", gridSize).get();
+
+		pipeline->Bind();
+
+		ShadowParameters parameters = {};
+		parameters.lightPosition = lightPosition;
+		parameters.step = sampling;
+		parameters.absorbtion = absorbtion;
+		parameters.jitter = jittering;
+		parameters.factor = factor;
+		parameters.lightIntensity = lightIntensityFactor;
+		system::Renderer::getInstance().getUniformBuffer().upload(PARAMETERS_BINDING, parameters);
+
+		StateCache::getInstance().bindTexture(0, image(*mSimulation->getDensity().ping()).getObjectID());
+
+		StateCache::getInstance().bindTexture(1, image(mSimulation->getObstacleVolume()).getObjectID());
+
+		StateCache::getInstance().bindImageTexture(0, mLightingImage->getObjectID(), 0, GL_TRUE, 0, GL_WRITE_ONLY, mLightingImage->getFormat());
+
+		system::Renderer::getInstance().dispatchCompute("shadows", gridSize);
+		glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+		pipeline->Unbind();
+
+		END_QUERY
+	}
+
+	void Fluid::computeOccupancy(bool blurredDensity)
+	{
+		if (!adaptiveStep.enabled) return;
+
+		BEGIN_QUERY(profile::RenderStage::Occupancy)
+
+		auto pipeline = system::Renderer::getInstance().getPipelineByName("occupancy").get();
+
+		pipeline->Bind();
+
+		OccupancyParameters parameters = {};
+		parameters.brickSize = adaptiveStep.brickSize;
+		system::Renderer::getInstance().getUniformBuffer().upload(PARAMETERS_BINDING, parameters);
+
+		StateCache::getInstance().bindTexture(0, (blurredDensity) ? image(*mSimulation->getDensity().ping()).getBlurredObjectID() : image(*mSimulation->getDensity().ping()).getObjectID());
+
+		// Obstacle bricks are never skipped, even before density reaches them
+		StateCache::getInstance().bindTexture(1, getObstacleTextureID());
+
+		StateCache::getInstance().bindImageTexture(0, mOccupancyImage->getObjectID(), 0, GL_TRUE, 0, GL_WRITE_ONLY, mOccupancyImage->getFormat());
+
+		glm::uvec3 dispatchSize = (static_cast<glm::uvec3>(mOccupancyImage->getSize()) + static_cast<glm::uvec3>(mWorkGroupSize) - glm::uvec3(1)) / static_cast<glm::uvec3>(mWorkGroupSize);
+
+		glDispatchCompute(dispatchSize.x, dispatchSize.y, dispatchSize.z);
+		glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
 
-		if (!features.vorticityEnabled) return;
-
-		// Get pipeline, bind it, setup uniforms & images
-		auto pipeline = system::Renderer::getInstance().getPipelineByName("vorticity");
-		pipeline->Bind();
-
-		// Bind velocity image
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_3D, mVelocity->ping()->getObjectID());
-
-		// Dispatch compute task
-		glBindImageTexture(0, mVorticityImage->getObjectID(), 0, GL_TRUE, 0, GL_WRITE_ONLY, mVorticityImage->getFormat());
-		glDispatchCompute(mDispatchSize.x, mDispatchSize.y, mDispatchSize.z);
-		glMemoryBarrier(GL_ALL_BARRIER_BITS);
-
 		pipeline->Unbind();
 
 		END_QUERY
-	}
-
-	void Fluid::computeConfinement(float deltaTime)
-	{
-		BEGIN_QUERY(profile::SimulationStage::Confinement)
-
-		if (!features.vorticityEnabled) return;
-
-		auto pipeline = system::Renderer::getInstance().getPipelineByName("confinement");
-
-		pipeline->Bind();
-		pipeline->SetUniform("deltaTime", deltaTime);
-		pipeline->SetUniform("strength", vorticity.strength);
-
-		// Bind velocity image
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_3D, mVelocity->ping()->getObjectID());
-
-		// Bind vorticity image
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_3D, mVorticityImage->getObjectID());
-
-		// Dispatch compute task
-		glBindImageTexture(0, mVelocity->pong()->getObjectID(), 0, GL_TRUE, 0, GL_WRITE_ONLY, mVelocity->pong()->getFormat());
-		glDispatchCompute(mDispatchSize.x, mDispatchSize.y, mDispatchSize.z);
-		glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
-		mVelocity->swap();
-
-		// Unbind pipeline
-		pipeline->Unbind();
-
-		END_QUERY
-	}
-
-	void Fluid::computeDivergence()
-	{
-		BEGIN_QUERY(profile::SimulationStage::Divergence)
-
-		// Get pipeline, bind it, setup uniforms & images
-		auto pipeline = system::Renderer::getInstance().getPipelineByName("divergence");
-		pipeline->Bind();
-
-		// Bind velocity image
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_3D, mVelocity->ping()->getObjectID());
-
-		// Bind obstacle image
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_3D, mObstacleImage->getObjectID());
-
-		// Dispatch compute task
-		glBindImageTexture(0, mDivergenceImage->getObjectID(), 0, GL_TRUE, 0, GL_WRITE_ONLY, mDivergenceImage->getFormat());
-		glDispatchCompute(mDispatchSize.x, mDispatchSize.y, mDispatchSize.z);
-		glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
-
-		// Unbind pipeline
-		pipeline->Unbind();
-
-		END_QUERY
-	}
-
-	void Fluid::solvePressure()
-	{
-		BEGIN_QUERY(profile::SimulationStage::Pressure)
-
-		if (pressure.iterations <= 0)
-		{
-			pressure.iterations = 20;
-			LOG_WARNING("Fluid - Number of solver iterations too low! Used default value: " + std::to_string(pressure.iterations));
-		}
-			
-		// Clear source texture
-		mPressure->ping()->clear();
-
-		// Get pipeline, bind it, setup uniforms & images
-		auto pipeline = system::Renderer::getInstance().getPipelineByName("jacobi");
-
-		pipeline->Bind();
-
-		// Bind divergence image
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_3D, mDivergenceImage->getObjectID());
-
-		// Bind obstacle image
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_3D, mObstacleImage->getObjectID());
-
-		// Solve pressure by jacobi method, use predefined number of iterations
-		for (int i = 0; i < pressure.iterations; ++i)
-		{
-			// Bind pressure soource texture
-			glActiveTexture(GL_TEXTURE2);
-			glBindTexture(GL_TEXTURE_3D, mPressure->ping()->getObjectID());
-
-			// Dispatch compute task
-			glBindImageTexture(0, mPressure->pong()->getObjectID(), 0, GL_TRUE, 0, GL_WRITE_ONLY, mPressure->pong()->getFormat());
-			glDispatchCompute(mDispatchSize.x, mDispatchSize.y, mDispatchSize.z);
-			glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
-			mPressure->swap();
-		}
-
-		// Unbind pipeline
-		pipeline->Unbind();
-
-		END_QUERY
-	}
-
-	void Fluid::projectAndSubtract()
-	{
-		BEGIN_QUERY(profile::SimulationStage::SubtractGradient)
-
-		if (pressure.gradientScale < 0.0f)
-		{
-			pressure.gradientScale = 1.0f;
-			LOG_WARNING("Fluid - Gradient scale during projection stage is less than 0! Used default value: " + std::to_string(pressure.gradientScale));
-		}
-
-		// Get pipeline, bind it, setup uniforms & images
-		auto pipeline = system::Renderer::getInstance().getPipelineByName("projection");
-
-		pipeline->Bind();
-		pipeline->SetUniform("gradientScale", pressure.gradientScale);
-
-		// Bind velocity image
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_3D, mVelocity->ping()->getObjectID());
-
-		// Bind obstacle image
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_3D, mObstacleImage->getObjectID());
-
-		// Bind pressure image
-		glActiveTexture(GL_TEXTURE2);
-		glBindTexture(GL_TEXTURE_3D, mPressure->ping()->getObjectID());
-
-		// Dispatch compute task
-		glBindImageTexture(0, mVelocity->pong()->getObjectID(), 0, GL_TRUE, 0, GL_WRITE_ONLY, mVelocity->pong()->getFormat());
-		glDispatchCompute(mDispatchSize.x, mDispatchSize.y, mDispatchSize.z);
-		glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
-		pipeline->Unbind();
-
-		// Swap surfaces
-		mVelocity->swap();
-
-		END_QUERY
-	}
-
-	void Fluid::computeShadows(float jittering, float sampling, float absorbtion, float factor, const glm::vec3& lightPosition)
-	{
-		BEGIN_QUERY(profile::RenderStage::Shadows)
-			
-		if (!features.shadowsEnabled) return;
-
-		auto pipeline = system::Renderer::getInstance().getPipelineByName("shadows").get();
-
-		pipeline->Bind();
-
-		pipeline->SetUniform("factor", factor);
-		pipeline->SetUniform("step", sampling);
-		pipeline->SetUniform("lightPosition", lightPosition);
-		pipeline->SetUniform("absorbtion", absorbtion);
-		pipeline->SetUniform("jitter", jittering);
-		pipeline->SetUniform("lightIntensity", lightIntensityFactor);
-
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_3D, mDensity->ping()->getObjectID());
-
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_3D, mObstacleImage->getObjectID());
-
-		glBindImageTexture(0, mLightingImage->getObjectID(), 0, GL_TRUE, 0, GL_WRITE_ONLY, mLightingImage->getFormat());
-
-		glm::uvec3 dispatchSize = static_cast<glm::uvec3>(mLightingImage->getSize() / mWorkGroupSize);
-
-		glDispatchCompute(dispatchSize.x, dispatchSize.y, dispatchSize.z);
-		glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
-
-		pipeline->Unbind();
-
-		END_QUERY
-	}
-
+	}
+
+	unsigned int Fluid::getObstacleTextureID() const
+	{
+		const Image3D& obstacle = image(mSimulation->getObstacleVolume());
+		return (blurFeatures.obstacleBlurEnabled && mSimulation->getActiveObstacleIndex() > 0) ? obstacle.getBlurredObjectID() : obstacle.getObjectID();
+	}
+
+	void Fluid::computeScattering()
+	{
+		if (!features.scatteringEnabled)
+		{
+			mLightDiffusion = nullptr;
+			return;
+		}
+
+		BEGIN_QUERY(profile::RenderStage::Scattering)
+
+		if (!mLightDiffusion || mLightDiffusion->getQuality() != scattering.quality)
+			mLightDiffusion = std::make_unique<LightDiffusion>(static_cast<glm::uvec3>(mVolumeResolution), scattering.quality);
+
+		const bool shadowsEnabled = features.shadowsEnabled;
+		mLightDiffusion->compute(scattering, image(*mSimulation->getDensity().ping()), shadowsEnabled ? mLightingImage.get() : nullptr, shadowsEnabled ? mDeepOpacityMap.get() : nullptr, densityFactor, lightAbsorbtionFactor, lightIntensityFactor);
+
+		END_QUERY
+	}
+
 	void Fluid::resize(const glm::ivec3 & size)
 	{
 		reset();
 
-		mVolumeResolution = size;
-		mDispatchSize = glm::vec3(static_cast<glm::vec3>(size) / mWorkGroupSize);
+		mVolumeResolution = size;
+		mGridSize = static_cast<glm::uvec3>(size);
 
 		LOG_INFO("Fluid - Setting resolution to: " + std::to_string(size.x) + "x" + std::to_string(size.y) + "x" + std::to_string(size.z));
 
-		prepareDefaultQuantities();
-		LOG_INFO("Fluid - Prepared quantities' volumes");
+		// Scratch targets of previous resolution are not needed anymore
+		Image3D::releaseBlurScratch();
+
+		mSimulation->resize(mGridSize);
+		LOG_INFO("Fluid - Prepared quantities, stage volumes and obstacles");
 
 		prepareTextures();
 		LOG_INFO("Fluid - Prepared textures");
 
-		prepareObstacles();
-		LOG_INFO("Fluid - Prepared obstacles");
 
 		mIsInitialized = true;
 	}
 
-	void Fluid::render(float deltaTime, gfx::ICamera* camera)
-	{
-		// Blur obstacle if enabled
-		if (blurFeatures.obstacleBlurEnabled && mActiveObstacleIndex > 0)
-		{
-			BEGIN_QUERY(profile::RenderStage::BlurObstacle)
-			mObstacles[mActiveObstacleIndex]->blur(blurFeatures.obstacleBlurFactor, blurFeatures.blurKernelSize);
-			END_QUERY
-		}
-			
-		// Blur temperature if radiance enabled
-		if (blurFeatures.radianceBlurEnabled)
-		{
-			BEGIN_QUERY(profile::RenderStage::BlurTemperature)
-			mTemperature->blur(blurFeatures.radianceBlurFactor, blurFeatures.blurKernelSize);
-			END_QUERY
-		}
-			
-		// Blur density if enabled
-		if (blurFeatures.densityBlurEnabled || features.scatteringEnabled)
-		{
-			BEGIN_QUERY(profile::RenderStage::BlurDensity)
-			mDensity->blur(blurFeatures.densityBlurFactor, blurFeatures.blurKernelSize);
-			END_QUERY
-		}
-			
-		computeShadows(shadowsJitter, 1.0f / shadowsSamples, lightAbsorbtionFactor, densityFactor, glm::vec3(lightPosition[0], lightPosition[1], lightPosition[2]));
-
-		// Blur shadows if enabled
-		if (blurFeatures.shadowsBlurEnabled)
-		{
-			BEGIN_QUERY(profile::RenderStage::BlurShadows)
-			mLightingImage->blur(blurFeatures.shadowsBlurFactor, blurFeatures.blurKernelSize);
-			END_QUERY
-		}
-			
-		auto pipeline = system::Renderer::getInstance().getPipelineByName("raytracing").get();
-
-		BEGIN_QUERY(profile::RenderStage::RayMarching)
-		pipeline->Bind();
-
-		GLint viewport_size[4];
-		glGetIntegerv(GL_VIEWPORT, viewport_size);
-
-		glm::vec2 viewport_size_f = { viewport_size[2], viewport_size[3] };
-		glm::vec3 lightColor(lightColor[0], lightColor[1], lightColor[2]);
-
-		glm::mat4 modelMatrix = glm::translate(glm::mat4(), position);
-		modelMatrix = glm::scale(modelMatrix, (mVolumeResolution / glm::vec3(gcd(gcd(mVolumeResolution.x, mVolumeResolution.y), mVolumeResolution.z))) * scale);
-
-
-		pipeline->SetUniform("framebufferSize", viewport_size_f);
-		pipeline->SetUniform("invModelViewProjMatrix", glm::inverse(camera->getViewMatrix() * modelMatrix));
-		pipeline->SetUniform("domainDebugMode", domainDebugRenderMode);
-		
-		if (domainDebugRenderMode == 0)
-		{
-			pipeline->SetUniform("stepSize", 1.0f / densitySamples);
-			pipeline->SetUniform("samples", densitySamples);
-			pipeline->SetUniform("jitter", densityJitter);
-			pipeline->SetUniform("lightColor", lightColor);
-			pipeline->SetUniform("lightIntensity", lightIntensityFactor);
-			pipeline->SetUniform("lightAbsorbtion", lightAbsorbtionFactor);
-			pipeline->SetUniform("enableShadows", static_cast<int>(features.shadowsEnabled));
-			pipeline->SetUniform("enableRadiance", static_cast<int>(features.radianceEnabled));
-			pipeline->SetUniform("enableScattering", static_cast<int>(features.scatteringEnabled));
-			pipeline->SetUniform("radianceColorFallOff", falloff);
-			pipeline->SetUniform("densityCoefficient", densityFactor);
-
-			glActiveTexture(GL_TEXTURE0);
-			if (blurFeatures.densityBlurEnabled || features.scatteringEnabled)
-				glBindTexture(GL_TEXTURE_3D, mDensity->ping()->getBlurredObjectID());
-			else
-				glBindTexture(GL_TEXTURE_3D, mDensity->ping()->getObjectID());
-
-			glActiveTexture(GL_TEXTURE1);
-			if (blurFeatures.shadowsBlurEnabled)
-				glBindTexture(GL_TEXTURE_3D, mLightingImage->getBlurredObjectID());
-			else
-				glBindTexture(GL_TEXTURE_3D, mLightingImage->getObjectID());
-
-			glActiveTexture(GL_TEXTURE2);
-			if (blurFeatures.obstacleBlurEnabled && mActiveObstacleIndex > 0)
-				glBindTexture(GL_TEXTURE_3D, mObstacles[mActiveObstacleIndex]->getImage()->getBlurredObjectID());
-			else
-				glBindTexture(GL_TEXTURE_3D, mObstacleImage->getObjectID());
-
-			glActiveTexture(GL_TEXTURE3);
-			glBindTexture(GL_TEXTURE_3D, mTemperature->ping()->getObjectID());
-
-			if (features.scatteringEnabled)
-			{
-				glActiveTexture(GL_TEXTURE5);
-				glBindTexture(GL_TEXTURE_3D, mDensity->ping()->getObjectID());
-			}
-			
-		}
-
-		mRenderQuad->render();
-
-		pipeline->Unbind();
-		END_QUERY
-
+	void Fluid::render(float deltaTime, gfx::ICamera* camera)
+	{
+		TRACE_ZONE("fluid render");
+
+		if (!arePipelinesReady(RENDER_PIPELINES)) return;
+
+		TimestampScope renderScope(system::Renderer::getInstance().getTimestampQueries(), "render");
+
+		// Blur obstacle if enabled
+		if (blurFeatures.obstacleBlurEnabled && mSimulation->getActiveObstacleIndex() > 0)
+		{
+			BEGIN_QUERY(profile::RenderStage::BlurObstacle)
+			image(mSimulation->getObstacleVolume()).blur(blurFeatures.obstacleBlurFactor, blurFeatures.blurKernelSize, blurFeatures.mode);
+			END_QUERY
+		}
+			
+		// Blur temperature if radiance enabled
+		if (blurFeatures.radianceBlurEnabled)
+		{
+			BEGIN_QUERY(profile::RenderStage::BlurTemperature)
+			image(*mSimulation->getTemperature().ping()).blur(blurFeatures.radianceBlurFactor, blurFeatures.blurKernelSize, blurFeatures.mode);
+			END_QUERY
+		}
+			
+		// Blur density if enabled
+		if (blurFeatures.densityBlurEnabled)
+		{
+			BEGIN_QUERY(profile::RenderStage::BlurDensity)
+			image(*mSimulation->getDensity().ping()).blur(blurFeatures.densityBlurFactor, blurFeatures.blurKernelSize, blurFeatures.mode);
+			END_QUERY
+		}
+			
+		computeOccupancy(blurFeatures.densityBlurEnabled);
+
+		computeShadows(shadowsJitter, 1.0f / shadowsSamples, lightAbsorbtionFactor, densityFactor, glm::vec3(lightPosition[0], lightPosition[1], lightPosition[2]));
+
+		// Blur shadows if enabled, only lighting volume is blurred
+		if (blurFeatures.shadowsBlurEnabled && mLightingImage)
+		{
+			BEGIN_QUERY(profile::RenderStage::BlurShadows)
+			mLightingImage->blur(blurFeatures.shadowsBlurFactor, blurFeatures.blurKernelSize, blurFeatures.mode);
+			END_QUERY
+		}
+
+		computeScattering();
+			
+		// Disabled features are compiled out of ray marching variant. Only definitions
+		// differing from shader defaults are passed, default configuration uses pipeline
+		// compiled asynchronously at startup instead of compiling variant on first frame
+		ShaderDefines defines;
+		if (!features.shadowsEnabled) defines["ENABLE_SHADOWS"] = "0";
+		if (mDeepOpacityMap) defines["SHADOW_TECHNIQUE"] = "1";
+		if (features.radianceEnabled) defines["ENABLE_RADIANCE"] = "1";
+		if (features.scatteringEnabled) defines["ENABLE_SCATTERING"] = "1";
+		if (!adaptiveStep.enabled) defines["ENABLE_ADAPTIVE_STEPPING"] = "0";
+
+		auto pipeline = system::Renderer::getInstance().getPipelineVariant("raytracing", defines).get();
+
+		BEGIN_QUERY(profile::RenderStage::RayMarching)
+		pipeline->Bind();
+
+		GLint viewport_size[4];
+		glGetIntegerv(GL_VIEWPORT, viewport_size);
+
+		glm::vec2 viewport_size_f = { viewport_size[2], viewport_size[3] };
+		glm::vec3 lightColor(lightColor[0], lightColor[1], lightColor[2]);
+
+		glm::mat4 modelMatrix = glm::translate(glm::mat4(), position);
+		modelMatrix = glm::scale(modelMatrix, (mVolumeResolution / glm::vec3(gcd(gcd(mVolumeResolution.x, mVolumeResolution.y), mVolumeResolution.z))) * scale);
+
+
+		RayTracingParameters parameters = {};
+		parameters.framebufferSize = viewport_size_f;
+		parameters.invModelViewProjMatrix = glm::inverse(camera->getViewMatrix() * modelMatrix);
+		parameters.domainDebugMode = domainDebugRenderMode;
+		
+		if (domainDebugRenderMode == 0)
+		{
+			parameters.stepSize = 1.0f / densitySamples;
+			parameters.samples = adaptiveStep.enabled ? static_cast<int>(densitySamples / adaptiveStep.minStepScale) : densitySamples;
+			parameters.jitter = densityJitter;
+			parameters.lightColor = lightColor;
+			parameters.lightIntensity = lightIntensityFactor;
+			parameters.scatteringIntensity = scattering.intensity;
+			parameters.densityCoefficient = densityFactor;
+			parameters.minStepScale = adaptiveStep.minStepScale;
+			parameters.maxStepScale = adaptiveStep.maxStepScale;
+			parameters.gradientThreshold = adaptiveStep.gradientThreshold;
+			parameters.transmittanceStepGrowth = adaptiveStep.transmittanceGrowth;
+			parameters.brickSize = adaptiveStep.brickSize;
+
+			StateCache::getInstance().bindTexture(0, (blurFeatures.densityBlurEnabled) ? image(*mSimulation->getDensity().ping()).getBlurredObjectID() : image(*mSimulation->getDensity().ping()).getObjectID());
+
+			if (mLightingImage)
+			{
+				StateCache::getInstance().bindTexture(1, (blurFeatures.shadowsBlurEnabled) ? mLightingImage->getBlurredObjectID() : mLightingImage->getObjectID());
+			}
+
+			if (mDeepOpacityMap)
+			{
+				mDeepOpacityMap->bind(9);
+
+				parameters.lightDirection = mDeepOpacityMap->getLightDirection();
+				parameters.lightTangent = mDeepOpacityMap->getLightTangent();
+				parameters.lightBitangent = mDeepOpacityMap->getLightBitangent();
+			}
+
+			StateCache::getInstance().bindTexture(2, getObstacleTextureID());
+
+			StateCache::getInstance().bindTexture(3, image(*mSimulation->getTemperature().ping()).getObjectID());
+
+			if (mLightDiffusion)
+			{
+				StateCache::getInstance().bindTexture(5, mLightDiffusion->getObjectID());
+			}
+
+			StateCache::getInstance().bindTexture(6, mOccupancyImage->getObjectID());
+
+			// Regenerate lookup tables only when radiance or absorbtion changed
+			mTransferFunction->update(falloff, lightAbsorbtionFactor);
+			mTransferFunction->bind(7, 8);
+
+			parameters.temperatureScale = mTransferFunction->getTemperatureScale();
+			parameters.opticalLengthScale = mTransferFunction->getOpticalLengthScale();
+			
+		}
+
+		system::Renderer::getInstance().getUniformBuffer().upload(PARAMETERS_BINDING, parameters);
+
+		mRenderQuad->render();
+
+		pipeline->Unbind();
+		END_QUERY
+
 #if defined PROFILE
+		profile::Profiler::collect();
 		profile::Profiler::frames++;
 
-		if (profile::Profiler::frames == 100)
+		if (profile::Profiler::frames == profile::Profiler::measuredFrames)
 		{
 			glm::ivec3 iVolumeResolution = static_cast<glm::ivec3>(mVolumeResolution);
 			std::string resolution = "_" + std::to_string(iVolumeResolution.x) + "x" + std::to_string(iVolumeResolution.y) + "x" + std::to_string(iVolumeResolution.z);
@@ -687,17 +776,19 @@ namespace vfx
 			std::string samples = "s" + std::to_string(shadowsSamples) + "_l" + std::to_string(densitySamples);
 			profile::Profiler::log("profile" + resolution + features + samples + ".csv");
 
-			auto newGridResolution = profile::Profiler::getNextGridResolution();
+			glm::ivec3 newGridResolution;
 
-			if (newGridResolution.x != iVolumeResolution.x ||
+			if (!profile::Profiler::getNextGridResolution(newGridResolution))
+				LOG_INFO("Fluid - Profiling finished");
+			else if (newGridResolution.x != iVolumeResolution.x ||
 				newGridResolution.y != iVolumeResolution.y ||
 				newGridResolution.z != iVolumeResolution.z)
 			{
 				profile::Profiler::frames = 0;
 				resize(newGridResolution);
-				updateSettings();
+				applySettings(profile::Profiler::getSettings());
 			}
 		}
-#endif
+#endif
 	}
 }
\ No newline at end of file
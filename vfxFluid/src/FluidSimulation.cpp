@@ -0,0 +1,360 @@
+#include "FluidSimulation.h"
+
+#include "IComputeDevice.h"
+#include "UniformBlocks.h"
+#include "Quantity.h"
+
+// Obstacles
+#include "Cube.h"
+#include "Sphere.h"
+#include "NoObstacle.h"
+
+// Advection algorithms
+#include "SemiLagrangian.h"
+#include "MacCormack.h"
+
+// Injection algorithms
+#include "TempInjection.h"
+#include "VelocityInjection.h"
+#include "DensityInjection.h"
+
+#include <cassert>
+
+namespace vfx
+{
+	FluidSimulation::FluidSimulation(IComputeDevice& device)
+		: injections(1)
+		, mDevice(device)
+		, mSize(0)
+	{
+	}
+
+	FluidSimulation::~FluidSimulation()
+	{
+	}
+
+	void FluidSimulation::resize(const glm::uvec3& size)
+	{
+		mSize = size;
+		auto resolution = static_cast<glm::vec3>(size);
+
+		mTemperature = std::make_unique<Quantity>(mDevice, resolution, 1);
+		mTemperature->setProperty<float>("dissipation", 0.001f);
+		mTemperature->setProperty<float>("decay", 0.03f);
+		mTemperature->setInjection(std::make_shared<TempInjection>(mDevice));
+
+		mVelocity = std::make_unique<Quantity>(mDevice, resolution, 4);
+		mVelocity->setProperty<float>("dissipation", 0.001f);
+		mVelocity->setInjection(std::make_shared<VelocityInjection>(mDevice));
+
+		mDensity = std::make_unique<Quantity>(mDevice, resolution, 4);
+		mDensity->setProperty<float>("dissipation", 0.001f);
+		mDensity->setProperty<float>("decay", 0.03f);
+		mDensity->setInjection(std::make_shared<DensityInjection>(mDevice));
+
+		// Pressure is cleared by solver every step
+		mPressure = std::make_unique<Quantity>(mDevice, resolution, 1);
+
+		mDevice.clear(*mVelocity->ping());
+		mDevice.clear(*mTemperature->ping());
+		mDevice.clear(*mDensity->ping());
+
+		mVorticityVolume = mDevice.createVolume(size, VolumeFormat::RGBA16F);
+		mDivergenceVolume = mDevice.createVolume(size, VolumeFormat::R16F);
+
+		mSemiLagrangian = std::make_unique<SemiLagrangian>(mDevice);
+		mMacCormack = std::make_unique<MacCormack>(mDevice, resolution);
+
+		// Obstacles share single volume, order matches changeObstacle
+		mObstacleVolume = mDevice.createVolume(size, VolumeFormat::R8);
+
+		mObstacles.clear();
+		mObstacles.push_back(std::make_unique<NoObstacle>(mDevice, mObstacleVolume));
+		mObstacles.push_back(std::make_unique<Sphere>(mDevice, mObstacleVolume));
+		mObstacles.push_back(std::make_unique<Cube>(mDevice, mObstacleVolume));
+
+		mObstacles[mActiveObstacleIndex]->fill();
+	}
+
+	void FluidSimulation::reset()
+	{
+		if (!mVelocity)
+			return;
+
+		mVelocity->reset();
+		mDensity->reset();
+		mTemperature->reset();
+		mPressure->reset();
+		mDivergenceVolume->reset();
+		mVorticityVolume->reset();
+		mObstacleVolume->reset();
+
+		for (auto& obstacle : mObstacles)
+		{
+			obstacle->reset();
+		}
+	}
+
+	void FluidSimulation::changeObstacle(unsigned int index)
+	{
+		assert(index < mObstacles.size());
+
+		mActiveObstacleIndex = index;
+		mObstacles[index]->fill();
+	}
+
+	void FluidSimulation::moveObstacle(const glm::vec3& position)
+	{
+		mObstacles[mActiveObstacleIndex]->position = position;
+		mObstacles[mActiveObstacleIndex]->fill();
+	}
+
+	glm::vec3 FluidSimulation::getObstaclePosition() const
+	{
+		if (mObstacles.size())
+			return mObstacles[mActiveObstacleIndex]->position;
+		else
+			return glm::vec3(0.0f);
+	}
+
+	void FluidSimulation::simulate(float deltaTime, float injectionTimeStep)
+	{
+		// Order of simulation graph of Fluid
+		advectVelocity(deltaTime);
+		mDevice.barrier(Barrier::All);
+
+		advectTemperature(deltaTime);
+		mDevice.barrier(Barrier::All);
+
+		advectDensity(deltaTime);
+		mDevice.barrier(Barrier::All);
+
+		if (features.injectionEnabled && injectionTimeStep > 0.0f)
+		{
+			inject(injectionTimeStep);
+			mDevice.barrier(Barrier::All);
+		}
+
+		if (features.buoyancyEnabled)
+		{
+			computeBuoyancy(deltaTime);
+			mDevice.barrier(Barrier::All);
+		}
+
+		if (features.vorticityEnabled)
+		{
+			computeVorticity();
+			mDevice.barrier(Barrier::All);
+
+			computeConfinement(deltaTime);
+			mDevice.barrier(Barrier::All);
+		}
+
+		computeDivergence();
+		mDevice.barrier(Barrier::All);
+
+		solvePressure();
+		mDevice.barrier(Barrier::All);
+
+		projectAndSubtract();
+		mDevice.barrier(Barrier::All);
+	}
+
+	void FluidSimulation::advect(IAdvection& advection, Quantity& quantity, float dissipation, float decay, float deltaTime)
+	{
+		advection.advect(*mObstacleVolume, *mVelocity->ping(), *quantity.ping(), *quantity.pong(), dissipation, decay, deltaTime);
+		quantity.swap();
+	}
+
+	void FluidSimulation::advectVelocity(float deltaTime)
+	{
+		// Velocity is advected using Semi-Lagrangian advection
+		advect(*mSemiLagrangian, *mVelocity, mVelocity->getProperty<float>("dissipation"), 0, deltaTime);
+	}
+
+	void FluidSimulation::advectTemperature(float deltaTime)
+	{
+		IAdvection& advection = useMacCormackAdvection ? *mMacCormack : *mSemiLagrangian;
+		advect(advection, *mTemperature, mTemperature->getProperty<float>("dissipation"), mTemperature->getProperty<float>("decay"), deltaTime);
+	}
+
+	void FluidSimulation::advectDensity(float deltaTime)
+	{
+		IAdvection& advection = useMacCormackAdvection ? *mMacCormack : *mSemiLagrangian;
+		advect(advection, *mDensity, mDensity->getProperty<float>("dissipation"), mDensity->getProperty<float>("decay"), deltaTime);
+	}
+
+	void FluidSimulation::inject(float deltaTime)
+	{
+		for (const auto& injection : injections)
+		{
+			// Inject density
+			mDensity->setProperty<float>("sigma", injection.densitySigma);
+			mDensity->setProperty<float>("intensity", injection.densityIntensity);
+			mDensity->setProperty<glm::vec3>("color", injection.color);
+			mDensity->inject(injection.position, deltaTime);
+
+			// Inject temperature
+			mTemperature->setProperty<float>("sigma", injection.temperatureSigma);
+			mTemperature->setProperty<float>("intensity", injection.temperatureIntensity);
+			mTemperature->inject(injection.position, deltaTime);
+
+			// Inject velocity
+			mVelocity->setProperty<float>("sigma", injection.velocitySigma);
+			mVelocity->setProperty<float>("intensity", injection.velocityIntensity);
+			mVelocity->inject(injection.position, deltaTime);
+		}
+	}
+
+	void FluidSimulation::computeBuoyancy(float deltaTime)
+	{
+		// Bind kernel, setup parameters & volumes
+		mDevice.bindKernel("buoyancy", mSize);
+
+		BuoyancyParameters parameters = {};
+		parameters.direction = buoyancy.direction;
+		parameters.ambientTemperature = buoyancy.ambientTemperature;
+		parameters.deltaTime = deltaTime;
+		parameters.strength = buoyancy.strength;
+		parameters.weight = buoyancy.weight;
+		mDevice.setParameters(parameters);
+
+		// Bind velocity volume
+		mDevice.bindVolume(0, *mVelocity->ping());
+
+		// Bind temperature volume
+		mDevice.bindVolume(1, *mTemperature->ping());
+
+		// Bind density volume
+		mDevice.bindVolume(2, *mDensity->ping());
+
+		// Dispatch compute task
+		mDevice.bindTarget(0, *mVelocity->pong());
+		mDevice.dispatch();
+
+		// Swap surfaces
+		mVelocity->swap();
+
+		// Unbind kernel
+		mDevice.unbindKernel();
+	}
+
+	void FluidSimulation::computeVorticity()
+	{
+		// Bind kernel, setup volumes
+		mDevice.bindKernel("vorticity", mSize);
+
+		// Bind velocity volume
+		mDevice.bindVolume(0, *mVelocity->ping());
+
+		// Dispatch compute task
+		mDevice.bindTarget(0, *mVorticityVolume);
+		mDevice.dispatch();
+
+		mDevice.unbindKernel();
+	}
+
+	void FluidSimulation::computeConfinement(float deltaTime)
+	{
+		mDevice.bindKernel("confinement", mSize);
+
+		ConfinementParameters parameters = {};
+		parameters.deltaTime = deltaTime;
+		parameters.strength = vorticity.strength;
+		mDevice.setParameters(parameters);
+
+		// Bind velocity volume
+		mDevice.bindVolume(0, *mVelocity->ping());
+
+		// Bind vorticity volume
+		mDevice.bindVolume(1, *mVorticityVolume);
+
+		// Dispatch compute task
+		mDevice.bindTarget(0, *mVelocity->pong());
+		mDevice.dispatch();
+		mVelocity->swap();
+
+		// Unbind kernel
+		mDevice.unbindKernel();
+	}
+
+	void FluidSimulation::computeDivergence()
+	{
+		// Bind kernel, setup volumes
+		mDevice.bindKernel("divergence", mSize);
+
+		// Bind velocity volume
+		mDevice.bindVolume(0, *mVelocity->ping());
+
+		// Bind obstacle volume
+		mDevice.bindVolume(1, *mObstacleVolume);
+
+		// Dispatch compute task
+		mDevice.bindTarget(0, *mDivergenceVolume);
+		mDevice.dispatch();
+
+		// Unbind kernel
+		mDevice.unbindKernel();
+	}
+
+	void FluidSimulation::solvePressure()
+	{
+		if (pressure.iterations <= 0) pressure.iterations = 20;
+
+		// Clear source volume
+		mDevice.clear(*mPressure->ping());
+
+		// Bind kernel, setup volumes
+		mDevice.bindKernel("jacobi", mSize);
+
+		// Bind divergence volume
+		mDevice.bindVolume(0, *mDivergenceVolume);
+
+		// Bind obstacle volume
+		mDevice.bindVolume(1, *mObstacleVolume);
+
+		// Solve pressure by jacobi method, use predefined number of iterations
+		for (int i = 0; i < pressure.iterations; ++i)
+		{
+			// Previous iteration result is fetched, last one is left to caller
+			if (i > 0) mDevice.barrier(Barrier::TextureFetch);
+
+			// Bind pressure source volume
+			mDevice.bindVolume(2, *mPressure->ping());
+
+			// Dispatch compute task
+			mDevice.bindTarget(0, *mPressure->pong());
+			mDevice.dispatch();
+			mPressure->swap();
+		}
+
+		// Unbind kernel
+		mDevice.unbindKernel();
+	}
+
+	void FluidSimulation::projectAndSubtract()
+	{
+		if (pressure.gradientScale < 0.0f) pressure.gradientScale = 1.0f;
+
+		// Bind kernel, setup uniforms & volumes
+		mDevice.bindKernel("projection", mSize);
+		mDevice.setUniform("gradientScale", pressure.gradientScale);
+
+		// Bind velocity volume
+		mDevice.bindVolume(0, *mVelocity->ping());
+
+		// Bind obstacle volume
+		mDevice.bindVolume(1, *mObstacleVolume);
+
+		// Bind pressure volume
+		mDevice.bindVolume(2, *mPressure->ping());
+
+		// Dispatch compute task
+		mDevice.bindTarget(0, *mVelocity->pong());
+		mDevice.dispatch();
+		mDevice.unbindKernel();
+
+		// Swap surfaces
+		mVelocity->swap();
+	}
+}
@@ -0,0 +1,112 @@
+#include "GLComputeDevice.h"
+#include "Image3D.h"
+#include "UniformBlocks.h"
+#include "vfxEngine.h"
+
+namespace vfx
+{
+	Image3D& GLComputeDevice::getImage(const IVolume& volume)
+	{
+		assert(dynamic_cast<const Image3D*>(&volume) != nullptr);
+		return const_cast<Image3D&>(static_cast<const Image3D&>(volume));
+	}
+
+	GLenum GLComputeDevice::getTextureFormat(VolumeFormat format)
+	{
+		switch (format)
+		{
+		case VolumeFormat::R8: return GL_R8;
+		case VolumeFormat::R16F: return GL_R16F;
+		case VolumeFormat::RG16F: return GL_RG16F;
+		case VolumeFormat::R32F: return GL_R32F;
+		case VolumeFormat::RG32F: return GL_RG32F;
+		case VolumeFormat::RGBA32F: return GL_RGBA32F;
+		default: return GL_RGBA16F;
+		}
+	}
+
+	std::shared_ptr<IVolume> GLComputeDevice::createVolume(const glm::uvec3& size, VolumeFormat format)
+	{
+		return std::make_shared<Image3D>(size, getTextureFormat(format));
+	}
+
+	void GLComputeDevice::bindKernel(const std::string& name, const glm::uvec3& gridSize)
+	{
+		// Pipeline work group size is tuned per grid size
+		mPipeline = system::Renderer::getInstance().getComputePipeline(name, gridSize);
+		mKernel = name;
+		mGridSize = gridSize;
+
+		mPipeline->Bind();
+	}
+
+	void GLComputeDevice::unbindKernel()
+	{
+		if (mPipeline) mPipeline->Unbind();
+
+		mPipeline = nullptr;
+		mKernel.clear();
+	}
+
+	void GLComputeDevice::bindVolume(unsigned int unit, const IVolume& volume)
+	{
+		StateCache::getInstance().bindTexture(unit, getImage(volume).getObjectID());
+	}
+
+	void GLComputeDevice::bindTarget(unsigned int unit, const IVolume& volume)
+	{
+		const Image3D& image = getImage(volume);
+		StateCache::getInstance().bindImageTexture(unit, image.getObjectID(), 0, GL_TRUE, 0, GL_WRITE_ONLY, image.getFormat());
+	}
+
+	void GLComputeDevice::setParameters(const void* data, std::size_t size)
+	{
+		system::Renderer::getInstance().getUniformBuffer().upload(PARAMETERS_BINDING, data, static_cast<GLsizeiptr>(size));
+	}
+
+	void GLComputeDevice::setUniform(const std::string& name, float value)
+	{
+		mPipeline->SetUniform(name, value);
+	}
+
+	void GLComputeDevice::setUniform(const std::string& name, const glm::vec3& value)
+	{
+		mPipeline->SetUniform(name, value);
+	}
+
+	void GLComputeDevice::setUniform(const std::string& name, const glm::vec4& value)
+	{
+		mPipeline->SetUniform(name, value);
+	}
+
+	void GLComputeDevice::dispatch()
+	{
+		system::Renderer::getInstance().dispatchCompute(mKernel, mGridSize);
+	}
+
+	void GLComputeDevice::barrier(Barrier barrier)
+	{
+		switch (barrier)
+		{
+		case Barrier::TextureFetch:
+			GL_CHECK(glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT));
+			break;
+		case Barrier::ImageAccess:
+			GL_CHECK(glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT));
+			break;
+		default:
+			GL_CHECK(glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT));
+			break;
+		}
+	}
+
+	void GLComputeDevice::clear(const IVolume& volume)
+	{
+		getImage(volume).clear();
+	}
+
+	void GLComputeDevice::readback(const IVolume& volume, Volume& data)
+	{
+		getImage(volume).readback(data);
+	}
+}
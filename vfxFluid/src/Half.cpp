@@ -0,0 +1,50 @@
+#include "Half.h"
+
+#if defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__))
+#	include <immintrin.h>
+#	define VFX_HALF_F16C
+#endif
+
+namespace vfx
+{
+	void convertToHalf(const float* source, Half* destination, size_t count)
+	{
+		size_t i = 0;
+
+#if defined(VFX_HALF_F16C)
+		for (; i + 8 <= count; i += 8)
+		{
+			__m128i halves = _mm256_cvtps_ph(_mm256_loadu_ps(source + i), _MM_FROUND_TO_NEAREST_INT);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), halves);
+		}
+#endif
+
+		for (; i < count; ++i)
+			destination[i].bits = floatToHalf(source[i]);
+	}
+
+	void convertToFloat(const Half* source, float* destination, size_t count)
+	{
+		size_t i = 0;
+
+#if defined(VFX_HALF_F16C)
+		for (; i + 8 <= count; i += 8)
+		{
+			__m128i halves = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+			_mm256_storeu_ps(destination + i, _mm256_cvtph_ps(halves));
+		}
+#endif
+
+		for (; i < count; ++i)
+			destination[i] = halfToFloat(source[i].bits);
+	}
+
+	const char* getHalfConversionName()
+	{
+#if defined(VFX_HALF_F16C)
+		return "F16C";
+#else
+		return "scalar";
+#endif
+	}
+}
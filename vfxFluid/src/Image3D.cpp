@@ -1,14 +1,40 @@
 ﻿#include "Image3D.h"
+#include "Half.h"
+#include "VolumeFile.h"
 #include "vfxEngine.h"
 
+#include <glm/vec2.hpp>
+#include <algorithm>
+#include <cmath>
+
 namespace vfx
 {
-	GLuint Image3D::mBlurTempPing = 0;
-	GLuint Image3D::mBlurTempPong = 0;
-	bool Image3D::mBlurTexInitialized = false;
+	std::map<std::tuple<unsigned int, unsigned int, unsigned int, GLenum>, Image3D::BlurScratch> Image3D::mScratchPool;
+	std::map<std::pair<unsigned int, float>, GLuint> Image3D::mKernelCache;
+
+	namespace
+	{
+		// Must match blur.comp
+		const unsigned int BLUR_LINE_SIZE = 64;
+		const unsigned int MAX_BLUR_RADIUS = 16;
+
+		const size_t MAX_CACHED_KERNELS = 64;
+
+		// Must match blur_recursive.comp
+		const unsigned int RECURSIVE_BLUR_GROUP_SIZE = 8;
+
+		// Recursive filter pays off once separable kernel grows past this size,
+		// below minimum sigma its approximation of gaussian is poor
+		const unsigned int RECURSIVE_BLUR_MIN_KERNEL = 11;
+		const float RECURSIVE_BLUR_MIN_SIGMA = 0.5f;
+
+		GLenum getPixelFormat(unsigned int channels)
+		{
+			return (channels == 1) ? GL_RED : (channels == 2) ? GL_RG : GL_RGBA;
+		}
+	}
 
 	Image3D::Image3D(const glm::uvec3& rSize,
-		bool blurrable,
 		GLenum format,
 		GLenum magFilter,
 		GLenum minFilter,
@@ -22,10 +48,7 @@ namespace vfx
 	{
 		assert(rSize.x > 0 && rSize.y > 0 && rSize.z > 0);
 
-		createTexture(mObjectID, magFilter, minFilter, wrapMode, baseLevel, maxLevel);
-
-		GL_CHECK(glGenBuffers(1, &mOffsetSSBO));
-		GL_CHECK(glGenBuffers(1, &mWeightSSBO));
+		createTexture(mObjectID, mSize, mFormat, magFilter, minFilter, wrapMode, baseLevel, maxLevel);
 
 		mIsInitialized = true;
 	}
@@ -33,84 +56,58 @@ namespace vfx
 	Image3D::~Image3D()
 	{
 		reset();
-
-		GL_CHECK(glDeleteBuffers(1, &mOffsetSSBO));
-		GL_CHECK(glDeleteBuffers(1, &mWeightSSBO));
 	}
 
-	void Image3D::createBlurTempTargets(const glm::uvec3& size,
-										GLenum format,
-										GLenum magFilter,
-										GLenum minFilter,
-										GLenum wrapMode,
-										GLint baseLevel,
-										GLint maxLevel)
+	void Image3D::releaseBlurScratch()
 	{
-		if (mBlurTexInitialized)
+		for (auto& scratch : mScratchPool)
 		{
-			GL_CHECK(glDeleteTextures(1, &mBlurTempPing));
-			GL_CHECK(glDeleteTextures(1, &mBlurTempPong));
+			StateCache::getInstance().deleteTextures(1, &scratch.second.ping);
+			StateCache::getInstance().deleteTextures(1, &scratch.second.pong);
 		}
 
-		if (mBlurTempPing == 0 && mBlurTempPong == 0)
-		{
-			GL_CHECK(glGenTextures(1, &mBlurTempPing));
-			GL_CHECK(glActiveTexture(GL_TEXTURE0));
-			GL_CHECK(glBindTexture(GL_TEXTURE_3D, mBlurTempPing));
-			GL_CHECK(glTexStorage3D(GL_TEXTURE_3D, 1, format, size.x, size.y, size.z));
-			GL_CHECK(glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, magFilter));
-			GL_CHECK(glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, minFilter));
-			GL_CHECK(glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, wrapMode));
-			GL_CHECK(glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, wrapMode));
-			GL_CHECK(glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, wrapMode));
-			GL_CHECK(glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_BASE_LEVEL, baseLevel));
-			GL_CHECK(glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAX_LEVEL, maxLevel));
-			GL_CHECK(glBindTexture(GL_TEXTURE_3D, 0));
-
-
-			GL_CHECK(glGenTextures(1, &mBlurTempPong));
-			GL_CHECK(glActiveTexture(GL_TEXTURE0));
-			GL_CHECK(glBindTexture(GL_TEXTURE_3D, mBlurTempPong));
-			GL_CHECK(glTexStorage3D(GL_TEXTURE_3D, 1, format, size.x, size.y, size.z));
-			GL_CHECK(glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, magFilter));
-			GL_CHECK(glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, minFilter));
-			GL_CHECK(glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, wrapMode));
-			GL_CHECK(glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, wrapMode));
-			GL_CHECK(glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, wrapMode));
-			GL_CHECK(glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_BASE_LEVEL, baseLevel));
-			GL_CHECK(glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAX_LEVEL, maxLevel));
-			GL_CHECK(glBindTexture(GL_TEXTURE_3D, 0));
-
-			mBlurTexInitialized = true;
-			LOG_INFO("Image3D - Created temporary targets for gaussian blur");
-		}
+		mScratchPool.clear();
 	}
 
-	void Image3D::createTexture(GLuint& handle, GLenum magFilter, GLenum minFilter, GLenum wrapMode, GLint baseLevel, GLint maxLevel)
+	const Image3D::BlurScratch& Image3D::getBlurScratch(const glm::uvec3& size, GLenum format)
 	{
-		GL_CHECK(glGenTextures(1, &handle));
-		GL_CHECK(glActiveTexture(GL_TEXTURE0));
-		GL_CHECK(glBindTexture(GL_TEXTURE_3D, handle));
-		GL_CHECK(glTexStorage3D(GL_TEXTURE_3D, 1, mFormat, mSize.x, mSize.y, mSize.z));
-		GL_CHECK(glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, magFilter));
-		GL_CHECK(glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, minFilter));
-		GL_CHECK(glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, wrapMode));
-		GL_CHECK(glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, wrapMode));
-		GL_CHECK(glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, wrapMode));
-		GL_CHECK(glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_BASE_LEVEL, baseLevel));
-		GL_CHECK(glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAX_LEVEL, maxLevel));
-		GL_CHECK(glBindTexture(GL_TEXTURE_3D, 0));
+		auto key = std::make_tuple(size.x, size.y, size.z, format);
+		auto scratch = mScratchPool.find(key);
+
+		if (scratch != mScratchPool.end())
+			return scratch->second;
+
+		BlurScratch targets;
+		createTexture(targets.ping, size, format);
+		createTexture(targets.pong, size, format);
+
+		LOG_INFO("Image3D - Created temporary targets for gaussian blur: " + std::to_string(size.x) + "x" + std::to_string(size.y) + "x" + std::to_string(size.z));
+
+		return mScratchPool.emplace(key, targets).first->second;
+	}
+
+	void Image3D::createTexture(GLuint& handle, const glm::uvec3& size, GLenum format, GLenum magFilter, GLenum minFilter, GLenum wrapMode, GLint baseLevel, GLint maxLevel)
+	{
+		// Direct state access, texture units tracked by state cache are not touched
+		GL_CHECK(glCreateTextures(GL_TEXTURE_3D, 1, &handle));
+		GL_CHECK(glTextureStorage3D(handle, 1, format, size.x, size.y, size.z));
+		GL_CHECK(glTextureParameteri(handle, GL_TEXTURE_MAG_FILTER, magFilter));
+		GL_CHECK(glTextureParameteri(handle, GL_TEXTURE_MIN_FILTER, minFilter));
+		GL_CHECK(glTextureParameteri(handle, GL_TEXTURE_WRAP_S, wrapMode));
+		GL_CHECK(glTextureParameteri(handle, GL_TEXTURE_WRAP_T, wrapMode));
+		GL_CHECK(glTextureParameteri(handle, GL_TEXTURE_WRAP_R, wrapMode));
+		GL_CHECK(glTextureParameteri(handle, GL_TEXTURE_BASE_LEVEL, baseLevel));
+		GL_CHECK(glTextureParameteri(handle, GL_TEXTURE_MAX_LEVEL, maxLevel));
 	}
 
 	void Image3D::bind(int textureUnit) const
 	{
-		GL_CHECK(glActiveTexture(textureUnit));
-		GL_CHECK(glBindTexture(GL_TEXTURE_3D, mObjectID));
+		StateCache::getInstance().bindTexture(textureUnit, mObjectID);
 	}
 
-	void Image3D::unbind() const
+	void Image3D::unbind(int textureUnit) const
 	{
-		GL_CHECK(glBindTexture(GL_TEXTURE_3D, 0));
+		StateCache::getInstance().bindTexture(textureUnit, 0);
 	}
 
 	glm::vec3 Image3D::getSize() const
@@ -123,6 +120,111 @@ namespace vfx
 		return mFormat;
 	}
 
+	VolumeFormat Image3D::getVolumeFormat() const
+	{
+		// Simulation volumes are allocated by GLComputeDevice in these formats only
+		switch (mFormat)
+		{
+		case GL_R8:
+			return VolumeFormat::R8;
+		case GL_R16F:
+			return VolumeFormat::R16F;
+		case GL_RG16F:
+			return VolumeFormat::RG16F;
+		case GL_R32F:
+			return VolumeFormat::R32F;
+		case GL_RG32F:
+			return VolumeFormat::RG32F;
+		case GL_RGBA32F:
+			return VolumeFormat::RGBA32F;
+		default:
+			return VolumeFormat::RGBA16F;
+		}
+	}
+
+	unsigned int Image3D::getChannels() const
+	{
+		switch (mFormat)
+		{
+		case GL_R8:
+		case GL_R16F:
+		case GL_R32F:
+			return 1;
+		case GL_RG8:
+		case GL_RG16F:
+		case GL_RG32F:
+			return 2;
+		default:
+			return 4;
+		}
+	}
+
+	bool Image3D::isHalfFormat() const
+	{
+		return mFormat == GL_R16F || mFormat == GL_RG16F || mFormat == GL_RGBA16F;
+	}
+
+	void Image3D::readback(Volume& volume) const
+	{
+		volume.size = mSize;
+		volume.channels = getChannels();
+
+		// 16F images are transferred as halves, half of the data crosses the bus
+		// and conversion runs vectorized on CPU
+		if (isHalfFormat())
+		{
+			std::vector<Half> halves;
+			readback(halves);
+
+			volume.data.resize(halves.size());
+			convertToFloat(halves.data(), volume.data.data(), halves.size());
+			return;
+		}
+
+		volume.data.resize(static_cast<size_t>(mSize.x) * mSize.y * mSize.z * volume.channels);
+
+		GL_CHECK(glPixelStorei(GL_PACK_ALIGNMENT, 1));
+		GL_CHECK(glGetTextureImage(mObjectID, 0, getPixelFormat(volume.channels), GL_FLOAT, static_cast<GLsizei>(volume.data.size() * sizeof(float)), volume.data.data()));
+	}
+
+	void Image3D::readback(std::vector<Half>& data) const
+	{
+		data.resize(static_cast<size_t>(mSize.x) * mSize.y * mSize.z * getChannels());
+
+		GL_CHECK(glPixelStorei(GL_PACK_ALIGNMENT, 1));
+		GL_CHECK(glGetTextureImage(mObjectID, 0, getPixelFormat(getChannels()), GL_HALF_FLOAT, static_cast<GLsizei>(data.size() * sizeof(Half)), data.data()));
+	}
+
+	bool Image3D::exportVolume(const std::string& filename) const
+	{
+		bool written;
+
+		// 16F images are written without conversion
+		if (isHalfFormat())
+		{
+			std::vector<Half> halves;
+			readback(halves);
+
+			written = VolumeFile::write(filename, mSize, getChannels(), halves);
+		}
+		else
+		{
+			Volume volume;
+			readback(volume);
+
+			written = VolumeFile::write(filename, volume);
+		}
+
+		if (!written)
+		{
+			LOG_ERROR("Image3D - Failed to export volume: " + filename);
+			return false;
+		}
+
+		LOG_INFO("Image3D - Exported volume: " + filename);
+		return true;
+	}
+
 	GLuint Image3D::getBlurredObjectID() const
 	{
 		return mBlurredImage;
@@ -133,124 +235,197 @@ namespace vfx
 		return mObjectID;
 	}
 
-	void Image3D::blur(float sigma, unsigned int size)
+	void Image3D::blur(float sigma, unsigned int size, BlurMode mode)
 	{
 		if (sigma < 0.0001f) sigma = 0.0001f;
 
 		if (!mIsBlurImageInitialized)
 		{
-			createTexture(mBlurredImage);
+			createTexture(mBlurredImage, mSize, mFormat);
 			mIsBlurImageInitialized = true;
 		}
 
-		auto weights = computeFilterKernel(size, sigma);
-		auto offsets = computeBlurOffsets(BlurStage::Horizontal, size);
+		if (mode == BlurMode::Automatic)
+			mode = selectBlurMode(sigma, size);
 
-		// Copy weights to GPU
-		GL_CHECK(glBindBuffer(GL_SHADER_STORAGE_BUFFER, mWeightSSBO));
-		GL_CHECK(glBufferData(GL_SHADER_STORAGE_BUFFER, size * sizeof(float), weights.data(), GL_STATIC_READ));
+		if (mode == BlurMode::Recursive)
+			blurRecursive(sigma);
+		else
+			blurSeparable(sigma, size);
+	}
+
+	BlurMode Image3D::selectBlurMode(float sigma, unsigned int size)
+	{
+		if (size >= RECURSIVE_BLUR_MIN_KERNEL && sigma >= RECURSIVE_BLUR_MIN_SIGMA)
+			return BlurMode::Recursive;
 
-		// Copy horizontal offsets to GPU
-		GL_CHECK(glBindBuffer(GL_SHADER_STORAGE_BUFFER, mOffsetSSBO));
-		GL_CHECK(glBufferData(GL_SHADER_STORAGE_BUFFER, size * 3 * sizeof(int), offsets.data(), GL_STATIC_READ));
+		return BlurMode::Separable;
+	}
+
+	void Image3D::blurSeparable(float sigma, unsigned int size)
+	{
+		// Line buffer of blur kernel holds apron of at most MAX_BLUR_RADIUS voxels
+		size = std::min(std::max(size, 1u), 2u * MAX_BLUR_RADIUS + 1u);
 
 		std::shared_ptr<Pipeline> pipeline;
 
 		pipeline = system::Renderer::getInstance().getPipelineByName("blur");
 
-		pipeline->Bind();
-		pipeline->SetUniform("kernelSize", size);
-
-		GL_CHECK(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, mOffsetSSBO));
-		GL_CHECK(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, mWeightSSBO));
-
-		GL_CHECK(glActiveTexture(GL_TEXTURE0));
-		GL_CHECK(glBindTexture(GL_TEXTURE_3D, mObjectID));
-
-		glm::uvec3 resolution = static_cast<glm::uvec3>(mSize);
-
-		GL_CHECK(glBindImageTexture(0, mBlurTempPing, 0, GL_TRUE, 0, GL_WRITE_ONLY, GL_RGBA16F));
-		GL_CHECK(glDispatchCompute(resolution.x / 8, resolution.y / 8, resolution.z / 8));
-		GL_CHECK(glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT));
-
-		// Compute and copy vertical offsets to GPU
-		offsets = computeBlurOffsets(BlurStage::Vertical, size);
-		GL_CHECK(glBindBuffer(GL_SHADER_STORAGE_BUFFER, mOffsetSSBO));
-		GL_CHECK(glBufferData(GL_SHADER_STORAGE_BUFFER, size * 3 * sizeof(int), offsets.data(), GL_STATIC_READ));
-
-		GL_CHECK(glActiveTexture(GL_TEXTURE0));
-		GL_CHECK(glBindTexture(GL_TEXTURE_3D, mBlurTempPing));
-
-		GL_CHECK(glBindImageTexture(0, mBlurTempPong, 0, GL_TRUE, 0, GL_WRITE_ONLY, GL_RGBA16F));
-		GL_CHECK(glDispatchCompute(resolution.x / 8, resolution.y / 8, resolution.z / 8));
-		GL_CHECK(glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT));
-
-		// Compute and copy depth offsets to GPU
-		offsets = computeBlurOffsets(BlurStage::Depth, size);
-		GL_CHECK(glBindBuffer(GL_SHADER_STORAGE_BUFFER, mOffsetSSBO));
-		GL_CHECK(glBufferData(GL_SHADER_STORAGE_BUFFER, size * 3 * sizeof(int), offsets.data(), GL_STATIC_READ));
-
-		GL_CHECK(glActiveTexture(GL_TEXTURE0));
-		GL_CHECK(glBindTexture(GL_TEXTURE_3D, mBlurTempPong));
-
-		GL_CHECK(glBindImageTexture(0, mBlurredImage, 0, GL_TRUE, 0, GL_WRITE_ONLY, mFormat));
-		GL_CHECK(glDispatchCompute(resolution.x / 8, resolution.y / 8, resolution.z / 8));
-		GL_CHECK(glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT));
-
-		GL_CHECK(glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0));
+		pipeline->Bind();
+		pipeline->SetUniform("kernelSize", size);
+
+		StateCache::getInstance().bindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, getFilterKernel(size, sigma));
+
+		const BlurScratch& scratch = getBlurScratch(mSize, mFormat);
+
+		dispatchBlurPass(BlurStage::Horizontal, mObjectID, scratch.ping);
+		dispatchBlurPass(BlurStage::Vertical, scratch.ping, scratch.pong);
+		dispatchBlurPass(BlurStage::Depth, scratch.pong, mBlurredImage);
+
+		StateCache::getInstance().bindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 0);
+
+		pipeline->Unbind();
+	}
+
+	void Image3D::dispatchBlurPass(BlurStage stage, GLuint source, GLuint target) const
+	{
+		std::shared_ptr<Pipeline> pipeline = system::Renderer::getInstance().getPipelineByName("blur");
+		pipeline->SetUniform("axis", static_cast<int>(stage));
+
+		StateCache::getInstance().bindTexture(0, source);
+		StateCache::getInstance().bindImageTexture(0, target, 0, GL_TRUE, 0, GL_WRITE_ONLY, mFormat);
+
+		// Each work group blurs one line segment along blurred axis
+		glm::uvec3 dispatchSize;
+
+		switch (stage)
+		{
+		case BlurStage::Horizontal:
+			dispatchSize = glm::uvec3((mSize.x + BLUR_LINE_SIZE - 1) / BLUR_LINE_SIZE, mSize.y, mSize.z);
+			break;
+		case BlurStage::Vertical:
+			dispatchSize = glm::uvec3((mSize.y + BLUR_LINE_SIZE - 1) / BLUR_LINE_SIZE, mSize.x, mSize.z);
+			break;
+		default:
+			dispatchSize = glm::uvec3((mSize.z + BLUR_LINE_SIZE - 1) / BLUR_LINE_SIZE, mSize.x, mSize.y);
+			break;
+		}
+
+		GL_CHECK(glDispatchCompute(dispatchSize.x, dispatchSize.y, dispatchSize.z));
+		GL_CHECK(glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT));
+	}
+
+	void Image3D::blurRecursive(float sigma)
+	{
+		// Young - van Vliet coefficients, "Recursive implementation of the Gaussian filter" (1995)
+		float q = (sigma >= 2.5f) ? 0.98711f * sigma - 0.96330f : 3.97156f - 4.14554f * std::sqrt(1.0f - 0.26891f * sigma);
+
+		float q2 = q * q;
+		float q3 = q2 * q;
+
+		float b0 = 1.57825f + 2.44413f * q + 1.4281f * q2 + 0.422205f * q3;
+		float b1 = 2.44413f * q + 2.85619f * q2 + 1.26661f * q3;
+		float b2 = -(1.4281f * q2 + 1.26661f * q3);
+		float b3 = 0.422205f * q3;
+
+		std::shared_ptr<Pipeline> pipeline = system::Renderer::getInstance().getPipelineByName("blurRecursive");
+
+		pipeline->Bind();
+		pipeline->SetUniform("B", 1.0f - (b1 + b2 + b3) / b0);
+		pipeline->SetUniform("b", glm::vec3(b1, b2, b3) / b0);
+
+		const BlurScratch& scratch = getBlurScratch(mSize, mFormat);
+
+		// Causal pass writes ping, anticausal pass reads it back and writes pong
+		dispatchRecursivePass(BlurStage::Horizontal, false, mObjectID, scratch.ping);
+		dispatchRecursivePass(BlurStage::Horizontal, true, scratch.ping, scratch.pong);
+		dispatchRecursivePass(BlurStage::Vertical, false, scratch.pong, scratch.ping);
+		dispatchRecursivePass(BlurStage::Vertical, true, scratch.ping, scratch.pong);
+		dispatchRecursivePass(BlurStage::Depth, false, scratch.pong, scratch.ping);
+		dispatchRecursivePass(BlurStage::Depth, true, scratch.ping, mBlurredImage);
 
 		pipeline->Unbind();
 	}
 
-	std::vector<float> Image3D::computeFilterKernel(int size, float sigma) const
-	{
-		std::vector<float> weights(size);
-
-		float offset = -(size - 1) / 2.0f;
-		float sum = 0.0f;
-
-		for (auto &weight : weights)
-		{
-			// compute gaussian
-			weight = glm::exp(-offset * offset / (2.0f * sigma * sigma));
-			
-			sum += weight;
-			offset += 1.0f;
-		}
-
-		// normalize kernel
-		for (auto &weight : weights)
-			weight /= sum;
-
-		return weights;
+	void Image3D::dispatchRecursivePass(BlurStage stage, bool backward, GLuint source, GLuint target) const
+	{
+		std::shared_ptr<Pipeline> pipeline = system::Renderer::getInstance().getPipelineByName("blurRecursive");
+		pipeline->SetUniform("axis", static_cast<int>(stage));
+		pipeline->SetUniform("backward", backward ? 1 : 0);
+
+		StateCache::getInstance().bindTexture(0, source);
+		StateCache::getInstance().bindImageTexture(0, target, 0, GL_TRUE, 0, GL_WRITE_ONLY, mFormat);
+
+		// Each invocation filters one whole line along blurred axis
+		glm::uvec2 lines;
+
+		switch (stage)
+		{
+		case BlurStage::Horizontal:
+			lines = glm::uvec2(mSize.y, mSize.z);
+			break;
+		case BlurStage::Vertical:
+			lines = glm::uvec2(mSize.x, mSize.z);
+			break;
+		default:
+			lines = glm::uvec2(mSize.x, mSize.y);
+			break;
+		}
+
+		GL_CHECK(glDispatchCompute((lines.x + RECURSIVE_BLUR_GROUP_SIZE - 1) / RECURSIVE_BLUR_GROUP_SIZE,
+			(lines.y + RECURSIVE_BLUR_GROUP_SIZE - 1) / RECURSIVE_BLUR_GROUP_SIZE, 1));
+		GL_CHECK(glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT));
 	}
 
-	std::vector<glm::ivec3> Image3D::computeBlurOffsets(BlurStage stage, int size) const
+	GLuint Image3D::getFilterKernel(unsigned int size, float sigma)
 	{
-		std::vector<glm::ivec3> offsets(size);
+		auto key = std::make_pair(size, sigma);
+		auto kernel = mKernelCache.find(key);
+
+		if (kernel != mKernelCache.end())
+			return kernel->second;
 
-		int diff = size / 2;
-		for (auto &offset : offsets)
+		// Sigma is continuous GUI parameter, keep cache bounded
+		if (mKernelCache.size() >= MAX_CACHED_KERNELS)
 		{
-			switch (stage)
-			{
-			case BlurStage::Horizontal:
-				offset = glm::ivec3(-diff, 0, 0);
-				break;
-			case BlurStage::Vertical:
-				offset = glm::ivec3(0, -diff, 0);
-				break;
-			case BlurStage::Depth:
-				offset = glm::ivec3(0, 0, -diff);
-				break;
-			default:
-				break;
-			}
-
-			--diff;
+			for (auto& cached : mKernelCache)
+				StateCache::getInstance().deleteBuffers(1, &cached.second);
+
+			mKernelCache.clear();
+		}
+
+		auto weights = computeFilterKernel(size, sigma);
+
+		GLuint buffer;
+		GL_CHECK(glCreateBuffers(1, &buffer));
+		GL_CHECK(glNamedBufferData(buffer, weights.size() * sizeof(float), weights.data(), GL_STATIC_DRAW));
+
+		mKernelCache[key] = buffer;
+
+		return buffer;
+	}
+
+	std::vector<float> Image3D::computeFilterKernel(int size, float sigma)
+	{
+		std::vector<float> weights(size);
+
+		float offset = -(size - 1) / 2.0f;
+		float sum = 0.0f;
+
+		for (auto &weight : weights)
+		{
+			// compute gaussian
+			weight = glm::exp(-offset * offset / (2.0f * sigma * sigma));
+			
+			sum += weight;
+			offset += 1.0f;
 		}
 
-		return offsets;
+		// normalize kernel
+		for (auto &weight : weights)
+			weight /= sum;
+
+		return weights;
 	}
 
 	void Image3D::clear() const
@@ -261,9 +436,9 @@ namespace vfx
 
 		pipeline->Bind();
 
-		GL_CHECK(glBindImageTexture(0, mObjectID, 0, GL_TRUE, 0, GL_WRITE_ONLY, mFormat));
-		GL_CHECK(glDispatchCompute(mSize.x / 8, mSize.y / 8, mSize.z / 8));
-		GL_CHECK(glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT));
+		StateCache::getInstance().bindImageTexture(0, mObjectID, 0, GL_TRUE, 0, GL_WRITE_ONLY, mFormat);
+		GL_CHECK(glDispatchCompute((mSize.x + 7) / 8, (mSize.y + 7) / 8, (mSize.z + 7) / 8));
+		GL_CHECK(glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT));
 
 		pipeline->Unbind();
 	}
@@ -272,8 +447,8 @@ namespace vfx
 	{
 		if (mIsInitialized)
 		{
-			GL_CHECK(glDeleteTextures(1, &mObjectID));
-			GL_CHECK(glDeleteTextures(1, &mBlurredImage));
+			StateCache::getInstance().deleteTextures(1, &mObjectID);
+			StateCache::getInstance().deleteTextures(1, &mBlurredImage);
 
 			mObjectID = 0;
 			mFormat = 0;
@@ -0,0 +1,174 @@
+#include "LightDiffusion.h"
+#include "DeepOpacityMap.h"
+#include "Image3D.h"
+#include "vfxEngine.h"
+
+#include <algorithm>
+
+namespace vfx
+{
+	LightDiffusion::LightDiffusion(const glm::uvec3& resolution, ScatteringQuality quality)
+		: mQuality(quality)
+	{
+		unsigned int octaves = 3;
+
+		switch (quality)
+		{
+		case ScatteringQuality::Low:
+			octaves = 2;
+			mIterations = 2;
+			break;
+		case ScatteringQuality::High:
+			octaves = 4;
+			mIterations = 8;
+			break;
+		default:
+			octaves = 3;
+			mIterations = 4;
+			break;
+		}
+
+		glm::uvec3 size = resolution;
+
+		for (unsigned int i = 0; i < octaves; ++i)
+		{
+			size = glm::max(size / 2u, glm::uvec3(1));
+
+			Octave octave;
+			octave.source = std::make_unique<Image3D>(size, GL_RG16F);
+			octave.ping = std::make_unique<Image3D>(size, GL_R16F);
+			octave.pong = std::make_unique<Image3D>(size, GL_R16F);
+
+			mOctaves.push_back(std::move(octave));
+		}
+
+		LOG_INFO("LightDiffusion - Created " + std::to_string(octaves) + " octaves, " + std::to_string(mIterations) + " iterations per octave");
+	}
+
+	LightDiffusion::~LightDiffusion()
+	{
+	}
+
+	void LightDiffusion::compute(const ScatteringProperties& properties, const Image3D& density, const Image3D* lighting, const DeepOpacityMap* deepOpacityMap, float factor, float absorbtion, float lightIntensity)
+	{
+		computeSource(density, lighting, deepOpacityMap, factor, absorbtion, lightIntensity);
+		diffuse(properties.albedo, absorbtion);
+		upsample(properties.octaveWeight);
+	}
+
+	GLuint LightDiffusion::getObjectID() const
+	{
+		return mOctaves.front().pong->getObjectID();
+	}
+
+	void LightDiffusion::computeSource(const Image3D& density, const Image3D* lighting, const DeepOpacityMap* deepOpacityMap, float factor, float absorbtion, float lightIntensity)
+	{
+		auto pipeline = system::Renderer::getInstance().getPipelineByName("scatteringSource").get();
+
+		pipeline->Bind();
+		pipeline->SetUniform("factor", factor);
+		pipeline->SetUniform("absorbtion", absorbtion);
+		pipeline->SetUniform("lightIntensity", lightIntensity);
+		pipeline->SetUniform("enableShadows", static_cast<int>(lighting != nullptr || deepOpacityMap != nullptr));
+		pipeline->SetUniform("shadowTechnique", static_cast<int>(deepOpacityMap != nullptr));
+
+		StateCache::getInstance().bindTexture(0, density.getObjectID());
+
+		if (lighting)
+		{
+			StateCache::getInstance().bindTexture(1, lighting->getObjectID());
+		}
+
+		if (deepOpacityMap)
+		{
+			deepOpacityMap->bind(2);
+
+			pipeline->SetUniform("lightDirection", deepOpacityMap->getLightDirection());
+			pipeline->SetUniform("lightTangent", deepOpacityMap->getLightTangent());
+			pipeline->SetUniform("lightBitangent", deepOpacityMap->getLightBitangent());
+		}
+
+		// Coarser octaves are downsampled from previous octave
+		for (size_t i = 0; i < mOctaves.size(); ++i)
+		{
+			pipeline->SetUniform("level", static_cast<int>(i));
+
+			if (i > 0)
+			{
+				StateCache::getInstance().bindTexture(3, mOctaves[i - 1].source->getObjectID());
+			}
+
+			const Image3D& source = *mOctaves[i].source;
+
+			StateCache::getInstance().bindImageTexture(0, source.getObjectID(), 0, GL_TRUE, 0, GL_WRITE_ONLY, source.getFormat());
+			dispatch(source);
+			glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+		}
+
+		pipeline->Unbind();
+	}
+
+	void LightDiffusion::diffuse(float albedo, float absorbtion)
+	{
+		auto pipeline = system::Renderer::getInstance().getPipelineByName("scatteringDiffuse").get();
+
+		pipeline->Bind();
+		pipeline->SetUniform("albedo", albedo);
+		pipeline->SetUniform("absorbtion", absorbtion);
+
+		for (auto& octave : mOctaves)
+		{
+			StateCache::getInstance().bindTexture(0, octave.source->getObjectID());
+
+			for (unsigned int i = 0; i < mIterations; ++i)
+			{
+				// Source term is the initial guess of diffused light
+				StateCache::getInstance().bindTexture(1, (i == 0) ? octave.source->getObjectID() : octave.ping->getObjectID());
+
+				StateCache::getInstance().bindImageTexture(0, octave.pong->getObjectID(), 0, GL_TRUE, 0, GL_WRITE_ONLY, octave.pong->getFormat());
+				dispatch(*octave.pong);
+				glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+
+				std::swap(octave.ping, octave.pong);
+			}
+		}
+
+		pipeline->Unbind();
+	}
+
+	void LightDiffusion::upsample(float octaveWeight)
+	{
+		auto pipeline = system::Renderer::getInstance().getPipelineByName("scatteringUpsample").get();
+
+		pipeline->Bind();
+		pipeline->SetUniform("octaveWeight", octaveWeight);
+
+		// Combine from the coarsest octave, result is stored in pong of the finest octave
+		for (size_t i = mOctaves.size(); i-- > 0;)
+		{
+			bool hasCoarseOctave = (i + 1) < mOctaves.size();
+			pipeline->SetUniform("hasCoarseOctave", static_cast<int>(hasCoarseOctave));
+
+			StateCache::getInstance().bindTexture(0, mOctaves[i].ping->getObjectID());
+
+			if (hasCoarseOctave)
+			{
+				StateCache::getInstance().bindTexture(1, mOctaves[i + 1].pong->getObjectID());
+			}
+
+			const Image3D& combined = *mOctaves[i].pong;
+
+			StateCache::getInstance().bindImageTexture(0, combined.getObjectID(), 0, GL_TRUE, 0, GL_WRITE_ONLY, combined.getFormat());
+			dispatch(combined);
+			glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+		}
+
+		pipeline->Unbind();
+	}
+
+	void LightDiffusion::dispatch(const Image3D& image)
+	{
+		glm::uvec3 dispatchSize = (static_cast<glm::uvec3>(image.getSize()) + glm::uvec3(7)) / glm::uvec3(8);
+		glDispatchCompute(dispatchSize.x, dispatchSize.y, dispatchSize.z);
+	}
+}
@@ -1,12 +1,11 @@
 #include "NoObstacle.h"
-#include "Image3D.h"
-#include "vfxEngine.h"
+#include "IComputeDevice.h"
 
 
 namespace vfx
 {
-	NoObstacle::NoObstacle(const std::shared_ptr<Image3D>& volume, const glm::vec3& workGroupSize)
-		: Obstacle(volume, system::Renderer::getInstance().getPipelineByName("NoObstacleFill"), workGroupSize)
+	NoObstacle::NoObstacle(IComputeDevice& device, const std::shared_ptr<IVolume>& volume)
+		: Obstacle(device, volume, "NoObstacleFill")
 	{
 
 	}
@@ -1,36 +1,27 @@
 #include "Obstacle.h"
-#include "Image3D.h"
-#include "Quantity.h"
-#include "vfxEngine.h"
+#include "IComputeDevice.h"
 
 namespace vfx
 {
-	Obstacle::Obstacle(	const std::shared_ptr<Image3D>& volume,
-						const std::shared_ptr<Pipeline>& pipeline,
-						const glm::vec3& workGroupSize)
-		: mVolume(volume)
-		, mPipeline(pipeline)
-		, mWorkGroupSize(workGroupSize)
-		, position(0.5f)
+	Obstacle::Obstacle(	IComputeDevice& device,
+						const std::shared_ptr<IVolume>& volume,
+						const std::string& kernel)
+		: position(0.5f)
+		, mDevice(device)
+		, mVolume(volume)
+		, mKernel(kernel)
 	{
 	}
 
-	void Obstacle::blur(float sigma, unsigned int size)
-	{
-		mVolume->blur(sigma, size);
-	}
-
 	void Obstacle::fill()
 	{
-		mPipeline->Bind();
+		mDevice.bindKernel(mKernel, static_cast<glm::uvec3>(mVolume->getSize()));
 		bindProperties();
 
-		auto size = static_cast<glm::uvec3>(mVolume->getSize() / mWorkGroupSize);
-
-		GL_CHECK(glBindImageTexture(0, mVolume->getObjectID(), 0, GL_TRUE, 0, GL_WRITE_ONLY, mVolume->getFormat()));
-		GL_CHECK(glDispatchCompute(size.x, size.y, size.z));
-		GL_CHECK(glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT));
+		mDevice.bindTarget(0, *mVolume);
+		mDevice.dispatch();
+		mDevice.barrier(Barrier::ImageAccess);
 
-		mPipeline->Unbind();
+		mDevice.unbindKernel();
 	}
-}
\ No newline at end of file
+}
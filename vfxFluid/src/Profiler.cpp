@@ -1,7 +1,10 @@
 #include "Profiler.h"
+#include "vfxEngine.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <fstream>
-#include <gl/glew.h>
 
 // rapidjson
 #include "document.h"
@@ -10,47 +13,35 @@
 namespace profile
 {
 	unsigned int Profiler::frames = 0;
-	GLuint Profiler::query = 0;
-	std::string Profiler::stage = "";
 	std::map<std::string, std::vector<float>> Profiler::stageTimes;
+	std::map<std::string, std::vector<float>> Profiler::counters;
 	std::vector<TestData> Profiler::scenarios;
 	std::vector<glm::ivec3> Profiler::profileResolutions;
 	unsigned int Profiler::activeGridIndex = 0;
 	unsigned int Profiler::activeScenarioIndex = 0;
+	unsigned int Profiler::warmupFrames = 10;
+	unsigned int Profiler::measuredFrames = 100;
 	const std::string Profiler::delimiter = ",";
 
-	void Profiler::beginQuery(RenderStage stage_)
+	void Profiler::collect()
 	{
-		glGenQueries(1, &query);
-		glBeginQuery(GL_TIME_ELAPSED, query);
+		const auto& queries = vfx::system::Renderer::getInstance().getTimestampQueries();
 
-		stage = to_string(stage_);
-	}
-
-	void Profiler::beginQuery(SimulationStage stage_)
-	{
-		glGenQueries(1, &query);
-		glBeginQuery(GL_TIME_ELAPSED, query);
-
-		stage = to_string(stage_);
-	}
-
-	void Profiler::endQuery()
-	{
-		glEndQuery(GL_TIME_ELAPSED);
+		// Frame not read (dropped or still in flight) leaves results of earlier frame
+		if (!queries.hasNewResults()) return;
 
-		GLuint64 time;
-		glGetQueryObjectui64v(query, GL_QUERY_RESULT, &time);
+		std::map<std::string, float> frameTimes;
 
-		stageTimes[stage].push_back(time * 0.000001f);
-		stage = "";
+		for (const auto& result : queries.getResults())
+			frameTimes[result.name] += static_cast<float>(result.milliseconds);
 
-		glDeleteQueries(1, &query);
+		for (const auto& stage : frameTimes)
+			stageTimes[stage.first].push_back(stage.second);
 	}
 
 	void Profiler::log(const std::string& filename)
 	{
-		if (profile::Profiler::frames != 100) return;
+		if (profile::Profiler::frames != measuredFrames) return;
 		
 
 		std::fstream profileFile(filename, std::ios::out);
@@ -93,7 +84,7 @@ namespace profile
 	void Profiler::loadProfilingData(const std::string & file)
 	{
 		rapidjson::Document document;
-		std::ifstream ifs("config.json", std::ios::in);
+		std::ifstream ifs(file, std::ios::in);
 
 		if (ifs.is_open())
 		{
@@ -101,8 +92,19 @@ namespace profile
 			document.ParseStream(isw);
 		}
 
+		if (document.HasParseError() || !document.IsObject() || !document.HasMember("profiling"))
+		{
+			LOG_ERROR("Profiler - " + file + " has no profiling section");
+			return;
+		}
+
+		const auto& profiling = document["profiling"];
+
+		if (profiling.HasMember("warmup_frames")) warmupFrames = profiling["warmup_frames"].GetUint();
+		if (profiling.HasMember("measured_frames")) measuredFrames = profiling["measured_frames"].GetUint();
+
 		// Load grid resolutions
-		for (auto& scenario : document["profiling"]["grid_data"].GetObject())
+		for (auto& scenario : profiling["grid_data"].GetObject())
 		{
 			glm::ivec3 res;
 			for (auto& member : scenario.value.GetObject())
@@ -116,9 +118,11 @@ namespace profile
 		}
 
 		// Load scenarios
-		for (auto& scenario : document["profiling"]["scenarios"].GetObject())
+		for (auto& scenario : profiling["scenarios"].GetObject())
 		{
 			TestData data;
+			data.name = scenario.name.GetString();
+
 			for (auto& member : scenario.value.GetObject())
 			{
 				if (strcmp(member.name.GetString(), "density_blur") == 0) { data.blurDensity = member.value.GetBool(); continue; }
@@ -130,6 +134,7 @@ namespace profile
 				if (strcmp(member.name.GetString(), "radiance") == 0) { data.radiance = member.value.GetBool(); continue; }
 				if (strcmp(member.name.GetString(), "obstacle") == 0) { data.obstacle = member.value.GetBool(); continue; }
 				if (strcmp(member.name.GetString(), "shadows") == 0) { data.shadows = member.value.GetBool(); continue; }
+				if (strcmp(member.name.GetString(), "statistics") == 0) { data.statistics = member.value.GetBool(); continue; }
 
 				if (strcmp(member.name.GetString(), "shadow_samples") == 0) { data.shadowSamples = member.value.GetInt(); continue; }
 				if (strcmp(member.name.GetString(), "lighting_samples") == 0) { data.lightingSamples = member.value.GetInt(); continue; }
@@ -139,9 +144,11 @@ namespace profile
 		}
 	}
 
-	glm::ivec3 Profiler::getNextGridResolution()
+	bool Profiler::getNextGridResolution(glm::ivec3& resolution)
 	{
-		auto res = profileResolutions[activeGridIndex];
+		if (profileResolutions.empty() || activeScenarioIndex >= scenarios.size()) return false;
+
+		resolution = profileResolutions[activeGridIndex];
 
 		if (activeGridIndex < (profileResolutions.size() - 1))
 			activeGridIndex++;
@@ -150,14 +157,12 @@ namespace profile
 			activeGridIndex = 0;
 			activeScenarioIndex++;
 
+			// Caller decides how to finish, e.g. demo keeps running
 			if (activeScenarioIndex > scenarios.size() - 1)
-			{
-				exit(0);
-			}
+				return false;
 		}
-			
 
-		return res;
+		return true;
 	}
 
 	TestData Profiler::getSettings()
@@ -165,6 +170,41 @@ namespace profile
 		return scenarios[activeScenarioIndex];
 	}
 
+	Statistics Profiler::computeStatistics(std::vector<float> samples)
+	{
+		Statistics statistics;
+		statistics.samples = samples.size();
+
+		if (samples.empty()) return statistics;
+
+		std::sort(samples.begin(), samples.end());
+
+		auto percentile = [&samples](double p)
+		{
+			auto rank = static_cast<size_t>(std::ceil(p * samples.size()));
+			return static_cast<double>(samples[std::max<size_t>(rank, 1) - 1]);
+		};
+
+		double sum = 0.0;
+		for (auto sample : samples)
+			sum += sample;
+
+		statistics.mean = sum / samples.size();
+
+		double variance = 0.0;
+		for (auto sample : samples)
+			variance += (sample - statistics.mean) * (sample - statistics.mean);
+
+		statistics.stddev = samples.size() > 1 ? std::sqrt(variance / (samples.size() - 1)) : 0.0;
+
+		auto middle = samples.size() / 2;
+		statistics.median = samples.size() % 2 ? samples[middle] : 0.5 * (samples[middle - 1] + samples[middle]);
+		statistics.p95 = percentile(0.95);
+		statistics.p99 = percentile(0.99);
+
+		return statistics;
+	}
+
 	std::string to_string(SimulationStage stage)
 	{
 		switch (stage)
@@ -185,9 +225,13 @@ namespace profile
 			return "pressure";
 		case profile::SimulationStage::SubtractGradient:
 			return "gradient";
+		case profile::SimulationStage::Statistics:
+			return "statistics";
 		default:
 			break;
 		}
+
+		return "";
 	}
 
 	std::string to_string(RenderStage stage)
@@ -204,10 +248,16 @@ namespace profile
 			return "blurDensity";
 		case profile::RenderStage::BlurObstacle:
 			return "blurObstacle";
+		case profile::RenderStage::Occupancy:
+			return "occupancy";
+		case profile::RenderStage::Scattering:
+			return "scattering";
 		case profile::RenderStage::RayMarching:
 			return "raymarching";
 		default:
 			break;
 		}
+
+		return "";
 	}
 }
\ No newline at end of file
@@ -1,15 +1,19 @@
 #include "Quantity.h"
-#include "Image3D.h"
+#include "IComputeDevice.h"
 #include "IInjection.h"
 
 namespace vfx
 {
-	Quantity::Quantity(const glm::vec3& resolution, short int channels)
-		: mPing(nullptr)
+	Quantity::Quantity(IComputeDevice& device, const glm::vec3& resolution, short int channels)
+		: mDevice(device)
+		, mPing(nullptr)
 		, mPong(nullptr)
 	{
-		mPing = std::make_shared<Image3D>(resolution, (channels == 4) ? GL_RGBA16F : GL_R16F);
-		mPong = std::make_shared<Image3D>(resolution, (channels == 4) ? GL_RGBA16F : GL_R16F);
+		auto size = static_cast<glm::uvec3>(resolution);
+		auto format = (channels == 4) ? VolumeFormat::RGBA16F : VolumeFormat::R16F;
+
+		mPing = mDevice.createVolume(size, format);
+		mPong = mDevice.createVolume(size, format);
 	}
 
 	Quantity::~Quantity()
@@ -20,21 +24,16 @@ namespace vfx
 		}
 	}
 
-	const Image3D * Quantity::ping() const
+	const IVolume * Quantity::ping() const
 	{
 		return mPing.get();
 	}
 
-	const Image3D * Quantity::pong() const
+	const IVolume * Quantity::pong() const
 	{
 		return mPong.get();
 	}
 
-	void Quantity::blur(float sigma, unsigned int size) const
-	{
-		mPing->blur(sigma, size);
-	}
-
 	void Quantity::inject(const glm::vec3 & position, float deltaTime)
 	{
 		mInjection->inject(this, position, deltaTime);
@@ -42,8 +41,8 @@ namespace vfx
 
 	void Quantity::clear() const
 	{
-		mPing->clear();
-		mPong->clear();
+		mDevice.clear(*mPing);
+		mDevice.clear(*mPong);
 	}
 
 	void Quantity::reset() const
@@ -1,42 +1,47 @@
 #include "SemiLagrangian.h"
-#include "Image3D.h"
-#include "vfxEngine.h"
+#include "IComputeDevice.h"
+#include "UniformBlocks.h"
 
 namespace vfx
 {
-	void SemiLagrangian::advect(const Image3D& obstacle,
-								const Image3D& velocity,
-								const Image3D& source,
-								const Image3D& target,
+	SemiLagrangian::SemiLagrangian(IComputeDevice& device)
+		: mDevice(device)
+	{
+	}
+
+	void SemiLagrangian::advect(const IVolume& obstacle,
+								const IVolume& velocity,
+								const IVolume& source,
+								const IVolume& target,
 								float dissipation,
 								float decay,
 								float dt)
 	{
-		// Get pipeline by target image type
-		auto pipeline = system::Renderer::getInstance().getPipelineByName((target.getFormat() == GL_RGBA16F ? "advect4D" : "advect1D"));
+		// Get kernel by target volume format
+		auto kernelName = (getFormatChannels(target.getVolumeFormat()) == 4 ? "advect4D" : "advect1D");
+		auto size = static_cast<glm::uvec3>(target.getSize());
 
-		pipeline->Bind();
-		pipeline->SetUniform("dissipation", dissipation);
-		pipeline->SetUniform("deltaTime", dt);
+		mDevice.bindKernel(kernelName, size);
 
-		// Bind velocity image
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_3D, velocity.getObjectID());
+		AdvectionParameters parameters = {};
+		parameters.deltaTime = dt;
+		parameters.dissipation = dissipation;
+		parameters.decay = decay;
+		mDevice.setParameters(parameters);
 
-		// Bind obstacle image
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_3D, obstacle.getObjectID());
+		// Bind velocity volume
+		mDevice.bindVolume(0, velocity);
 
-		// Bind source quantity image
-		glActiveTexture(GL_TEXTURE2);
-		glBindTexture(GL_TEXTURE_3D, source.getObjectID());
+		// Bind obstacle volume
+		mDevice.bindVolume(1, obstacle);
 
-		auto size = static_cast<glm::uvec3>(target.getSize());
-		glBindImageTexture(0, target.getObjectID(), 0, GL_TRUE, 0, GL_WRITE_ONLY, target.getFormat());
-		glDispatchCompute(size.x / 8, size.y / 8, size.z / 8);
-		glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+		// Bind source quantity volume
+		mDevice.bindVolume(2, source);
+
+		mDevice.bindTarget(0, target);
+		mDevice.dispatch();
 
-		// Unbind pipeline
-		pipeline->Unbind();
+		// Unbind kernel
+		mDevice.unbindKernel();
 	}
 }
\ No newline at end of file
@@ -0,0 +1,183 @@
+#include "SimulationGraph.h"
+#include "vfxEngine.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace vfx
+{
+	namespace
+	{
+		const unsigned int MAX_STAGES = 32;
+
+		bool contains(const std::vector<unsigned int>& resources, unsigned int resource)
+		{
+			return std::find(resources.begin(), resources.end(), resource) != resources.end();
+		}
+	}
+
+	unsigned int SimulationGraph::addResource(const std::string& name, bool doubleBuffered)
+	{
+		mResources.push_back({ name, doubleBuffered });
+		return static_cast<unsigned int>(mResources.size() - 1);
+	}
+
+	unsigned int SimulationGraph::addStage(const std::string& name, const std::vector<Read>& reads, const std::vector<unsigned int>& writes, const StageFunction& function)
+	{
+		assert(mStages.size() < MAX_STAGES);
+
+		mStages.push_back({ name, reads, writes, function });
+		mCommandLists.clear();
+
+		return static_cast<unsigned int>(mStages.size() - 1);
+	}
+
+	unsigned int SimulationGraph::getStageMask(const std::string& name) const
+	{
+		for (size_t i = 0; i < mStages.size(); ++i)
+			if (mStages[i].name == name) return 1u << i;
+
+		return 0;
+	}
+
+	unsigned int SimulationGraph::getAllStagesMask() const
+	{
+		return (mStages.size() == MAX_STAGES) ? ~0u : (1u << mStages.size()) - 1;
+	}
+
+	void SimulationGraph::execute(unsigned int mask, float deltaTime)
+	{
+		auto found = mCommandLists.find(mask);
+		if (found == mCommandLists.end())
+			found = mCommandLists.emplace(mask, compile(mask)).first;
+
+		const auto& commandList = found->second;
+
+		for (const auto& command : commandList.commands)
+		{
+			if (command.barriers) GL_CHECK(glMemoryBarrier(command.barriers));
+			mStages[command.stage].function(deltaTime);
+		}
+
+		if (commandList.flush) GL_CHECK(glMemoryBarrier(commandList.flush));
+	}
+
+	void SimulationGraph::clear()
+	{
+		mResources.clear();
+		mStages.clear();
+		mCommandLists.clear();
+	}
+
+	bool SimulationGraph::dependsOn(const Stage& stage, const Stage& earlier) const
+	{
+		// Read after write
+		for (const auto& read : stage.reads)
+			if (contains(earlier.writes, read.resource)) return true;
+
+		for (auto write : stage.writes)
+		{
+			// Write after write
+			if (contains(earlier.writes, write)) return true;
+
+			// Write after read, stages swap ping-pong images when recorded,
+			// so reader must run first even if it reads the other image
+			for (const auto& read : earlier.reads)
+				if (read.resource == write) return true;
+		}
+
+		return false;
+	}
+
+	SimulationGraph::CommandList SimulationGraph::compile(unsigned int mask) const
+	{
+		std::vector<unsigned int> enabled;
+		for (unsigned int i = 0; i < mStages.size(); ++i)
+			if (mask & (1u << i)) enabled.push_back(i);
+
+		// Place each stage one level after the latest stage it depends on
+		std::vector<unsigned int> levels(enabled.size(), 0);
+		unsigned int levelCount = 0;
+
+		for (size_t i = 0; i < enabled.size(); ++i)
+		{
+			for (size_t j = 0; j < i; ++j)
+			{
+				if (dependsOn(mStages[enabled[i]], mStages[enabled[j]]))
+					levels[i] = std::max(levels[i], levels[j] + 1);
+			}
+
+			levelCount = std::max(levelCount, levels[i] + 1);
+		}
+
+		// Stages of one level are independent, they are recorded back to back
+		// and barrier is issued only when level touches data written or read
+		// since the last barrier. Hazards are tracked per barrier bit, barrier
+		// resolves only hazards of bits it contains, other bits stay pending
+		CommandList commandList;
+		std::vector<GLbitfield> pendingWrites(mResources.size(), 0);
+		std::vector<GLbitfield> pendingReads(mResources.size(), 0);
+		unsigned int barrierCount = 0;
+
+		const GLbitfield writeBarriers = GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT;
+
+		for (unsigned int level = 0; level < levelCount; ++level)
+		{
+			GLbitfield barriers = 0;
+
+			for (size_t i = 0; i < enabled.size(); ++i)
+			{
+				if (levels[i] != level) continue;
+
+				const auto& stage = mStages[enabled[i]];
+
+				for (const auto& read : stage.reads)
+				{
+					GLbitfield required = (read.access == Access::Sampled) ? GL_TEXTURE_FETCH_BARRIER_BIT : GL_SHADER_IMAGE_ACCESS_BARRIER_BIT;
+					barriers |= pendingWrites[read.resource] & required;
+				}
+
+				for (auto write : stage.writes)
+				{
+					// Second write of ping-pong resource targets image read before the first one
+					barriers |= pendingWrites[write] & GL_SHADER_IMAGE_ACCESS_BARRIER_BIT;
+
+					if (!mResources[write].doubleBuffered)
+						barriers |= pendingReads[write];
+				}
+			}
+
+			if (barriers)
+			{
+				for (auto& pending : pendingWrites) pending &= ~barriers;
+				for (auto& pending : pendingReads) pending &= ~barriers;
+				++barrierCount;
+			}
+
+			for (size_t i = 0; i < enabled.size(); ++i)
+			{
+				if (levels[i] != level) continue;
+
+				const auto& stage = mStages[enabled[i]];
+
+				// Image store after read is ordered by image access barrier
+				for (const auto& read : stage.reads)
+					pendingReads[read.resource] = GL_SHADER_IMAGE_ACCESS_BARRIER_BIT;
+
+				for (auto write : stage.writes)
+					pendingWrites[write] = writeBarriers;
+
+				commandList.commands.push_back({ barriers, enabled[i] });
+				barriers = 0;
+			}
+		}
+
+		// Consumers outside of graph may read results either way
+		for (auto pending : pendingWrites)
+			commandList.flush |= pending;
+
+		LOG_DEBUG("SimulationGraph - Compiled " + std::to_string(enabled.size()) + " stages into " + std::to_string(levelCount) + " levels with " + std::to_string(barrierCount) + " barriers");
+
+		return commandList;
+	}
+}
@@ -0,0 +1,139 @@
+#include "SimulationStatistics.h"
+#include "Image3D.h"
+#include "vfxEngine.h"
+
+#include <cmath>
+
+namespace vfx
+{
+	SimulationStatistics::SimulationStatistics(unsigned int latency)
+		: mPartialBuffer(0)
+		, mPartialCapacity(0)
+		, mSlot(0)
+		, mFences(latency, nullptr)
+		, mTimeSteps(latency, 0.0f)
+	{
+		assert(latency > 0);
+
+		const GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		const GLsizeiptr size = sizeof(Partial) * latency;
+
+		GL_CHECK(glCreateBuffers(1, &mResultBuffer));
+		GL_CHECK(glNamedBufferStorage(mResultBuffer, size, nullptr, flags));
+		GL_CHECK(mMappedResults = static_cast<const Partial*>(glMapNamedBufferRange(mResultBuffer, 0, size, flags)));
+
+		LOG_INFO("SimulationStatistics - Created result ring of " + std::to_string(latency) + " slots");
+	}
+
+	SimulationStatistics::~SimulationStatistics()
+	{
+		for (auto fence : mFences)
+		{
+			if (fence) GL_CHECK(glDeleteSync(fence));
+		}
+
+		GL_CHECK(glUnmapNamedBuffer(mResultBuffer));
+		StateCache::getInstance().deleteBuffers(1, &mResultBuffer);
+
+		if (mPartialBuffer) StateCache::getInstance().deleteBuffers(1, &mPartialBuffer);
+	}
+
+	void SimulationStatistics::compute(const Image3D& velocity, const Image3D& obstacle, const Image3D& density, const glm::uvec3& gridSize, float deltaTime)
+	{
+		update();
+
+		// Slot is still in flight, skip step rather than wait
+		if (mFences[mSlot]) return;
+
+		auto& renderer = system::Renderer::getInstance();
+
+		// Work group size may change while stages are tuned
+		auto size = renderer.getWorkGroupTuner().getWorkGroupSize(WorkGroupTuner::getStageKey("reduceStats", gridSize));
+		auto groups = (gridSize + size - glm::uvec3(1)) / size;
+		GLuint partialCount = groups.x * groups.y * groups.z;
+
+		reservePartials(partialCount);
+
+		// First pass reduces grid into partials of work groups
+		auto pipeline = renderer.getComputePipeline("reduceStats", gridSize);
+		pipeline->Bind();
+		pipeline->SetUniform("activeThreshold", activeThreshold);
+
+		StateCache::getInstance().bindTexture(0, velocity.getObjectID());
+		StateCache::getInstance().bindTexture(1, obstacle.getObjectID());
+		StateCache::getInstance().bindTexture(2, density.getObjectID());
+		StateCache::getInstance().bindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, mPartialBuffer);
+
+		renderer.dispatchCompute("reduceStats", gridSize);
+		pipeline->Unbind();
+
+		GL_CHECK(glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT));
+
+		// Final pass reduces partials into result slot
+		auto finalPipeline = renderer.getPipelineByName("reduceStatsFinal").get();
+		finalPipeline->Bind();
+		finalPipeline->SetUniform("partialCount", partialCount);
+		finalPipeline->SetUniform("resultIndex", mSlot);
+
+		StateCache::getInstance().bindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, mResultBuffer);
+
+		GL_CHECK(glDispatchCompute(1, 1, 1));
+		finalPipeline->Unbind();
+
+		// Result becomes visible to mapped pointer once fence is signaled
+		GL_CHECK(glMemoryBarrier(GL_CLIENT_MAPPED_BUFFER_BARRIER_BIT));
+		GL_CHECK(mFences[mSlot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+
+		mTimeSteps[mSlot] = deltaTime;
+		mSlot = (mSlot + 1) % mFences.size();
+	}
+
+	void SimulationStatistics::update()
+	{
+		// Oldest slot in flight is the one written next
+		for (size_t i = 0; i < mFences.size(); ++i)
+		{
+			auto slot = (mSlot + i) % mFences.size();
+			GLsync fence = mFences[slot];
+
+			if (!fence) continue;
+
+			GLenum status;
+			GL_CHECK(status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0));
+
+			// Later slots cannot be finished either
+			if (status == GL_TIMEOUT_EXPIRED) break;
+
+			GL_CHECK(glDeleteSync(fence));
+			mFences[slot] = nullptr;
+
+			if (status == GL_WAIT_FAILED)
+			{
+				LOG_WARNING("SimulationStatistics - Waiting for result failed");
+				continue;
+			}
+
+			const Partial& result = mMappedResults[slot];
+
+			mValues.divergenceL2 = result.fluidVoxels > 0 ? std::sqrt(result.divergenceSquared / result.fluidVoxels) : 0.0f;
+			mValues.divergenceMax = result.divergenceMax;
+			mValues.mass = result.mass;
+			mValues.maxVelocity = result.velocityMax;
+			mValues.cfl = result.velocityMax * mTimeSteps[slot];
+			mValues.activeVoxels = result.activeVoxels;
+			mValues.fluidVoxels = result.fluidVoxels;
+			mValues.readCount++;
+		}
+	}
+
+	void SimulationStatistics::reservePartials(GLuint count)
+	{
+		if (count <= mPartialCapacity) return;
+
+		if (mPartialBuffer) StateCache::getInstance().deleteBuffers(1, &mPartialBuffer);
+
+		GL_CHECK(glCreateBuffers(1, &mPartialBuffer));
+		GL_CHECK(glNamedBufferStorage(mPartialBuffer, sizeof(Partial) * count, nullptr, 0));
+		mPartialCapacity = count;
+	}
+}
@@ -0,0 +1,29 @@
+#include "Sphere.h"
+
+#include "IComputeDevice.h"
+
+namespace vfx
+{
+	Sphere::Sphere(IComputeDevice& device, const std::shared_ptr<IVolume>& volume)
+		: Obstacle(device, volume, "ObstacleSphereFill")
+		, radius(0.2f)
+	{
+
+	}
+
+	Sphere::~Sphere()
+	{
+	}
+
+	void Sphere::bindProperties() const
+	{
+		mDevice.setUniform("spherePosition", position);
+		mDevice.setUniform("sphereRadius", radius);
+	}
+
+	void Sphere::reset()
+	{
+		position = glm::vec3(0.5f);
+		radius = 0.2f;
+	}
+}
\ No newline at end of file
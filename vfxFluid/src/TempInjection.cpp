@@ -1,37 +1,35 @@
-#pragma once
-
-#include "TempInjection.h"
-#include "Quantity.h"
-#include "Image3D.h"
-
-#include "vfxEngine.h"
-
-namespace vfx
-{
-	void TempInjection::inject(Quantity* quantity, const glm::vec3& position, float deltaTime)
-	{
-		auto pipeline = system::Renderer::getInstance().getPipelineByName("injection1D");
-		pipeline->Bind();
-
-		pipeline->SetUniform("deltaTime", deltaTime);
-		pipeline->SetUniform("injectionPosition", position);
-		pipeline->SetUniform("sigma", quantity->getProperty<float>("sigma"));
-		pipeline->SetUniform("intensity", quantity->getProperty<float>("intensity"));
-
-		auto ping = quantity->ping();
-		auto pong = quantity->pong();
-
-		auto pongSize = static_cast<glm::uvec3>(pong->getSize());
-
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_3D, ping->getObjectID());
-
-		glBindImageTexture(0, pong->getObjectID(), 0, GL_TRUE, 0, GL_WRITE_ONLY, pong->getFormat());
-
-		glDispatchCompute(pongSize.x / 8, pongSize.y / 8, pongSize.z / 8);
-		glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
-		pipeline->Unbind();
-
-		quantity->swap();
-	}
+#include "TempInjection.h"
+#include "IComputeDevice.h"
+#include "Quantity.h"
+
+namespace vfx
+{
+	TempInjection::TempInjection(IComputeDevice& device)
+		: mDevice(device)
+	{
+	}
+
+	void TempInjection::inject(Quantity* quantity, const glm::vec3& position, float deltaTime)
+	{
+		auto pongSize = static_cast<glm::uvec3>(quantity->pong()->getSize());
+		mDevice.bindKernel("injection1D", pongSize);
+
+		mDevice.setUniform("deltaTime", deltaTime);
+		mDevice.setUniform("injectionPosition", position);
+		mDevice.setUniform("sigma", quantity->getProperty<float>("sigma"));
+		mDevice.setUniform("intensity", glm::vec4(quantity->getProperty<float>("intensity"), 0.0f, 0.0f, 0.0f));
+
+		auto ping = quantity->ping();
+		auto pong = quantity->pong();
+
+		mDevice.bindVolume(0, *ping);
+
+		mDevice.bindTarget(0, *pong);
+
+		mDevice.dispatch();
+		mDevice.barrier(Barrier::ImageAccess);
+		mDevice.unbindKernel();
+
+		quantity->swap();
+	}
 }
\ No newline at end of file
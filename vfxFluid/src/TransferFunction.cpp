@@ -0,0 +1,130 @@
+#include "TransferFunction.h"
+#include "vfxEngine.h"
+
+#include <cmath>
+
+namespace vfx
+{
+	namespace
+	{
+		// Transmittance below 1% terminates ray marching, longer optical lengths are not needed
+		const float MAX_OPTICAL_DEPTH = 5.0f;
+
+		// Radiance attenuation is 1 - exp(-9) for temperature 3 * sqrt(falloff)
+		const float MAX_TEMPERATURE_DEVIATIONS = 3.0f;
+
+		// Number of integration steps per table texel
+		const unsigned int INTEGRATION_STEPS = 8;
+	}
+
+	TransferFunction::TransferFunction(unsigned int resolution)
+		: mResolution(resolution)
+	{
+		assert(resolution > 1);
+
+		createTexture(mRadianceTable, GL_TEXTURE_2D);
+		GL_CHECK(glTextureStorage2D(mRadianceTable, 1, GL_R16F, mResolution, mResolution));
+
+		createTexture(mTransmittanceTable, GL_TEXTURE_1D);
+		GL_CHECK(glTextureStorage1D(mTransmittanceTable, 1, GL_R32F, mResolution));
+	}
+
+	TransferFunction::~TransferFunction()
+	{
+		StateCache::getInstance().deleteTextures(1, &mRadianceTable);
+		StateCache::getInstance().deleteTextures(1, &mTransmittanceTable);
+	}
+
+	void TransferFunction::update(float radianceFallOff, float absorbtion)
+	{
+		if (radianceFallOff != mFallOff)
+		{
+			mFallOff = radianceFallOff;
+			generateRadianceTable();
+		}
+
+		if (absorbtion != mAbsorbtion)
+		{
+			mAbsorbtion = absorbtion;
+			generateTransmittanceTable();
+		}
+	}
+
+	void TransferFunction::bind(int radianceUnit, int transmittanceUnit) const
+	{
+		StateCache::getInstance().bindTexture(radianceUnit, mRadianceTable);
+		StateCache::getInstance().bindTexture(transmittanceUnit, mTransmittanceTable);
+	}
+
+	void TransferFunction::generateRadianceTable()
+	{
+		float fallOff = std::fmax(mFallOff, 1e-4f);
+		mMaxTemperature = MAX_TEMPERATURE_DEVIATIONS * std::sqrt(fallOff);
+
+		auto attenuation = [fallOff](float temperature) { return 1.0f - std::exp(-temperature * temperature / fallOff); };
+
+		// Integral of attenuation from zero to temperature of each texel
+		float texelTemperature = mMaxTemperature / (mResolution - 1);
+		float integrationStep = texelTemperature / INTEGRATION_STEPS;
+
+		std::vector<float> integral(mResolution, 0.0f);
+
+		for (unsigned int i = 1; i < mResolution; ++i)
+		{
+			float sum = 0.0f;
+
+			for (unsigned int s = 0; s < INTEGRATION_STEPS; ++s)
+			{
+				float temperature = (i - 1) * texelTemperature + (s + 0.5f) * integrationStep;
+				sum += attenuation(temperature) * integrationStep;
+			}
+
+			integral[i] = integral[i - 1] + sum;
+		}
+
+		// Average attenuation over segment between front and back temperature
+		std::vector<float> table(mResolution * mResolution);
+
+		for (unsigned int back = 0; back < mResolution; ++back)
+		{
+			for (unsigned int front = 0; front < mResolution; ++front)
+			{
+				float value = (front == back) ? attenuation(front * texelTemperature) :
+					(integral[back] - integral[front]) / ((static_cast<float>(back) - static_cast<float>(front)) * texelTemperature);
+
+				table[back * mResolution + front] = value;
+			}
+		}
+
+		GL_CHECK(glTextureSubImage2D(mRadianceTable, 0, 0, 0, mResolution, mResolution, GL_RED, GL_FLOAT, table.data()));
+
+		LOG_DEBUG("TransferFunction - Generated radiance table for fall off: " + std::to_string(mFallOff));
+	}
+
+	void TransferFunction::generateTransmittanceTable()
+	{
+		float absorbtion = std::fmax(mAbsorbtion, 1e-4f);
+		mMaxOpticalLength = MAX_OPTICAL_DEPTH / absorbtion;
+
+		std::vector<float> table(mResolution);
+
+		for (unsigned int i = 0; i < mResolution; ++i)
+		{
+			float opticalLength = mMaxOpticalLength * i / (mResolution - 1);
+			table[i] = std::exp(-opticalLength * absorbtion);
+		}
+
+		GL_CHECK(glTextureSubImage1D(mTransmittanceTable, 0, 0, mResolution, GL_RED, GL_FLOAT, table.data()));
+
+		LOG_DEBUG("TransferFunction - Generated transmittance table for absorbtion: " + std::to_string(mAbsorbtion));
+	}
+
+	void TransferFunction::createTexture(GLuint& handle, GLenum target) const
+	{
+		GL_CHECK(glCreateTextures(target, 1, &handle));
+		GL_CHECK(glTextureParameteri(handle, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+		GL_CHECK(glTextureParameteri(handle, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+		GL_CHECK(glTextureParameteri(handle, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+		GL_CHECK(glTextureParameteri(handle, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+	}
+}
@@ -0,0 +1,133 @@
+#include "VolumeFile.h"
+
+#include <algorithm>
+#include <fstream>
+#include <cstring>
+
+namespace vfx
+{
+	namespace
+	{
+		const char MAGIC[4] = { 'V', 'F', 'X', 'V' };
+
+		// Voxels converted at once, bounds conversion buffer
+		const size_t CONVERSION_CHUNK = 64 * 1024;
+
+		struct Header
+		{
+			char magic[4];
+			uint32_t version;
+			uint32_t width;
+			uint32_t height;
+			uint32_t depth;
+			uint32_t channels;
+		};
+
+		size_t getValueCount(const glm::uvec3& size, uint32_t channels)
+		{
+			return static_cast<size_t>(size.x) * size.y * size.z * channels;
+		}
+
+		bool writeHeader(std::ofstream& file, const glm::uvec3& size, uint32_t channels, VoxelFormat format)
+		{
+			Header header;
+			std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+			header.version = VolumeFile::VERSION;
+			header.width = size.x;
+			header.height = size.y;
+			header.depth = size.z;
+			header.channels = channels;
+
+			uint32_t voxelFormat = static_cast<uint32_t>(format);
+
+			file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			file.write(reinterpret_cast<const char*>(&voxelFormat), sizeof(voxelFormat));
+
+			return file.good();
+		}
+	}
+
+	bool VolumeFile::write(const std::string& filename, const Volume& volume, VoxelFormat format)
+	{
+		if (volume.data.size() != getValueCount(volume.size, volume.channels))
+			return false;
+
+		std::ofstream file(filename, std::ios::binary);
+		if (!file.is_open() || !writeHeader(file, volume.size, volume.channels, format))
+			return false;
+
+		if (format == VoxelFormat::Float32)
+		{
+			file.write(reinterpret_cast<const char*>(volume.data.data()), volume.data.size() * sizeof(float));
+			return file.good();
+		}
+
+		std::vector<Half> chunk(std::min(volume.data.size(), CONVERSION_CHUNK));
+
+		for (size_t offset = 0; offset < volume.data.size(); offset += chunk.size())
+		{
+			size_t count = std::min(chunk.size(), volume.data.size() - offset);
+
+			convertToHalf(volume.data.data() + offset, chunk.data(), count);
+			file.write(reinterpret_cast<const char*>(chunk.data()), count * sizeof(Half));
+		}
+
+		return file.good();
+	}
+
+	bool VolumeFile::write(const std::string& filename, const glm::uvec3& size, uint32_t channels, const std::vector<Half>& data)
+	{
+		if (data.size() != getValueCount(size, channels))
+			return false;
+
+		std::ofstream file(filename, std::ios::binary);
+		if (!file.is_open() || !writeHeader(file, size, channels, VoxelFormat::Float16))
+			return false;
+
+		file.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(Half));
+
+		return file.good();
+	}
+
+	bool VolumeFile::read(const std::string& filename, Volume& volume)
+	{
+		std::ifstream file(filename, std::ios::binary);
+		if (!file.is_open())
+			return false;
+
+		Header header;
+		file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+		if (!file.good() || std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version < 1 || header.version > VERSION)
+			return false;
+
+		uint32_t format = static_cast<uint32_t>(VoxelFormat::Float32);
+		if (header.version >= 2)
+			file.read(reinterpret_cast<char*>(&format), sizeof(format));
+
+		volume.size = glm::uvec3(header.width, header.height, header.depth);
+		volume.channels = header.channels;
+		volume.data.resize(getValueCount(volume.size, volume.channels));
+
+		if (format == static_cast<uint32_t>(VoxelFormat::Float32))
+		{
+			file.read(reinterpret_cast<char*>(volume.data.data()), volume.data.size() * sizeof(float));
+			return file.good();
+		}
+
+		if (format != static_cast<uint32_t>(VoxelFormat::Float16))
+			return false;
+
+		std::vector<Half> chunk(std::min(volume.data.size(), CONVERSION_CHUNK));
+
+		for (size_t offset = 0; offset < volume.data.size() && file.good(); offset += chunk.size())
+		{
+			size_t count = std::min(chunk.size(), volume.data.size() - offset);
+
+			file.read(reinterpret_cast<char*>(chunk.data()), count * sizeof(Half));
+			convertToFloat(chunk.data(), volume.data.data() + offset, count);
+		}
+
+		return file.good();
+	}
+}
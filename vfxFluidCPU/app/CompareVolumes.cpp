@@ -0,0 +1,141 @@
+#include "VolumeFile.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+	// Errors are relative to peak magnitude of reference channel. GPU stores quantities
+	// as halves and filters with reduced precision, rounding differences grow with steps
+	// as flow is chaotic. Float and half storage on CPU differ by 0.6 % (max) and 0.005 %
+	// (RMS) after 25 steps of 64^3 grid, but by 35 % and 1 % after 100 steps, so tolerance
+	// holds for short runs only
+	const double DEFAULT_MAX_ERROR = 0.05;
+	const double DEFAULT_RMS_ERROR = 0.005;
+
+	// Exit codes, invalid input is distinguished from exceeded tolerance
+	const int EXIT_EXCEEDED = 1;
+	const int EXIT_INVALID = 2;
+
+	/// \brief	Difference of single channel of two volumes.
+	struct ChannelError
+	{
+		double peak = 0.0;		//!< Maximum magnitude of reference channel.
+		double max = 0.0;		//!< Maximum absolute difference.
+		double rms = 0.0;		//!< Root mean square of differences.
+	};
+
+	void printUsage()
+	{
+		std::cout << "Usage: vfxCompareVolumes <reference.vfxv> <volume.vfxv> [options]\n"
+				  << "Compares volumes per channel, errors are relative to peak magnitude of reference channel.\n"
+				  << "  --max <value>              tolerance of maximum error (default: " << DEFAULT_MAX_ERROR << ")\n"
+				  << "  --rms <value>              tolerance of RMS error (default: " << DEFAULT_RMS_ERROR << ")\n"
+				  << "Returns 0 if all channels are within tolerance, " << EXIT_EXCEEDED << " if not, " << EXIT_INVALID << " on invalid input.\n";
+	}
+
+	std::vector<ChannelError> compare(const vfx::Volume& reference, const vfx::Volume& volume)
+	{
+		std::vector<ChannelError> errors(reference.channels);
+		size_t voxels = reference.data.size() / std::max(reference.channels, 1u);
+
+		for (size_t voxel = 0; voxel < voxels; ++voxel)
+		{
+			for (uint32_t channel = 0; channel < reference.channels; ++channel)
+			{
+				size_t index = voxel * reference.channels + channel;
+				double difference = std::abs(static_cast<double>(reference.data[index]) - volume.data[index]);
+
+				auto& error = errors[channel];
+				error.peak = std::max(error.peak, std::abs(static_cast<double>(reference.data[index])));
+				error.max = std::max(error.max, difference);
+				error.rms += difference * difference;
+			}
+		}
+
+		for (auto& error : errors)
+			error.rms = std::sqrt(error.rms / std::max<size_t>(voxels, 1));
+
+		return errors;
+	}
+
+	/// \brief	Errors of channel relative to its peak, absolute ones for empty channel.
+	double relative(double error, double peak)
+	{
+		return peak > 0.0 ? error / peak : error;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	std::vector<std::string> files;
+	double maxTolerance = DEFAULT_MAX_ERROR;
+	double rmsTolerance = DEFAULT_RMS_ERROR;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		int remaining = argc - i - 1;
+
+		if (arg == "--max" && remaining >= 1) maxTolerance = std::atof(argv[++i]);
+		else if (arg == "--rms" && remaining >= 1) rmsTolerance = std::atof(argv[++i]);
+		else if (arg == "--help" || arg == "-h")
+		{
+			printUsage();
+			return EXIT_SUCCESS;
+		}
+		else if (arg.compare(0, 2, "--") != 0) files.push_back(arg);
+		else
+		{
+			printUsage();
+			return EXIT_INVALID;
+		}
+	}
+
+	if (files.size() != 2 || !(maxTolerance > 0.0) || !(rmsTolerance > 0.0))
+	{
+		printUsage();
+		return EXIT_INVALID;
+	}
+
+	vfx::Volume reference, volume;
+	if (!vfx::VolumeFile::read(files[0], reference) || !vfx::VolumeFile::read(files[1], volume))
+	{
+		std::cerr << "Failed to read volumes " << files[0] << " and " << files[1] << "\n";
+		return EXIT_INVALID;
+	}
+
+	if (reference.size != volume.size || reference.channels != volume.channels)
+	{
+		std::cerr << "Volumes differ in size or number of channels\n";
+		return EXIT_INVALID;
+	}
+
+	auto errors = compare(reference, volume);
+	bool passed = true;
+
+	std::cout << "channel,peak,max,rms,relative_max,relative_rms\n" << std::setprecision(6);
+
+	for (size_t channel = 0; channel < errors.size(); ++channel)
+	{
+		const auto& error = errors[channel];
+		double maxError = relative(error.max, error.peak);
+		double rmsError = relative(error.rms, error.peak);
+
+		std::cout << channel << "," << error.peak << "," << error.max << "," << error.rms << "," << maxError << "," << rmsError << "\n";
+
+		// NaN never passes
+		if (!(maxError <= maxTolerance) || !(rmsError <= rmsTolerance))
+			passed = false;
+	}
+
+	if (!passed)
+		std::cerr << "Volumes differ by more than tolerance (max " << maxTolerance << ", rms " << rmsTolerance << ")\n";
+
+	return passed ? EXIT_SUCCESS : EXIT_EXCEEDED;
+}
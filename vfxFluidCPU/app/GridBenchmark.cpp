@@ -0,0 +1,266 @@
+#include "Kernels.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace vfx;
+using namespace vfx::cpu;
+
+namespace
+{
+	/// \brief	Stencil throughput of single layout.
+	struct Result
+	{
+		double jacobi = 0.0;		//!< Million voxels per second of 7-point Jacobi iteration.
+		double advection = 0.0;		//!< Million voxels per second of 8-tap trilinear back tracing.
+		double storage = 0.0;		//!< Storage of one scalar grid [MB].
+		double checksum = 0.0;		//!< Sum of results, equal for all layouts.
+	};
+
+	void printUsage()
+	{
+		std::cout << "Usage: vfxGridBenchmark [options]\n"
+				  << "  --size <x> <y> <z>         grid size (default: 128 128 128)\n"
+				  << "  --iterations <n>           Jacobi iterations and advection repetitions (default: 20)\n";
+	}
+
+	double millionVoxelsPerSecond(size_t voxels, const std::chrono::steady_clock::duration& elapsed)
+	{
+		return voxels / std::chrono::duration<double, std::micro>(elapsed).count();
+	}
+
+	/// \brief	Runs stencils of pressure solver and advection single threaded,
+	///			so results show memory behaviour of layout only.
+	template<typename Layout>
+	Result benchmark(const glm::uvec3& size, int iterations)
+	{
+		typedef Grid3D<float, Layout> Scalar;
+
+		const glm::ivec3 gridSize(size);
+		Scalar divergence(size), obstacle(size), pressure(size), target(size), quantity(size), advected(size);
+
+		// Obstacle at boundary, smooth divergence and quantity
+		for (int z = 0; z < gridSize.z; ++z)
+		{
+			for (int y = 0; y < gridSize.y; ++y)
+			{
+				for (int x = 0; x < gridSize.x; ++x)
+				{
+					glm::vec3 coordinate = (glm::vec3(x, y, z) + 0.5f) / glm::vec3(size);
+					bool boundary = x == 0 || y == 0 || z == 0 || x == gridSize.x - 1 || y == gridSize.y - 1 || z == gridSize.z - 1;
+
+					obstacle.at(x, y, z) = boundary ? 0.1f : 0.0f;
+					divergence.at(x, y, z) = std::sin(6.0f * coordinate.x) * std::cos(4.0f * coordinate.y) * coordinate.z;
+					quantity.at(x, y, z) = coordinate.x * coordinate.y + coordinate.z;
+				}
+			}
+		}
+
+		Result result;
+		result.storage = pressure.getStorageSize() * sizeof(float) / (1024.0 * 1024.0);
+
+		// Jacobi iterations as jacobi.comp, neighbour in obstacle takes center pressure
+		const float* o = obstacle.data();
+		const float* d = divergence.data();
+
+		auto start = std::chrono::steady_clock::now();
+
+		for (int iteration = 0; iteration < iterations; ++iteration)
+		{
+			const float* p = pressure.data();
+			float* output = target.data();
+
+			for (int z = 0; z < gridSize.z; ++z)
+			{
+				for (int y = 0; y < gridSize.y; ++y)
+				{
+					for (auto it = pressure.stencil(y, z); it.isValid(); it.next())
+					{
+						const float center = p[it.center()];
+						float sum = (o[it.left()] > 0.0f ? center : p[it.left()]) + (o[it.right()] > 0.0f ? center : p[it.right()]) +
+									(o[it.down()] > 0.0f ? center : p[it.down()]) + (o[it.up()] > 0.0f ? center : p[it.up()]) +
+									(o[it.backward()] > 0.0f ? center : p[it.backward()]) + (o[it.forward()] > 0.0f ? center : p[it.forward()]);
+
+						output[it.center()] = (sum - d[it.center()]) / 6.0f;
+					}
+				}
+			}
+
+			pressure.swap(target);
+		}
+
+		result.jacobi = millionVoxelsPerSecond(pressure.getVoxelCount() * iterations, std::chrono::steady_clock::now() - start);
+
+		// Back tracing along swirling velocity, samples stay few voxels around voxel.
+		// Velocity components depend on single coordinate, so they are tabulated
+		std::vector<float> velocityX(gridSize.x), velocityY(gridSize.y), velocityZ(gridSize.z);
+		for (int x = 0; x < gridSize.x; ++x) velocityZ[x] = std::sin(0.1f * x);
+		for (int y = 0; y < gridSize.y; ++y) velocityX[y] = std::sin(0.1f * y);
+		for (int z = 0; z < gridSize.z; ++z) velocityY[z] = std::cos(0.1f * z);
+
+		start = std::chrono::steady_clock::now();
+
+		for (int iteration = 0; iteration < iterations; ++iteration)
+		{
+			for (int z = 0; z < gridSize.z; ++z)
+			{
+				for (int y = 0; y < gridSize.y; ++y)
+				{
+					for (int x = 0; x < gridSize.x; ++x)
+					{
+						glm::vec3 velocity(velocityX[y], velocityY[z], velocityZ[x]);
+						glm::vec3 position = glm::vec3(x, y, z) - velocity * static_cast<float>(iteration % 4 + 1);
+
+						advected.at(x, y, z) = quantity.sample((position + 0.5f) / glm::vec3(size));
+					}
+				}
+			}
+		}
+
+		result.advection = millionVoxelsPerSecond(advected.getVoxelCount() * iterations, std::chrono::steady_clock::now() - start);
+
+		for (int z = 0; z < gridSize.z; ++z)
+		{
+			for (int y = 0; y < gridSize.y; ++y)
+			{
+				for (int x = 0; x < gridSize.x; ++x)
+					result.checksum += pressure.at(x, y, z) + advected.at(x, y, z);
+			}
+		}
+
+		return result;
+	}
+
+	/// \brief	Runs vectorized Jacobi kernel on single thread, grids store T.
+	///
+	/// \param pressure Resulting pressure converted to float.
+	/// \return Million voxels per second.
+	template<typename T>
+	double benchmarkJacobiKernel(const ScalarGrid& divergence, const ScalarGrid& obstacle, int iterations, ScalarGrid& pressure)
+	{
+		ThreadPool pool(1);
+
+		Grid<T> d, o, p, target;
+		d.convert(divergence);
+		o.convert(obstacle);
+		p.resize(divergence.getSize());
+		target.resize(divergence.getSize());
+
+		auto start = std::chrono::steady_clock::now();
+
+		for (int iteration = 0; iteration < iterations; ++iteration)
+		{
+			jacobi(d, o, p, target, pool);
+			p.swap(target);
+		}
+
+		double throughput = millionVoxelsPerSecond(p.getVoxelCount() * iterations, std::chrono::steady_clock::now() - start);
+
+		pressure.convert(p);
+		return throughput;
+	}
+
+	/// \brief	Compares Jacobi kernel on float and half grids, reports error
+	///			of half pressure against float one.
+	void reportHalf(const glm::uvec3& size, int iterations)
+	{
+		const glm::ivec3 gridSize(size);
+		ScalarGrid divergence(size), obstacle(size);
+
+		for (int z = 0; z < gridSize.z; ++z)
+		{
+			for (int y = 0; y < gridSize.y; ++y)
+			{
+				for (int x = 0; x < gridSize.x; ++x)
+				{
+					glm::vec3 coordinate = (glm::vec3(x, y, z) + 0.5f) / glm::vec3(size);
+					bool boundary = x == 0 || y == 0 || z == 0 || x == gridSize.x - 1 || y == gridSize.y - 1 || z == gridSize.z - 1;
+
+					obstacle.at(x, y, z) = boundary ? 0.1f : 0.0f;
+					divergence.at(x, y, z) = std::sin(6.0f * coordinate.x) * std::cos(4.0f * coordinate.y) * coordinate.z;
+				}
+			}
+		}
+
+		ScalarGrid pressure, halfPressure;
+		double floatThroughput = benchmarkJacobiKernel<float>(divergence, obstacle, iterations, pressure);
+		double halfThroughput = benchmarkJacobiKernel<Half>(divergence, obstacle, iterations, halfPressure);
+
+		float maxError = 0.0f;
+		for (size_t voxel = 0; voxel < pressure.getVoxelCount(); ++voxel)
+			maxError = std::max(maxError, std::abs(pressure.data()[voxel] - halfPressure.data()[voxel]));
+
+		const double megabytes = 1024.0 * 1024.0;
+
+		std::cout << "\nJacobi kernel (" << getSimdName() << ", " << getHalfConversionName() << " conversion), single thread\n"
+				  << std::left << std::setw(14) << "storage" << std::right
+				  << std::setw(12) << "jacobi" << std::setw(12) << "storage" << std::setw(16) << "max error" << "\n"
+				  << std::left << std::setw(14) << "float" << std::right << std::fixed
+				  << std::setw(12) << std::setprecision(1) << floatThroughput
+				  << std::setw(12) << std::setprecision(1) << pressure.getVoxelCount() * sizeof(float) / megabytes << "\n"
+				  << std::left << std::setw(14) << "half" << std::right
+				  << std::setw(12) << std::setprecision(1) << halfThroughput
+				  << std::setw(12) << std::setprecision(1) << pressure.getVoxelCount() * sizeof(Half) / megabytes
+				  << std::setw(16) << std::setprecision(6) << maxError << "\n";
+	}
+
+	template<typename Layout>
+	void report(const glm::uvec3& size, int iterations)
+	{
+		Result result = benchmark<Layout>(size, iterations);
+
+		std::cout << std::left << std::setw(14) << Layout::getName() << std::right << std::fixed
+				  << std::setw(12) << std::setprecision(1) << result.jacobi
+				  << std::setw(12) << std::setprecision(1) << result.advection
+				  << std::setw(12) << std::setprecision(1) << result.storage
+				  << std::setw(16) << std::setprecision(6) << result.checksum << "\n";
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	glm::uvec3 size(128);
+	int iterations = 20;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		int remaining = argc - i - 1;
+
+		auto nextUInt = [&]() { return static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10)); };
+
+		if (arg == "--size" && remaining >= 3) { size.x = nextUInt(); size.y = nextUInt(); size.z = nextUInt(); }
+		else if (arg == "--iterations" && remaining >= 1) iterations = static_cast<int>(nextUInt());
+		else
+		{
+			printUsage();
+			return arg == "--help" || arg == "-h" ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+	}
+
+	if (size.x < 2 || size.y < 2 || size.z < 2 || iterations < 1)
+	{
+		printUsage();
+		return EXIT_FAILURE;
+	}
+
+	std::cout << "Grid " << size.x << "x" << size.y << "x" << size.z << ", " << iterations << " iterations, single thread\n"
+			  << std::left << std::setw(14) << "layout" << std::right
+			  << std::setw(12) << "jacobi" << std::setw(12) << "advection" << std::setw(12) << "storage" << std::setw(16) << "checksum" << "\n"
+			  << std::left << std::setw(14) << "" << std::right
+			  << std::setw(12) << "[Mvox/s]" << std::setw(12) << "[Mvox/s]" << std::setw(12) << "[MB]" << "\n";
+
+	report<LinearLayout>(size, iterations);
+	report<BrickedLayout<4>>(size, iterations);
+	report<BrickedLayout<8>>(size, iterations);
+	report<MortonLayout>(size, iterations);
+
+	reportHalf(size, iterations);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,119 @@
+#include "ComputeDevice.h"
+#include "FluidSimulation.h"
+#include "Kernels.h"
+#include "Quantity.h"
+#include "VolumeFile.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace
+{
+	void printUsage()
+	{
+		std::cout << "Usage: vfxSimulateCPU [options]\n"
+				  << "Runs stages of GPU simulation on CPU compute device.\n"
+				  << "  --size <x> <y> <z>         grid size (default: 64 64 64)\n"
+				  << "  --steps <n>                simulation steps (default: 100)\n"
+				  << "  --dt <value>               time step (default: 1/60)\n"
+				  << "  --threads <n>              worker threads (default: all cores)\n"
+				  << "  --obstacle <index>         0 - boundary, 1 - sphere, 2 - box (default: 0)\n"
+				  << "  --iterations <n>           Jacobi iterations (default: 20)\n"
+				  << "  --semi-lagrangian          advect density and temperature by Semi-Lagrangian advection\n"
+				  << "  --output <prefix>          export density and temperature volumes after last step\n"
+				  << "  --half                     round 16F volumes to halves and export halves, as GPU simulation does\n";
+	}
+
+	bool exportVolume(vfx::IComputeDevice& device, const vfx::IVolume& volume, const std::string& filename, vfx::VoxelFormat format)
+	{
+		vfx::Volume data;
+		device.readback(volume, data);
+
+		return vfx::VolumeFile::write(filename, data, format);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	glm::uvec3 size(64);
+	unsigned int steps = 100;
+	unsigned int threads = 0;
+	unsigned int obstacle = 0;
+	int iterations = 20;
+	float deltaTime = 1.0f / 60.0f;
+	bool macCormack = true;
+	std::string output;
+	bool halfPrecision = false;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		int remaining = argc - i - 1;
+
+		auto nextUInt = [&]() { return static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10)); };
+
+		if (arg == "--size" && remaining >= 3) { size.x = nextUInt(); size.y = nextUInt(); size.z = nextUInt(); }
+		else if (arg == "--steps" && remaining >= 1) steps = nextUInt();
+		else if (arg == "--dt" && remaining >= 1) deltaTime = static_cast<float>(std::atof(argv[++i]));
+		else if (arg == "--threads" && remaining >= 1) threads = nextUInt();
+		else if (arg == "--obstacle" && remaining >= 1) obstacle = nextUInt();
+		else if (arg == "--iterations" && remaining >= 1) iterations = static_cast<int>(nextUInt());
+		else if (arg == "--semi-lagrangian") macCormack = false;
+		else if (arg == "--output" && remaining >= 1) output = argv[++i];
+		else if (arg == "--half") halfPrecision = true;
+		else
+		{
+			printUsage();
+			return arg == "--help" || arg == "-h" ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+	}
+
+	if (size.x < 2 || size.y < 2 || size.z < 2)
+	{
+		std::cerr << "Grid has to be at least 2 voxels in each dimension\n";
+		return EXIT_FAILURE;
+	}
+
+	if (obstacle > 2)
+	{
+		std::cerr << "Obstacle index has to be 0, 1 or 2\n";
+		return EXIT_FAILURE;
+	}
+
+	vfx::cpu::ComputeDevice device(threads, halfPrecision);
+
+	// Stage sequence of GPU simulation, volumes are allocated by CPU device
+	vfx::FluidSimulation simulation(device);
+	simulation.resize(size);
+	simulation.changeObstacle(obstacle);
+	simulation.pressure.iterations = iterations;
+	simulation.useMacCormackAdvection = macCormack;
+
+	std::cout << "Simulating " << size.x << "x" << size.y << "x" << size.z << " grid on " << device.getPool().getThreadCount()
+			  << " threads (" << vfx::cpu::getSimdName() << (halfPrecision ? ", half precision" : "") << ")\n";
+
+	auto start = std::chrono::steady_clock::now();
+
+	for (unsigned int step = 0; step < steps; ++step)
+		simulation.simulate(deltaTime, deltaTime);
+
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << steps << " steps in " << elapsed.count() << " ms, " << elapsed.count() / std::max(steps, 1u) << " ms per step\n";
+
+	// Volumes are named as Fluid::exportVolumes names them
+	auto outputFormat = halfPrecision ? vfx::VoxelFormat::Float16 : vfx::VoxelFormat::Float32;
+
+	if (!output.empty() &&
+		(!exportVolume(device, *simulation.getDensity().ping(), output + "_density.vfxv", outputFormat) ||
+		 !exportVolume(device, *simulation.getTemperature().ping(), output + "_temperature.vfxv", outputFormat)))
+	{
+		std::cerr << "Failed to export volumes " << output << "\n";
+		return EXIT_FAILURE;
+	}
+
+
+	return EXIT_SUCCESS;
+}
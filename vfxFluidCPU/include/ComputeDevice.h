@@ -0,0 +1,123 @@
+#pragma once
+
+#include "Grid.h"
+#include "ThreadPool.h"
+#include "IComputeDevice.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace vfx
+{
+	namespace cpu
+	{
+		/// \brief	Volume of CPU compute device.
+		///
+		///			Single channel formats are stored in scalar grid, others in vector
+		///			grid. Grids are content of the handle, kernels write them through
+		///			const volume as GPU writes images.
+		class GridVolume : public IVolume
+		{
+		public:
+			GridVolume(const glm::uvec3& size, VolumeFormat format);
+
+			glm::vec3 getSize() const override;
+			VolumeFormat getVolumeFormat() const override { return mFormat; }
+			void reset() override;
+
+			bool isScalar() const { return getFormatChannels(mFormat) == 1; }
+
+			ScalarGrid& getScalar() const { return mScalar; }
+			VectorGrid& getVector() const { return mVector; }
+
+		private:
+			VolumeFormat mFormat;
+			mutable ScalarGrid mScalar;		//!< Storage of single channel formats.
+			mutable VectorGrid mVector;		//!< Storage of two and four channel formats.
+		};
+
+		/// \brief	Compute device running kernels on thread pool.
+		///
+		///			Kernels of simulation pipelines are registered on construction,
+		///			dispatch runs them synchronously so barriers are no-ops. With
+		///			half precision, targets of 16F formats are rounded to halves after
+		///			dispatch, so results keep precision of GPU images. Grids store
+		///			floats either way, half grids are used by vfxGridBenchmark only.
+		class ComputeDevice : public IComputeDevice
+		{
+		public:
+			static const unsigned int MaxUnits = 8;
+
+			/// \brief	Volumes and parameters bound for dispatch.
+			struct Dispatch
+			{
+				glm::uvec3 gridSize;
+				const GridVolume* volumes[MaxUnits];
+				const GridVolume* targets[MaxUnits];
+				std::vector<unsigned char> parameters;
+				std::unordered_map<std::string, glm::vec4> uniforms;	//!< Scalars and vectors are widened to vec4.
+
+				const GridVolume& getVolume(unsigned int unit) const;
+				const GridVolume& getTarget(unsigned int unit) const;
+				const glm::vec4& getUniform(const std::string& name) const;
+
+				template<typename T>
+				T getParameters() const
+				{
+					T block = {};
+					std::memcpy(&block, parameters.data(), std::min(sizeof(T), parameters.size()));
+					return block;
+				}
+			};
+
+			typedef std::function<void(const Dispatch&, ThreadPool&)> Kernel;
+
+			/// \param threads Number of threads (0 - all hardware threads).
+			/// \param halfPrecision Round 16F volumes to halves as GPU stores them.
+			explicit ComputeDevice(unsigned int threads = 0, bool halfPrecision = false);
+
+			/// \brief	Registers kernel, kernel of the same name is replaced.
+			void registerKernel(const std::string& name, const Kernel& kernel);
+
+			ThreadPool& getPool() { return mPool; }
+			bool hasHalfPrecision() const { return mHalfPrecision; }
+
+			std::shared_ptr<IVolume> createVolume(const glm::uvec3& size, VolumeFormat format) override;
+
+			void bindKernel(const std::string& name, const glm::uvec3& gridSize) override;
+			void unbindKernel() override;
+
+			void bindVolume(unsigned int unit, const IVolume& volume) override;
+			void bindTarget(unsigned int unit, const IVolume& volume) override;
+
+			void setParameters(const void* data, std::size_t size) override;
+			using IComputeDevice::setParameters;
+
+			void setUniform(const std::string& name, float value) override;
+			void setUniform(const std::string& name, const glm::vec3& value) override;
+			void setUniform(const std::string& name, const glm::vec4& value) override;
+
+			void dispatch() override;
+			void barrier(Barrier) override {}
+			void clear(const IVolume& volume) override;
+			void readback(const IVolume& volume, Volume& data) override;
+
+		private:
+			/// \brief	Registers kernels of pipelines used by simulation stages.
+			void registerSimulationKernels();
+
+			/// \brief	Rounds bound targets of 16F formats to half precision.
+			void roundTargets();
+
+		private:
+			ThreadPool mPool;
+			std::unordered_map<std::string, Kernel> mKernels;
+			const Kernel* mKernel;		//!< Bound kernel.
+			Dispatch mDispatch;			//!< Bindings of bound kernel.
+			bool mHalfPrecision;
+		};
+	}
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Grid3D.h"
+
+namespace vfx
+{
+	namespace cpu
+	{
+		/// \brief	Grid of simulation kernels, linear layout keeps rows contiguous
+		///			for SIMD Jacobi solver and volume export.
+		template<typename T>
+		using Grid = Grid3D<T, LinearLayout>;
+
+		typedef Grid<float> ScalarGrid;
+		typedef Grid<glm::vec4> VectorGrid;
+
+		/// \brief	Scalar grid in half precision as R16F image, kernels convert
+		///			rows to float and compute in float.
+		typedef Grid<Half> HalfGrid;
+	}
+}
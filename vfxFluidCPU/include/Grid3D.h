@@ -0,0 +1,238 @@
+#pragma once
+
+#include "GridLayout.h"
+#include "Half.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace vfx
+{
+	namespace cpu
+	{
+		template<typename Layout>
+		class StencilIterator;
+
+		/// \brief	Converts array of values, float and half arrays are converted in bulk.
+		template<typename From, typename To>
+		void convertValues(const From* source, To* destination, size_t count)
+		{
+			std::copy(source, source + count, destination);
+		}
+
+		inline void convertValues(const float* source, Half* destination, size_t count)
+		{
+			convertToHalf(source, destination, count);
+		}
+
+		inline void convertValues(const Half* source, float* destination, size_t count)
+		{
+			convertToFloat(source, destination, count);
+		}
+
+		/// \brief	Voxel grid of simulation quantity stored in given layout.
+		///
+		///			Accessors mirror GLSL texture access of GPU stages: clamped fetch
+		///			behaves as texelFetch of clamped position and sample as linearly
+		///			filtered texture with clamp to edge wrapping, so kernels can be
+		///			written as in shaders. Storage is addressed by index of layout.
+		template<typename T, typename Layout>
+		class Grid3D
+		{
+		public:
+			typedef Layout LayoutType;
+
+			Grid3D()
+				: mSize(0)
+			{
+			}
+
+			explicit Grid3D(const glm::uvec3& size, const T& value = T(0))
+			{
+				resize(size, value);
+			}
+
+			void resize(const glm::uvec3& size, const T& value = T(0))
+			{
+				mSize = size;
+				mLayout = Layout(size);
+				mData.assign(mLayout.getStorageSize(), value);
+			}
+
+			/// \brief	Copies voxels of grid in any layout, grid is resized to its size.
+			template<typename OtherLayout>
+			void assign(const Grid3D<T, OtherLayout>& other)
+			{
+				resize(other.getSize());
+
+				const glm::ivec3 size(mSize);
+				for (int z = 0; z < size.z; ++z)
+				{
+					for (int y = 0; y < size.y; ++y)
+					{
+						for (int x = 0; x < size.x; ++x)
+							at(x, y, z) = other.at(x, y, z);
+					}
+				}
+			}
+
+			/// \brief	Copies voxels of grid of the same layout converting value type,
+			///			e.g. float grid to half storage. Grid is resized to its size.
+			template<typename U>
+			void convert(const Grid3D<U, Layout>& other)
+			{
+				resize(other.getSize());
+				convertValues(other.data(), data(), getStorageSize());
+			}
+
+			void fill(const T& value) { std::fill(mData.begin(), mData.end(), value); }
+
+			void swap(Grid3D& other)
+			{
+				std::swap(mSize, other.mSize);
+				std::swap(mLayout, other.mLayout);
+				mData.swap(other.mData);
+			}
+
+			const glm::uvec3& getSize() const { return mSize; }
+			const Layout& getLayout() const { return mLayout; }
+
+			size_t getVoxelCount() const { return static_cast<size_t>(mSize.x) * mSize.y * mSize.z; }
+
+			/// \brief	Number of stored voxels including padding of layout.
+			size_t getStorageSize() const { return mData.size(); }
+
+			T* data() { return mData.data(); }
+			const T* data() const { return mData.data(); }
+
+			size_t index(int x, int y, int z) const
+			{
+				return mLayout.offsetX(x) + mLayout.offsetY(y) + mLayout.offsetZ(z);
+			}
+
+			T& at(int x, int y, int z) { return mData[index(x, y, z)]; }
+			const T& at(int x, int y, int z) const { return mData[index(x, y, z)]; }
+
+			T& at(const glm::ivec3& position) { return mData[index(position.x, position.y, position.z)]; }
+			const T& at(const glm::ivec3& position) const { return mData[index(position.x, position.y, position.z)]; }
+
+			/// \brief	Voxel at position clamped to grid.
+			const T& clamped(const glm::ivec3& position) const
+			{
+				return at(glm::clamp(position, glm::ivec3(0), glm::ivec3(mSize) - 1));
+			}
+
+			/// \brief	Fetches 2x2x2 voxels at position and position + 1 clamped to grid,
+			///			corner index is x + 2y + 4z. Offsets are computed per axis
+			///			once instead of per corner.
+			void corners(const glm::ivec3& position, T values[8]) const
+			{
+				const glm::ivec3 last = glm::ivec3(mSize) - 1;
+				const glm::ivec3 p0 = glm::clamp(position, glm::ivec3(0), last);
+				const glm::ivec3 p1 = glm::clamp(position + 1, glm::ivec3(0), last);
+
+				const size_t x[2] = { mLayout.offsetX(p0.x), mLayout.offsetX(p1.x) };
+				const size_t y[2] = { mLayout.offsetY(p0.y), mLayout.offsetY(p1.y) };
+				const size_t z[2] = { mLayout.offsetZ(p0.z), mLayout.offsetZ(p1.z) };
+
+				for (int corner = 0; corner < 8; ++corner)
+					values[corner] = mData[x[corner & 1] + y[(corner >> 1) & 1] + z[corner >> 2]];
+			}
+
+			/// \brief	Trilinear sample at normalized coordinate, voxel centers
+			///			lie at (position + 0.5) / size.
+			T sample(const glm::vec3& coordinate) const
+			{
+				glm::vec3 texel = coordinate * glm::vec3(mSize) - 0.5f;
+				glm::vec3 base = glm::floor(texel);
+				glm::vec3 t = texel - base;
+
+				T c[8];
+				corners(glm::ivec3(base), c);
+
+				T c00 = lerp(c[0], c[1], t.x);
+				T c10 = lerp(c[2], c[3], t.x);
+				T c01 = lerp(c[4], c[5], t.x);
+				T c11 = lerp(c[6], c[7], t.x);
+
+				return lerp(lerp(c00, c10, t.y), lerp(c01, c11, t.y), t.z);
+			}
+
+			/// \brief	Stencil iterator at the first voxel of row.
+			StencilIterator<Layout> stencil(int y, int z) const
+			{
+				return StencilIterator<Layout>(mLayout, mSize, y, z);
+			}
+
+		private:
+			static T lerp(const T& a, const T& b, float t) { return a + (b - a) * t; }
+
+		private:
+			glm::uvec3 mSize;
+			Layout mLayout;
+			std::vector<T> mData;
+		};
+
+		/// \brief	Walks row of grid and yields storage indices of 7-point stencil,
+		///			neighbours are clamped to grid as texelFetch of clamped position.
+		///
+		///			Index terms of y and z neighbours are computed once per row, step
+		///			along x computes single new term, so indices cost few additions
+		///			in any layout. Indices are valid for all grids of the same size
+		///			and layout.
+		template<typename Layout>
+		class StencilIterator
+		{
+		public:
+			StencilIterator(const Layout& layout, const glm::uvec3& size, int y, int z)
+				: mLayout(layout)
+				, mX(0)
+				, mWidth(static_cast<int>(size.x))
+			{
+				const int height = static_cast<int>(size.y);
+				const int depth = static_cast<int>(size.z);
+
+				const size_t rowY = layout.offsetY(y);
+				const size_t rowZ = layout.offsetZ(z);
+
+				mRow = rowY + rowZ;
+				mDown = layout.offsetY(std::max(y - 1, 0)) + rowZ;
+				mUp = layout.offsetY(std::min(y + 1, height - 1)) + rowZ;
+				mBackward = rowY + layout.offsetZ(std::max(z - 1, 0));
+				mForward = rowY + layout.offsetZ(std::min(z + 1, depth - 1));
+
+				mLeft = layout.offsetX(0);
+				mCenter = mLeft;
+				mRight = layout.offsetX(std::min(1, mWidth - 1));
+			}
+
+			bool isValid() const { return mX < mWidth; }
+			int getX() const { return mX; }
+
+			/// \brief	Moves to next voxel of row.
+			void next()
+			{
+				++mX;
+				mLeft = mCenter;
+				mCenter = mRight;
+				mRight = mLayout.offsetX(std::min(mX + 1, mWidth - 1));
+			}
+
+			size_t center() const { return mCenter + mRow; }
+			size_t left() const { return mLeft + mRow; }
+			size_t right() const { return mRight + mRow; }
+			size_t down() const { return mCenter + mDown; }
+			size_t up() const { return mCenter + mUp; }
+			size_t backward() const { return mCenter + mBackward; }
+			size_t forward() const { return mCenter + mForward; }
+
+		private:
+			const Layout& mLayout;
+			int mX;
+			int mWidth;
+
+			size_t mLeft, mCenter, mRight;					//!< X terms of x - 1, x, x + 1.
+			size_t mRow, mDown, mUp, mBackward, mForward;	//!< Y and z terms of row and its neighbours.
+		};
+	}
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include "glm/glm.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace vfx
+{
+	namespace cpu
+	{
+		// Layouts map voxel position to storage offset. Offset of every layout is
+		// sum of independent per axis terms, offsetX(x) + offsetY(y) + offsetZ(z),
+		// so iterators compute terms of row once and step only along x. Storage
+		// may be padded, padding voxels are never addressed.
+
+		/// \brief	Row major layout, x changes fastest.
+		class LinearLayout
+		{
+		public:
+			LinearLayout()
+				: mStrideY(0)
+				, mStrideZ(0)
+				, mStorageSize(0)
+			{
+			}
+
+			explicit LinearLayout(const glm::uvec3& size)
+				: mStrideY(size.x)
+				, mStrideZ(static_cast<size_t>(size.x) * size.y)
+				, mStorageSize(mStrideZ * size.z)
+			{
+			}
+
+			static const char* getName() { return "linear"; }
+
+			size_t getStorageSize() const { return mStorageSize; }
+
+			size_t offsetX(int x) const { return static_cast<size_t>(x); }
+			size_t offsetY(int y) const { return y * mStrideY; }
+			size_t offsetZ(int z) const { return z * mStrideZ; }
+
+		private:
+			size_t mStrideY;
+			size_t mStrideZ;
+			size_t mStorageSize;
+		};
+
+		/// \brief	Base two logarithm of power of two.
+		constexpr unsigned int getLog2(unsigned int value)
+		{
+			return value <= 1 ? 0 : 1 + getLog2(value / 2);
+		}
+
+		/// \brief	Grid split to bricks of BrickSize^3 voxels stored contiguously,
+		///			bricks and voxels inside brick are row major. Neighbours in all
+		///			three directions mostly share brick and thus cache lines.
+		template<unsigned int BrickSize>
+		class BrickedLayout
+		{
+			static_assert(BrickSize >= 2 && (BrickSize & (BrickSize - 1)) == 0, "Brick size has to be power of two");
+
+			static const unsigned int Shift = getLog2(BrickSize);
+			static const unsigned int Mask = BrickSize - 1;
+			static const size_t BrickVolume = static_cast<size_t>(BrickSize) * BrickSize * BrickSize;
+
+		public:
+			BrickedLayout()
+				: mBrickStrideY(0)
+				, mBrickStrideZ(0)
+				, mStorageSize(0)
+			{
+			}
+
+			explicit BrickedLayout(const glm::uvec3& size)
+			{
+				glm::uvec3 bricks = (size + glm::uvec3(Mask)) / glm::uvec3(BrickSize);
+
+				mBrickStrideY = bricks.x * BrickVolume;
+				mBrickStrideZ = mBrickStrideY * bricks.y;
+				mStorageSize = mBrickStrideZ * bricks.z;
+			}
+
+			static const char* getName() { return BrickSize == 4 ? "bricked 4^3" : BrickSize == 8 ? "bricked 8^3" : "bricked"; }
+
+			size_t getStorageSize() const { return mStorageSize; }
+
+			size_t offsetX(int x) const { return (x >> Shift) * BrickVolume + (x & Mask); }
+			size_t offsetY(int y) const { return (y >> Shift) * mBrickStrideY + ((y & Mask) << Shift); }
+			size_t offsetZ(int z) const { return (z >> Shift) * mBrickStrideZ + ((z & Mask) << (2 * Shift)); }
+
+		private:
+			size_t mBrickStrideY;
+			size_t mBrickStrideZ;
+			size_t mStorageSize;
+		};
+
+		/// \brief	Z-order curve, bits of coordinates are interleaved.
+		///
+		///			Axes shorter than others run out of bits first, remaining bits
+		///			of longer axes continue interleaving, so storage is padded only
+		///			to power of two per axis. Interleaved terms are looked up in per
+		///			axis tables built on construction.
+		class MortonLayout
+		{
+		public:
+			MortonLayout()
+				: mStorageSize(0)
+			{
+			}
+
+			explicit MortonLayout(const glm::uvec3& size)
+			{
+				unsigned int bits[3];
+				for (int axis = 0; axis < 3; ++axis)
+				{
+					bits[axis] = 0;
+					while ((1u << bits[axis]) < size[axis]) ++bits[axis];
+				}
+
+				// Assign bit of each axis to output bit, level by level
+				std::vector<unsigned int> outputBit[3];
+				unsigned int output = 0;
+
+				for (unsigned int level = 0; level < 32; ++level)
+				{
+					for (int axis = 0; axis < 3; ++axis)
+					{
+						if (level < bits[axis]) outputBit[axis].push_back(output++);
+					}
+				}
+
+				for (int axis = 0; axis < 3; ++axis)
+				{
+					mTables[axis].resize(size[axis]);
+
+					for (unsigned int coordinate = 0; coordinate < size[axis]; ++coordinate)
+					{
+						size_t term = 0;
+						for (unsigned int bit = 0; bit < bits[axis]; ++bit)
+						{
+							if (coordinate & (1u << bit)) term |= static_cast<size_t>(1) << outputBit[axis][bit];
+						}
+
+						mTables[axis][coordinate] = term;
+					}
+				}
+
+				mStorageSize = (size.x && size.y && size.z) ? static_cast<size_t>(1) << output : 0;
+			}
+
+			static const char* getName() { return "morton"; }
+
+			size_t getStorageSize() const { return mStorageSize; }
+
+			size_t offsetX(int x) const { return mTables[0][x]; }
+			size_t offsetY(int y) const { return mTables[1][y]; }
+			size_t offsetZ(int z) const { return mTables[2][z]; }
+
+		private:
+			std::vector<size_t> mTables[3];		//!< Interleaved bits of each coordinate.
+			size_t mStorageSize;
+		};
+	}
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Grid.h"
+#include "ThreadPool.h"
+
+namespace vfx
+{
+	namespace cpu
+	{
+		// Kernels reproduce compute shaders of the same name (vfxFluid/resources/shaders),
+		// they read source grids and write whole target grid, which must not alias
+		// any source. Grids are processed in blocks of rows distributed to pool.
+		// Only Jacobi iteration, the hot loop of a step, is vectorized, other kernels
+		// are scalar per voxel.
+
+		/// \brief	Instruction set used by vectorized kernels.
+		const char* getSimdName();
+
+		/// \brief	Semi-Lagrangian advection, advect.comp.
+		template<typename T>
+		void advect(const VectorGrid& velocity, const ScalarGrid& obstacle, const Grid<T>& source, Grid<T>& target,
+					float deltaTime, float dissipation, ThreadPool& pool);
+
+		/// \brief	Final step of MacCormack advection, advect_mc.comp.
+		///
+		/// \param phiN1Hat Source advected forward.
+		/// \param phiNHat phiN1Hat advected backward.
+		template<typename T>
+		void advectMacCormack(const VectorGrid& velocity, const ScalarGrid& obstacle, const Grid<T>& phiN1Hat, const Grid<T>& phiNHat,
+							  const Grid<T>& source, Grid<T>& target, float deltaTime, float dissipation, float decay, ThreadPool& pool);
+
+		/// \brief	Gaussian injection of quantity, injection.comp.
+		///
+		/// \param position Injection position in normalized coordinates.
+		template<typename T>
+		void inject(const Grid<T>& source, Grid<T>& target, const glm::vec3& position, float sigma, const T& intensity,
+					float deltaTime, ThreadPool& pool);
+
+		/// \brief	Gaussian injection of velocity pointing away from position, injectionVelocity.comp.
+		void injectVelocity(const VectorGrid& source, VectorGrid& target, const glm::vec3& position, float sigma, float intensity,
+							float deltaTime, ThreadPool& pool);
+
+		/// \brief	Buoyant force, buoyancy.comp.
+		void buoyancy(const VectorGrid& velocity, const ScalarGrid& temperature, const VectorGrid& density, VectorGrid& target,
+					  const glm::vec3& direction, float ambientTemperature, float deltaTime, float strength, float weight, ThreadPool& pool);
+
+		/// \brief	Vorticity (xyz) and its magnitude (w), vorticity.comp.
+		void vorticity(const VectorGrid& velocity, VectorGrid& target, ThreadPool& pool);
+
+		/// \brief	Vorticity confinement force, confinement.comp.
+		void confinement(const VectorGrid& velocity, const VectorGrid& vorticity, VectorGrid& target, float deltaTime, float strength, ThreadPool& pool);
+
+		/// \brief	Velocity divergence, divergence.comp.
+		void divergence(const VectorGrid& velocity, const ScalarGrid& obstacle, ScalarGrid& target, ThreadPool& pool);
+
+		/// \brief	Single Jacobi iteration of pressure equation, jacobi.comp. Vectorized.
+		void jacobi(const ScalarGrid& divergence, const ScalarGrid& obstacle, const ScalarGrid& pressure, ScalarGrid& target, ThreadPool& pool);
+
+		/// \brief	Jacobi iteration on half grids. Rows are converted to float, updated
+		///			as by float kernel and stored as halves, so memory traffic is halved.
+		void jacobi(const HalfGrid& divergence, const HalfGrid& obstacle, const HalfGrid& pressure, HalfGrid& target, ThreadPool& pool);
+
+		/// \brief	Subtracts pressure gradient from velocity, projection.comp.
+		void projection(const VectorGrid& velocity, const ScalarGrid& obstacle, const ScalarGrid& pressure, VectorGrid& target,
+						float gradientScale, ThreadPool& pool);
+
+		/// \brief	Light volume by marching density towards light, shadows.comp.
+		///
+		/// \param lightPosition Position of light source in normalized coordinates.
+		void shadows(const VectorGrid& density, const ScalarGrid& obstacle, ScalarGrid& target, const glm::vec3& lightPosition,
+					 float step, float absorbtion, float jitter, float factor, float lightIntensity, ThreadPool& pool);
+
+		/// \brief	Domain boundary without obstacle, boundary.comp.
+		void fillBoundary(ScalarGrid& obstacle, ThreadPool& pool);
+
+		/// \brief	Domain boundary with sphere obstacle, sphere.comp.
+		void fillSphere(ScalarGrid& obstacle, const glm::vec3& position, float radius, ThreadPool& pool);
+
+		/// \brief	Domain boundary with box obstacle, box.comp.
+		void fillBox(ScalarGrid& obstacle, const glm::vec3& position, const glm::vec3& extent, ThreadPool& pool);
+	}
+}
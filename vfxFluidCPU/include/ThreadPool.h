@@ -0,0 +1,63 @@
+#pragma once
+
+#include "WorkStealingScheduler.h"
+
+#include <atomic>
+#include <functional>
+
+namespace vfx
+{
+	namespace cpu
+	{
+		/// \brief	Work-stealing thread pool running parallel loops.
+		///
+		///			Thread executing range larger than grain splits it, pushes upper
+		///			half to the back of its deque and continues with lower half, so
+		///			own deque is used as stack while idle threads steal oldest
+		///			(largest) ranges. Scheduling code is shared with job system of
+		///			engine through WorkStealingScheduler template, but pool owns its
+		///			own deques and workers. Calling thread takes part in work.
+		class ThreadPool
+		{
+		public:
+			typedef std::function<void(size_t begin, size_t end)> RangeFunction;
+
+			/// \param threads Number of threads including calling one (0 - all hardware threads).
+			explicit ThreadPool(unsigned int threads = 0);
+			~ThreadPool();
+
+			ThreadPool(const ThreadPool&) = delete;
+			ThreadPool& operator=(const ThreadPool&) = delete;
+
+			/// \brief	Number of threads including calling one.
+			unsigned int getThreadCount() const { return mScheduler.getThreadCount(); }
+
+			/// \brief	Calls function for subranges of [begin, end) and waits until
+			///			whole range is processed. May be called from one external
+			///			thread and from functions running in the pool.
+			///
+			/// \param begin First index.
+			/// \param end One past last index.
+			/// \param grain Ranges up to this size are not split further.
+			/// \param function Function processing subrange [begin, end).
+			void parallelFor(size_t begin, size_t end, size_t grain, const RangeFunction& function);
+
+		private:
+			/// \brief	Subrange of single parallel loop.
+			struct Task
+			{
+				const RangeFunction* function;
+				size_t begin;
+				size_t end;
+				size_t grain;
+				std::atomic<size_t>* remaining;		//!< Indices of loop not processed yet.
+			};
+
+			/// \brief	Splits task down to grain and processes it.
+			void execute(Task task, unsigned int queue);
+
+		private:
+			jobs::WorkStealingScheduler<Task> mScheduler;
+		};
+	}
+}
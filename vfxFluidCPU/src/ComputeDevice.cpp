@@ -0,0 +1,344 @@
+#include "ComputeDevice.h"
+#include "Half.h"
+#include "Kernels.h"
+#include "UniformBlocks.h"
+#include "VolumeFile.h"
+
+#include <cassert>
+#include <stdexcept>
+
+namespace vfx
+{
+	namespace cpu
+	{
+		namespace
+		{
+			template<typename T>
+			Grid<T>& getGrid(const GridVolume& volume);
+
+			template<>
+			ScalarGrid& getGrid<float>(const GridVolume& volume)
+			{
+				return volume.getScalar();
+			}
+
+			template<>
+			VectorGrid& getGrid<glm::vec4>(const GridVolume& volume)
+			{
+				return volume.getVector();
+			}
+
+			// Kernels bind volumes to the same units as compute shaders of pipelines
+
+			template<typename T>
+			void advectKernel(const ComputeDevice::Dispatch& dispatch, ThreadPool& pool)
+			{
+				auto parameters = dispatch.getParameters<AdvectionParameters>();
+				advect(dispatch.getVolume(0).getVector(), dispatch.getVolume(1).getScalar(), getGrid<T>(dispatch.getVolume(2)),
+					   getGrid<T>(dispatch.getTarget(0)), parameters.deltaTime, parameters.dissipation, pool);
+			}
+
+			template<typename T>
+			void advectMacCormackKernel(const ComputeDevice::Dispatch& dispatch, ThreadPool& pool)
+			{
+				auto parameters = dispatch.getParameters<AdvectionParameters>();
+				advectMacCormack(dispatch.getVolume(0).getVector(), dispatch.getVolume(1).getScalar(), getGrid<T>(dispatch.getVolume(2)),
+								 getGrid<T>(dispatch.getVolume(3)), getGrid<T>(dispatch.getVolume(4)), getGrid<T>(dispatch.getTarget(0)),
+								 parameters.deltaTime, parameters.dissipation, parameters.decay, pool);
+			}
+
+			template<typename T>
+			T getIntensity(const glm::vec4& intensity);
+
+			template<>
+			float getIntensity<float>(const glm::vec4& intensity)
+			{
+				return intensity.x;
+			}
+
+			template<>
+			glm::vec4 getIntensity<glm::vec4>(const glm::vec4& intensity)
+			{
+				return intensity;
+			}
+
+			template<typename T>
+			void injectionKernel(const ComputeDevice::Dispatch& dispatch, ThreadPool& pool)
+			{
+				inject(getGrid<T>(dispatch.getVolume(0)), getGrid<T>(dispatch.getTarget(0)), glm::vec3(dispatch.getUniform("injectionPosition")),
+					   dispatch.getUniform("sigma").x, getIntensity<T>(dispatch.getUniform("intensity")), dispatch.getUniform("deltaTime").x, pool);
+			}
+
+			bool isHalfFormat(VolumeFormat format)
+			{
+				return format == VolumeFormat::R16F || format == VolumeFormat::RG16F || format == VolumeFormat::RGBA16F;
+			}
+
+			/// \brief	Rounds floats to nearest halves in place, blocks are converted on stack.
+			void roundToHalf(float* data, size_t count, ThreadPool& pool)
+			{
+				const size_t BLOCK = 4096;
+
+				pool.parallelFor(0, (count + BLOCK - 1) / BLOCK, 1, [&](size_t begin, size_t end)
+				{
+					Half halves[BLOCK];
+
+					for (size_t block = begin; block < end; ++block)
+					{
+						float* values = data + block * BLOCK;
+						size_t size = std::min(BLOCK, count - block * BLOCK);
+
+						convertToHalf(values, halves, size);
+						convertToFloat(halves, values, size);
+					}
+				});
+			}
+		}
+
+		GridVolume::GridVolume(const glm::uvec3& size, VolumeFormat format)
+			: mFormat(format)
+		{
+			if (isScalar())
+				mScalar.resize(size);
+			else
+				mVector.resize(size);
+		}
+
+		glm::vec3 GridVolume::getSize() const
+		{
+			return isScalar() ? mScalar.getSize() : mVector.getSize();
+		}
+
+		void GridVolume::reset()
+		{
+			mScalar = ScalarGrid();
+			mVector = VectorGrid();
+		}
+
+		const GridVolume& ComputeDevice::Dispatch::getVolume(unsigned int unit) const
+		{
+			if (unit >= MaxUnits || !volumes[unit]) throw std::runtime_error("No volume bound to unit " + std::to_string(unit));
+			return *volumes[unit];
+		}
+
+		const GridVolume& ComputeDevice::Dispatch::getTarget(unsigned int unit) const
+		{
+			if (unit >= MaxUnits || !targets[unit]) throw std::runtime_error("No target bound to unit " + std::to_string(unit));
+			return *targets[unit];
+		}
+
+		const glm::vec4& ComputeDevice::Dispatch::getUniform(const std::string& name) const
+		{
+			auto found = uniforms.find(name);
+			if (found == uniforms.end()) throw std::runtime_error("Uniform " + name + " has not been set");
+			return found->second;
+		}
+
+		ComputeDevice::ComputeDevice(unsigned int threads, bool halfPrecision)
+			: mPool(threads)
+			, mKernel(nullptr)
+			, mHalfPrecision(halfPrecision)
+		{
+			unbindKernel();
+			registerSimulationKernels();
+		}
+
+		void ComputeDevice::registerKernel(const std::string& name, const Kernel& kernel)
+		{
+			mKernels[name] = kernel;
+		}
+
+		void ComputeDevice::registerSimulationKernels()
+		{
+			registerKernel("advect4D", advectKernel<glm::vec4>);
+			registerKernel("advect1D", advectKernel<float>);
+			registerKernel("advectMC4D", advectMacCormackKernel<glm::vec4>);
+			registerKernel("advectMC41D", advectMacCormackKernel<float>);
+			registerKernel("injection4D", injectionKernel<glm::vec4>);
+			registerKernel("injection1D", injectionKernel<float>);
+
+			registerKernel("injectionVelocity", [](const Dispatch& dispatch, ThreadPool& pool)
+			{
+				injectVelocity(dispatch.getVolume(0).getVector(), dispatch.getTarget(0).getVector(), glm::vec3(dispatch.getUniform("injectionPosition")),
+							   dispatch.getUniform("sigma").x, dispatch.getUniform("intensity").x, dispatch.getUniform("deltaTime").x, pool);
+			});
+
+			registerKernel("buoyancy", [](const Dispatch& dispatch, ThreadPool& pool)
+			{
+				auto parameters = dispatch.getParameters<BuoyancyParameters>();
+				buoyancy(dispatch.getVolume(0).getVector(), dispatch.getVolume(1).getScalar(), dispatch.getVolume(2).getVector(),
+						 dispatch.getTarget(0).getVector(), parameters.direction, parameters.ambientTemperature, parameters.deltaTime,
+						 parameters.strength, parameters.weight, pool);
+			});
+
+			registerKernel("vorticity", [](const Dispatch& dispatch, ThreadPool& pool)
+			{
+				vorticity(dispatch.getVolume(0).getVector(), dispatch.getTarget(0).getVector(), pool);
+			});
+
+			registerKernel("confinement", [](const Dispatch& dispatch, ThreadPool& pool)
+			{
+				auto parameters = dispatch.getParameters<ConfinementParameters>();
+				confinement(dispatch.getVolume(0).getVector(), dispatch.getVolume(1).getVector(), dispatch.getTarget(0).getVector(),
+							parameters.deltaTime, parameters.strength, pool);
+			});
+
+			registerKernel("divergence", [](const Dispatch& dispatch, ThreadPool& pool)
+			{
+				divergence(dispatch.getVolume(0).getVector(), dispatch.getVolume(1).getScalar(), dispatch.getTarget(0).getScalar(), pool);
+			});
+
+			registerKernel("jacobi", [](const Dispatch& dispatch, ThreadPool& pool)
+			{
+				jacobi(dispatch.getVolume(0).getScalar(), dispatch.getVolume(1).getScalar(), dispatch.getVolume(2).getScalar(),
+					   dispatch.getTarget(0).getScalar(), pool);
+			});
+
+			registerKernel("projection", [](const Dispatch& dispatch, ThreadPool& pool)
+			{
+				projection(dispatch.getVolume(0).getVector(), dispatch.getVolume(1).getScalar(), dispatch.getVolume(2).getScalar(),
+						   dispatch.getTarget(0).getVector(), dispatch.getUniform("gradientScale").x, pool);
+			});
+
+			registerKernel("NoObstacleFill", [](const Dispatch& dispatch, ThreadPool& pool)
+			{
+				fillBoundary(dispatch.getTarget(0).getScalar(), pool);
+			});
+
+			registerKernel("ObstacleSphereFill", [](const Dispatch& dispatch, ThreadPool& pool)
+			{
+				fillSphere(dispatch.getTarget(0).getScalar(), glm::vec3(dispatch.getUniform("spherePosition")), dispatch.getUniform("sphereRadius").x, pool);
+			});
+
+			registerKernel("ObstacleBoxFill", [](const Dispatch& dispatch, ThreadPool& pool)
+			{
+				fillBox(dispatch.getTarget(0).getScalar(), glm::vec3(dispatch.getUniform("boxPosition")), glm::vec3(dispatch.getUniform("boxExtent")), pool);
+			});
+
+			registerKernel("shadows", [](const Dispatch& dispatch, ThreadPool& pool)
+
+			{
+				auto parameters = dispatch.getParameters<ShadowParameters>();
+				shadows(dispatch.getVolume(0).getVector(), dispatch.getVolume(1).getScalar(), dispatch.getTarget(0).getScalar(),
+						parameters.lightPosition, parameters.step, parameters.absorbtion, parameters.jitter, parameters.factor,
+						parameters.lightIntensity, pool);
+			});
+		}
+
+		std::shared_ptr<IVolume> ComputeDevice::createVolume(const glm::uvec3& size, VolumeFormat format)
+		{
+			return std::make_shared<GridVolume>(size, format);
+		}
+
+		void ComputeDevice::bindKernel(const std::string& name, const glm::uvec3& gridSize)
+		{
+			auto found = mKernels.find(name);
+			if (found == mKernels.end()) throw std::runtime_error("Kernel " + name + " is not registered");
+
+			mKernel = &found->second;
+			mDispatch.gridSize = gridSize;
+		}
+
+		void ComputeDevice::unbindKernel()
+		{
+			mKernel = nullptr;
+
+			std::fill(std::begin(mDispatch.volumes), std::end(mDispatch.volumes), nullptr);
+			std::fill(std::begin(mDispatch.targets), std::end(mDispatch.targets), nullptr);
+			mDispatch.parameters.clear();
+			mDispatch.uniforms.clear();
+		}
+
+		void ComputeDevice::bindVolume(unsigned int unit, const IVolume& volume)
+		{
+			assert(unit < MaxUnits);
+			mDispatch.volumes[unit] = &static_cast<const GridVolume&>(volume);
+		}
+
+		void ComputeDevice::bindTarget(unsigned int unit, const IVolume& volume)
+		{
+			assert(unit < MaxUnits);
+			mDispatch.targets[unit] = &static_cast<const GridVolume&>(volume);
+		}
+
+		void ComputeDevice::setParameters(const void* data, std::size_t size)
+		{
+			const unsigned char* bytes = static_cast<const unsigned char*>(data);
+			mDispatch.parameters.assign(bytes, bytes + size);
+		}
+
+		void ComputeDevice::setUniform(const std::string& name, float value)
+		{
+			mDispatch.uniforms[name] = glm::vec4(value, 0.0f, 0.0f, 0.0f);
+		}
+
+		void ComputeDevice::setUniform(const std::string& name, const glm::vec3& value)
+		{
+			mDispatch.uniforms[name] = glm::vec4(value, 0.0f);
+		}
+
+		void ComputeDevice::setUniform(const std::string& name, const glm::vec4& value)
+		{
+			mDispatch.uniforms[name] = value;
+		}
+
+		void ComputeDevice::dispatch()
+		{
+			if (!mKernel) throw std::runtime_error("Dispatch without bound kernel");
+
+			(*mKernel)(mDispatch, mPool);
+
+			if (mHalfPrecision) roundTargets();
+		}
+
+		void ComputeDevice::roundTargets()
+		{
+			for (const GridVolume* target : mDispatch.targets)
+			{
+				if (!target || !isHalfFormat(target->getVolumeFormat()))
+					continue;
+
+				// Vector grid stores vec4 voxels tightly packed
+				if (target->isScalar())
+					roundToHalf(target->getScalar().data(), target->getScalar().getStorageSize(), mPool);
+				else
+					roundToHalf(&target->getVector().data()[0].x, target->getVector().getStorageSize() * 4, mPool);
+			}
+		}
+
+		void ComputeDevice::clear(const IVolume& volume)
+		{
+			const GridVolume& gridVolume = static_cast<const GridVolume&>(volume);
+
+			if (gridVolume.isScalar())
+				gridVolume.getScalar().fill(0.0f);
+			else
+				gridVolume.getVector().fill(glm::vec4(0.0f));
+		}
+
+		void ComputeDevice::readback(const IVolume& volume, Volume& data)
+		{
+			const GridVolume& gridVolume = static_cast<const GridVolume&>(volume);
+
+			data.size = static_cast<glm::uvec3>(gridVolume.getSize());
+			data.channels = getFormatChannels(gridVolume.getVolumeFormat());
+
+			if (gridVolume.isScalar())
+			{
+				const ScalarGrid& grid = gridVolume.getScalar();
+				data.data.assign(grid.data(), grid.data() + grid.getVoxelCount());
+				return;
+			}
+
+			// Two channel formats keep only first components of vector grid
+			const VectorGrid& grid = gridVolume.getVector();
+			data.data.resize(grid.getVoxelCount() * data.channels);
+
+			for (size_t voxel = 0; voxel < grid.getVoxelCount(); ++voxel)
+			{
+				for (uint32_t channel = 0; channel < data.channels; ++channel)
+					data.data[voxel * data.channels + channel] = grid.data()[voxel][channel];
+			}
+		}
+	}
+}
@@ -0,0 +1,563 @@
+#include "Kernels.h"
+
+#include <cmath>
+#include <vector>
+
+#if defined(__AVX__)
+#	include <immintrin.h>
+#	define VFX_SIMD_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#	include <emmintrin.h>
+#	define VFX_SIMD_SSE2
+#endif
+
+namespace vfx
+{
+	namespace cpu
+	{
+		namespace
+		{
+			// Block of rows sharing neighbouring slices in cache
+			const int BLOCK_ROWS = 16;
+			const int BLOCK_SLICES = 4;
+
+			/// \brief	Calls function(y, z) for every row of grid, blocks of rows run in parallel.
+			template<typename Function>
+			void forEachRow(const glm::uvec3& size, ThreadPool& pool, const Function& function)
+			{
+				const int height = static_cast<int>(size.y);
+				const int depth = static_cast<int>(size.z);
+				const int blocksY = (height + BLOCK_ROWS - 1) / BLOCK_ROWS;
+				const int blocksZ = (depth + BLOCK_SLICES - 1) / BLOCK_SLICES;
+
+				pool.parallelFor(0, static_cast<size_t>(blocksY) * blocksZ, 1, [&](size_t begin, size_t end)
+				{
+					for (size_t block = begin; block < end; ++block)
+					{
+						const int y0 = static_cast<int>(block % blocksY) * BLOCK_ROWS;
+						const int z0 = static_cast<int>(block / blocksY) * BLOCK_SLICES;
+
+						for (int z = z0; z < std::min(z0 + BLOCK_SLICES, depth); ++z)
+						{
+							for (int y = y0; y < std::min(y0 + BLOCK_ROWS, height); ++y)
+								function(y, z);
+						}
+					}
+				});
+			}
+
+			/// \brief	Calls function(position) for every voxel of grid.
+			template<typename Function>
+			void forEachVoxel(const glm::uvec3& size, ThreadPool& pool, const Function& function)
+			{
+				const int width = static_cast<int>(size.x);
+
+				forEachRow(size, pool, [&](int y, int z)
+				{
+					for (int x = 0; x < width; ++x)
+						function(glm::ivec3(x, y, z));
+				});
+			}
+
+			bool isBoundary(const glm::ivec3& position, const glm::ivec3& size)
+			{
+				return glm::any(glm::equal(position, glm::ivec3(0))) || glm::any(glm::equal(position, size - 1));
+			}
+
+			/// \brief	Pseudo random number of shadows.comp.
+			float generateNumber(const glm::vec3& coordinate)
+			{
+				float dt = glm::dot(coordinate, glm::vec3(12.9898f, 78.233f, 43758.5453f));
+				float sn = glm::mod(dt, 3.14f);
+				return glm::fract(std::sin(sn) * 43758.5453f);
+			}
+
+			/// \brief	Jacobi update of voxel, neighbour inside obstacle takes center pressure.
+			float jacobiVoxel(float forward, float backward, float right, float left, float up, float down, float center,
+							  float obstacleForward, float obstacleBackward, float obstacleRight, float obstacleLeft, float obstacleUp, float obstacleDown,
+							  float divergence)
+			{
+				if (obstacleForward > 0) forward = center;
+				if (obstacleBackward > 0) backward = center;
+				if (obstacleRight > 0) right = center;
+				if (obstacleLeft > 0) left = center;
+				if (obstacleUp > 0) up = center;
+				if (obstacleDown > 0) down = center;
+
+				return (forward + backward + right + left + up + down - divergence) / 6.0f;
+			}
+
+#if defined(VFX_SIMD_AVX)
+			typedef __m256 Simd;
+			const int SIMD_WIDTH = 8;
+
+			inline Simd load(const float* data) { return _mm256_loadu_ps(data); }
+			inline void store(float* data, Simd value) { _mm256_storeu_ps(data, value); }
+			inline Simd add(Simd a, Simd b) { return _mm256_add_ps(a, b); }
+			inline Simd sub(Simd a, Simd b) { return _mm256_sub_ps(a, b); }
+			inline Simd div(Simd a, Simd b) { return _mm256_div_ps(a, b); }
+			inline Simd broadcast(float value) { return _mm256_set1_ps(value); }
+
+			/// \brief	Center where obstacle is positive, value otherwise.
+			inline Simd select(Simd obstacle, Simd center, Simd value)
+			{
+				return _mm256_blendv_ps(value, center, _mm256_cmp_ps(obstacle, _mm256_setzero_ps(), _CMP_GT_OQ));
+			}
+#elif defined(VFX_SIMD_SSE2)
+			typedef __m128 Simd;
+			const int SIMD_WIDTH = 4;
+
+			inline Simd load(const float* data) { return _mm_loadu_ps(data); }
+			inline void store(float* data, Simd value) { _mm_storeu_ps(data, value); }
+			inline Simd add(Simd a, Simd b) { return _mm_add_ps(a, b); }
+			inline Simd sub(Simd a, Simd b) { return _mm_sub_ps(a, b); }
+			inline Simd div(Simd a, Simd b) { return _mm_div_ps(a, b); }
+			inline Simd broadcast(float value) { return _mm_set1_ps(value); }
+
+			inline Simd select(Simd obstacle, Simd center, Simd value)
+			{
+				Simd mask = _mm_cmpgt_ps(obstacle, _mm_setzero_ps());
+				return _mm_or_ps(_mm_and_ps(mask, center), _mm_andnot_ps(mask, value));
+			}
+#endif
+
+			/// \brief	Offsets of row and its clamped neighbour rows, row at boundary
+			///			is its own neighbour.
+			struct JacobiRows
+			{
+				size_t row, up, down, forward, backward;
+
+				template<typename Grid>
+				JacobiRows(const Grid& grid, int y, int z)
+				{
+					const glm::ivec3 size(grid.getSize());
+
+					row = grid.index(0, y, z);
+					up = grid.index(0, std::min(y + 1, size.y - 1), z);
+					down = grid.index(0, std::max(y - 1, 0), z);
+					forward = grid.index(0, y, std::min(z + 1, size.z - 1));
+					backward = grid.index(0, y, std::max(z - 1, 0));
+				}
+
+				/// \brief	Rows stacked in scratch buffer in order row, up, down, forward, backward.
+				explicit JacobiRows(size_t width)
+					: row(0), up(width), down(2 * width), forward(3 * width), backward(4 * width)
+				{
+				}
+			};
+
+			/// \brief	Jacobi update of row, pressure and obstacle rows are addressed
+			///			by offsets of rows from p and o.
+			void jacobiRow(const float* p, const float* o, const float* d, float* output, const JacobiRows& rows, int width)
+			{
+				const size_t row = rows.row, up = rows.up, down = rows.down, forward = rows.forward, backward = rows.backward;
+
+				auto voxel = [&](int x)
+				{
+					const int left = std::max(x - 1, 0);
+					const int right = std::min(x + 1, width - 1);
+
+					output[x] = jacobiVoxel(p[forward + x], p[backward + x], p[row + right], p[row + left], p[up + x], p[down + x], p[row + x],
+											o[forward + x], o[backward + x], o[row + right], o[row + left], o[up + x], o[down + x], d[x]);
+				};
+
+				int x = 0;
+
+#if defined(VFX_SIMD_AVX) || defined(VFX_SIMD_SSE2)
+				// Interior of row, x neighbours need no clamping
+				voxel(x++);
+
+				const Simd six = broadcast(6.0f);
+
+				for (; x + SIMD_WIDTH < width; x += SIMD_WIDTH)
+				{
+					Simd center = load(p + row + x);
+
+					Simd sum = select(load(o + forward + x), center, load(p + forward + x));
+					sum = add(sum, select(load(o + backward + x), center, load(p + backward + x)));
+					sum = add(sum, select(load(o + row + x + 1), center, load(p + row + x + 1)));
+					sum = add(sum, select(load(o + row + x - 1), center, load(p + row + x - 1)));
+					sum = add(sum, select(load(o + up + x), center, load(p + up + x)));
+					sum = add(sum, select(load(o + down + x), center, load(p + down + x)));
+
+					store(output + x, div(sub(sum, load(d + x)), six));
+				}
+#endif
+
+				for (; x < width; ++x)
+					voxel(x);
+			}
+		}
+
+		const char* getSimdName()
+		{
+#if defined(__AVX2__)
+			return "AVX2";
+#elif defined(VFX_SIMD_AVX)
+			return "AVX";
+#elif defined(VFX_SIMD_SSE2)
+			return "SSE2";
+#else
+			return "scalar";
+#endif
+		}
+
+		template<typename T>
+		void advect(const VectorGrid& velocity, const ScalarGrid& obstacle, const Grid<T>& source, Grid<T>& target,
+					float deltaTime, float dissipation, ThreadPool& pool)
+		{
+			const glm::vec3 gridSize(target.getSize());
+
+			forEachVoxel(target.getSize(), pool, [&](const glm::ivec3& position)
+			{
+				T outputValue(0);
+
+				if (!(obstacle.at(position) > 0))
+				{
+					glm::vec3 backTrackedPosition = glm::vec3(position) - glm::vec3(velocity.at(position)) * deltaTime;
+					glm::vec3 backTrackedCoordinate = (backTrackedPosition + 0.5f) / gridSize;
+
+					outputValue = source.sample(backTrackedCoordinate) * (1 - dissipation);
+				}
+
+				target.at(position) = outputValue;
+			});
+		}
+
+		template<typename T>
+		void advectMacCormack(const VectorGrid& velocity, const ScalarGrid& obstacle, const Grid<T>& phiN1Hat, const Grid<T>& phiNHat,
+							  const Grid<T>& source, Grid<T>& target, float deltaTime, float dissipation, float decay, ThreadPool& pool)
+		{
+			const glm::ivec3 gridSize(target.getSize());
+
+			forEachVoxel(target.getSize(), pool, [&](const glm::ivec3& position)
+			{
+				T outputValue(0);
+
+				if (!(obstacle.at(position) > 0))
+				{
+					glm::vec3 backTrackedPosition = glm::vec3(position) - glm::vec3(velocity.at(position)) * deltaTime;
+					glm::vec3 backTrackedCoordinate = (backTrackedPosition + 0.5f) / glm::vec3(gridSize);
+
+					glm::ivec3 diff = gridSize - position - 1;
+					glm::ivec3 distance = glm::min(position, diff);
+					int distanceToBoundary = glm::min(distance.x, glm::min(distance.y, distance.z));
+
+					T quantitySample;
+
+					if (distanceToBoundary > 3)
+					{
+						quantitySample = phiN1Hat.sample(backTrackedCoordinate) + 0.5f * (source.at(position) - phiNHat.at(position));
+
+						// Shader fetches first corner unclamped, it is clamped here
+						T corners[8];
+						source.corners(glm::ivec3(backTrackedPosition), corners);
+
+						T minBoundary = corners[0];
+						T maxBoundary = minBoundary;
+
+						for (int corner = 1; corner < 8; ++corner)
+						{
+							minBoundary = glm::min(minBoundary, corners[corner]);
+							maxBoundary = glm::max(maxBoundary, corners[corner]);
+						}
+
+						quantitySample = glm::clamp(quantitySample, minBoundary, maxBoundary);
+					}
+					else
+					{
+						quantitySample = source.sample(backTrackedCoordinate);
+					}
+
+					outputValue = glm::max(T(0), quantitySample * (1 - dissipation) - T(deltaTime * decay));
+				}
+
+				target.at(position) = outputValue;
+			});
+		}
+
+		template<typename T>
+		void inject(const Grid<T>& source, Grid<T>& target, const glm::vec3& position, float sigma, const T& intensity,
+					float deltaTime, ThreadPool& pool)
+		{
+			const glm::ivec3 gridSize(target.getSize());
+
+			forEachVoxel(target.getSize(), pool, [&](const glm::ivec3& voxel)
+			{
+				glm::vec3 coord = glm::vec3(voxel) / glm::vec3(gridSize - 1);
+
+				glm::vec3 diff = position - coord;
+				float distanceSquare = glm::dot(diff, diff) * gridSize.y * gridSize.y;
+				float sigmaSquare = sigma * sigma;
+
+				// Same precedence as shader
+				float gaussian = std::exp(-distanceSquare / 2 * sigmaSquare) / sigma;
+
+				target.at(voxel) = source.at(voxel) + intensity * gaussian * deltaTime;
+			});
+		}
+
+		void injectVelocity(const VectorGrid& source, VectorGrid& target, const glm::vec3& position, float sigma, float intensity,
+							float deltaTime, ThreadPool& pool)
+		{
+			const glm::ivec3 gridSize(target.getSize());
+
+			forEachVoxel(target.getSize(), pool, [&](const glm::ivec3& voxel)
+			{
+				glm::vec3 coord = glm::vec3(voxel) / glm::vec3(gridSize - 1);
+
+				float distanceSquare = glm::dot(position - coord, position - coord) * gridSize.y * gridSize.y;
+				float gaussian = std::exp(-distanceSquare / 2 * sigma * sigma) / sigma;
+
+				// Voxel at injection position gets no direction instead of NaN
+				glm::vec3 offset = coord - position;
+				glm::vec3 direction = glm::dot(offset, offset) > 0.0f ? glm::normalize(offset) : glm::vec3(0.0f);
+
+				target.at(voxel) = source.at(voxel) + intensity * gaussian * deltaTime * glm::vec4(direction, 0.0f);
+			});
+		}
+
+		void buoyancy(const VectorGrid& velocity, const ScalarGrid& temperature, const VectorGrid& density, VectorGrid& target,
+					  const glm::vec3& direction, float ambientTemperature, float deltaTime, float strength, float weight, ThreadPool& pool)
+		{
+			forEachVoxel(target.getSize(), pool, [&](const glm::ivec3& position)
+			{
+				const glm::vec4& d = density.at(position);
+				float densityTotal = d.x + d.y + d.z + d.w;
+				float force = (temperature.at(position) - ambientTemperature) * strength - densityTotal * weight;
+
+				target.at(position) = velocity.at(position) + deltaTime * force * glm::vec4(direction, 0.0f);
+			});
+		}
+
+		void vorticity(const VectorGrid& velocity, VectorGrid& target, ThreadPool& pool)
+		{
+			forEachVoxel(target.getSize(), pool, [&](const glm::ivec3& position)
+			{
+				const glm::vec4& velocityRight = velocity.clamped(position + glm::ivec3(1, 0, 0));
+				const glm::vec4& velocityLeft = velocity.clamped(position + glm::ivec3(-1, 0, 0));
+				const glm::vec4& velocityUp = velocity.clamped(position + glm::ivec3(0, 1, 0));
+				const glm::vec4& velocityDown = velocity.clamped(position + glm::ivec3(0, -1, 0));
+				const glm::vec4& velocityForward = velocity.clamped(position + glm::ivec3(0, 0, 1));
+				const glm::vec4& velocityBackward = velocity.clamped(position + glm::ivec3(0, 0, -1));
+
+				glm::vec3 curl = 0.5f * glm::vec3((velocityUp.z - velocityDown.z) - (velocityForward.y - velocityBackward.y),
+												  (velocityForward.x - velocityBackward.x) - (velocityRight.z - velocityLeft.z),
+												  (velocityRight.y - velocityLeft.y) - (velocityUp.x - velocityDown.x));
+
+				target.at(position) = glm::vec4(curl, glm::length(curl));
+			});
+		}
+
+		void confinement(const VectorGrid& velocity, const VectorGrid& vorticity, VectorGrid& target, float deltaTime, float strength, ThreadPool& pool)
+		{
+			forEachVoxel(target.getSize(), pool, [&](const glm::ivec3& position)
+			{
+				float omegaRight = vorticity.clamped(position + glm::ivec3(1, 0, 0)).w;
+				float omegaLeft = vorticity.clamped(position + glm::ivec3(-1, 0, 0)).w;
+				float omegaUp = vorticity.clamped(position + glm::ivec3(0, 1, 0)).w;
+				float omegaDown = vorticity.clamped(position + glm::ivec3(0, -1, 0)).w;
+				float omegaForward = vorticity.clamped(position + glm::ivec3(0, 0, 1)).w;
+				float omegaBackward = vorticity.clamped(position + glm::ivec3(0, 0, -1)).w;
+				glm::vec3 omega = glm::vec3(vorticity.at(position));
+
+				glm::vec3 eta = 0.5f * glm::vec3(omegaRight - omegaLeft, omegaUp - omegaDown, omegaForward - omegaBackward);
+				eta = glm::normalize(eta + glm::vec3(0.001f));
+
+				glm::vec3 dv = deltaTime * strength * glm::vec3(eta.y * omega.z - eta.z * omega.y,
+																eta.z * omega.x - eta.x * omega.z,
+																eta.x * omega.y - eta.y * omega.x);
+
+				target.at(position) = glm::vec4(glm::vec3(velocity.at(position)) + dv, 0.0f);
+			});
+		}
+
+		void divergence(const VectorGrid& velocity, const ScalarGrid& obstacle, ScalarGrid& target, ThreadPool& pool)
+		{
+			forEachVoxel(target.getSize(), pool, [&](const glm::ivec3& position)
+			{
+				// Obstacles have zero velocity
+				auto fetch = [&](const glm::ivec3& offset)
+				{
+					return obstacle.clamped(position + offset) > 0 ? glm::vec3(0.0f) : glm::vec3(velocity.clamped(position + offset));
+				};
+
+				target.at(position) = 0.5f * (fetch(glm::ivec3(0, 0, 1)).z - fetch(glm::ivec3(0, 0, -1)).z +
+											  fetch(glm::ivec3(1, 0, 0)).x - fetch(glm::ivec3(-1, 0, 0)).x +
+											  fetch(glm::ivec3(0, 1, 0)).y - fetch(glm::ivec3(0, -1, 0)).y);
+			});
+		}
+
+		void jacobi(const ScalarGrid& divergence, const ScalarGrid& obstacle, const ScalarGrid& pressure, ScalarGrid& target, ThreadPool& pool)
+		{
+			const glm::ivec3 size(target.getSize());
+
+			forEachRow(target.getSize(), pool, [&](int y, int z)
+			{
+				JacobiRows rows(pressure, y, z);
+				jacobiRow(pressure.data(), obstacle.data(), divergence.data() + rows.row, target.data() + rows.row, rows, size.x);
+			});
+		}
+
+		void jacobi(const HalfGrid& divergence, const HalfGrid& obstacle, const HalfGrid& pressure, HalfGrid& target, ThreadPool& pool)
+		{
+			const int width = static_cast<int>(target.getSize().x);
+
+			forEachRow(target.getSize(), pool, [&](int y, int z)
+			{
+				// Rows are converted to float scratch of worker, pressure and obstacle
+				// rows in order row, up, down, forward, backward
+				thread_local std::vector<float> scratch;
+				scratch.resize(12 * static_cast<size_t>(width));
+
+				float* p = scratch.data();
+				float* o = p + 5 * width;
+				float* d = o + 5 * width;
+				float* output = d + width;
+
+				JacobiRows rows(pressure, y, z);
+				const size_t source[5] = { rows.row, rows.up, rows.down, rows.forward, rows.backward };
+
+				for (int i = 0; i < 5; ++i)
+				{
+					convertToFloat(pressure.data() + source[i], p + i * width, width);
+					convertToFloat(obstacle.data() + source[i], o + i * width, width);
+				}
+
+				convertToFloat(divergence.data() + rows.row, d, width);
+
+				jacobiRow(p, o, d, output, JacobiRows(width), width);
+				convertToHalf(output, target.data() + rows.row, width);
+			});
+		}
+
+		void projection(const VectorGrid& velocity, const ScalarGrid& obstacle, const ScalarGrid& pressure, VectorGrid& target,
+						float gradientScale, ThreadPool& pool)
+		{
+			forEachVoxel(target.getSize(), pool, [&](const glm::ivec3& position)
+			{
+				glm::vec4 finalVelocity(0.0f);
+
+				if (!(obstacle.at(position) > 0))
+				{
+					float pressureForward = pressure.clamped(position + glm::ivec3(0, 0, 1));
+					float pressureBackward = pressure.clamped(position + glm::ivec3(0, 0, -1));
+					float pressureRight = pressure.clamped(position + glm::ivec3(1, 0, 0));
+					float pressureLeft = pressure.clamped(position + glm::ivec3(-1, 0, 0));
+					float pressureUp = pressure.clamped(position + glm::ivec3(0, 1, 0));
+					float pressureDown = pressure.clamped(position + glm::ivec3(0, -1, 0));
+					float pressureCenter = pressure.at(position);
+
+					float obstacleForward = obstacle.clamped(position + glm::ivec3(0, 0, 1));
+					float obstacleBackward = obstacle.clamped(position + glm::ivec3(0, 0, -1));
+					float obstacleRight = obstacle.clamped(position + glm::ivec3(1, 0, 0));
+					float obstacleLeft = obstacle.clamped(position + glm::ivec3(-1, 0, 0));
+					float obstacleUp = obstacle.clamped(position + glm::ivec3(0, 1, 0));
+					float obstacleDown = obstacle.clamped(position + glm::ivec3(0, -1, 0));
+
+					// Obstacle volume has single channel, so only x obstacle velocity
+					// is non-zero, shader takes it from opposite neighbour
+					glm::vec3 obstacleVelocity(0.0f);
+					glm::vec3 velocityMask(1.0f);
+
+					if (obstacleForward > 0) { pressureForward = pressureCenter; velocityMask.z = 0; }
+					if (obstacleBackward > 0) { pressureBackward = pressureCenter; velocityMask.z = 0; }
+					if (obstacleRight > 0) { pressureRight = pressureCenter; obstacleVelocity.x = obstacleLeft; velocityMask.x = 0; }
+					if (obstacleLeft > 0) { pressureLeft = pressureCenter; obstacleVelocity.x = obstacleRight; velocityMask.x = 0; }
+					if (obstacleUp > 0) { pressureUp = pressureCenter; velocityMask.y = 0; }
+					if (obstacleDown > 0) { pressureDown = pressureCenter; velocityMask.y = 0; }
+
+					glm::vec3 grad = glm::vec3(pressureRight - pressureLeft, pressureUp - pressureDown, pressureForward - pressureBackward) * 0.5f;
+					glm::vec3 v = glm::vec3(velocity.at(position)) - grad * gradientScale;
+
+					finalVelocity = glm::vec4(v * velocityMask + obstacleVelocity, 0.0f);
+				}
+
+				target.at(position) = finalVelocity;
+			});
+		}
+
+		void shadows(const VectorGrid& density, const ScalarGrid& obstacle, ScalarGrid& target, const glm::vec3& lightPosition,
+					 float step, float absorbtion, float jitter, float factor, float lightIntensity, ThreadPool& pool)
+		{
+			const glm::vec3 gridSize(target.getSize());
+
+			forEachVoxel(target.getSize(), pool, [&](const glm::ivec3& position)
+			{
+				glm::vec3 coord = glm::vec3(position) / gridSize;
+				glm::vec3 lightDirection = glm::normalize(lightPosition - coord);
+				glm::vec3 traceCoord = coord + glm::mix(-jitter * 0.5f, jitter * 0.5f, generateNumber(coord)) * lightDirection * step;
+
+				float lighting = 1.0f;
+				for (int j = 0; j < 1000; ++j)
+				{
+					traceCoord += lightDirection * step;
+
+					if (obstacle.sample(traceCoord) > 0.2f) break;
+					if (glm::any(glm::lessThan(traceCoord, glm::vec3(0.0f))) || glm::any(glm::greaterThan(traceCoord, glm::vec3(1.0f)))) break;
+
+					glm::vec4 densitySample = density.sample(traceCoord) * factor;
+					float densityTotal = densitySample.x + densitySample.y + densitySample.z;
+					if (densityTotal < 0.01f) continue;
+
+					lighting *= std::exp(-densityTotal * step * absorbtion);
+					if (lighting < 0.01f) break;
+				}
+
+				target.at(position) = lighting * lightIntensity;
+			});
+		}
+
+		void fillBoundary(ScalarGrid& obstacle, ThreadPool& pool)
+		{
+			const glm::ivec3 gridSize(obstacle.getSize());
+
+			forEachVoxel(obstacle.getSize(), pool, [&](const glm::ivec3& position)
+			{
+				obstacle.at(position) = isBoundary(position, gridSize) ? 0.1f : 0.0f;
+			});
+		}
+
+		void fillSphere(ScalarGrid& obstacle, const glm::vec3& position, float radius, ThreadPool& pool)
+		{
+			const glm::ivec3 gridSize(obstacle.getSize());
+
+			forEachVoxel(obstacle.getSize(), pool, [&](const glm::ivec3& voxel)
+			{
+				glm::vec3 coord = glm::vec3(voxel) / glm::vec3(gridSize - 1);
+
+				float value = isBoundary(voxel, gridSize) ? 0.01f : 0.0f;
+				if (glm::distance(position, coord) < radius) value = 1.0f;
+
+				obstacle.at(voxel) = value;
+			});
+		}
+
+		void fillBox(ScalarGrid& obstacle, const glm::vec3& position, const glm::vec3& extent, ThreadPool& pool)
+		{
+			const glm::ivec3 gridSize(obstacle.getSize());
+
+			forEachVoxel(obstacle.getSize(), pool, [&](const glm::ivec3& voxel)
+			{
+				glm::vec3 coord = glm::vec3(voxel) / glm::vec3(gridSize - 1);
+
+				float value = isBoundary(voxel, gridSize) ? 0.1f : 0.0f;
+				if (glm::all(glm::lessThan(glm::abs(coord - position), extent))) value = 1.0f;
+
+				obstacle.at(voxel) = value;
+			});
+		}
+
+		// Quantities are scalar (temperature, pressure) or four channel (velocity, density)
+		template void advect<float>(const VectorGrid&, const ScalarGrid&, const Grid<float>&, Grid<float>&, float, float, ThreadPool&);
+		template void advect<glm::vec4>(const VectorGrid&, const ScalarGrid&, const Grid<glm::vec4>&, Grid<glm::vec4>&, float, float, ThreadPool&);
+
+		template void advectMacCormack<float>(const VectorGrid&, const ScalarGrid&, const Grid<float>&, const Grid<float>&,
+											  const Grid<float>&, Grid<float>&, float, float, float, ThreadPool&);
+		template void advectMacCormack<glm::vec4>(const VectorGrid&, const ScalarGrid&, const Grid<glm::vec4>&, const Grid<glm::vec4>&,
+												  const Grid<glm::vec4>&, Grid<glm::vec4>&, float, float, float, ThreadPool&);
+
+		template void inject<float>(const Grid<float>&, Grid<float>&, const glm::vec3&, float, const float&, float, ThreadPool&);
+		template void inject<glm::vec4>(const Grid<glm::vec4>&, Grid<glm::vec4>&, const glm::vec3&, float, const glm::vec4&, float, ThreadPool&);
+	}
+}
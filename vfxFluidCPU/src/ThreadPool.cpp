@@ -0,0 +1,57 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace vfx
+{
+	namespace cpu
+	{
+		ThreadPool::ThreadPool(unsigned int threads)
+			: mScheduler([this](Task& task, unsigned int queue) { execute(task, queue); })
+		{
+			if (threads == 0)
+				threads = std::max(1u, std::thread::hardware_concurrency());
+
+			mScheduler.start(threads);
+		}
+
+		ThreadPool::~ThreadPool()
+		{
+			mScheduler.stop();
+		}
+
+		void ThreadPool::parallelFor(size_t begin, size_t end, size_t grain, const RangeFunction& function)
+		{
+			if (begin >= end) return;
+
+			std::atomic<size_t> remaining(end - begin);
+
+			execute({ &function, begin, end, std::max<size_t>(grain, 1), &remaining }, mScheduler.getQueueIndex());
+
+			// Help with any work until own loop is finished, stolen ranges may still run
+			mScheduler.wait([&remaining]() { return remaining.load(std::memory_order_acquire) == 0; });
+		}
+
+		void ThreadPool::execute(Task task, unsigned int queue)
+		{
+			while (task.end - task.begin > task.grain)
+			{
+				size_t middle = task.begin + (task.end - task.begin) / 2;
+
+				Task upper = task;
+				upper.begin = middle;
+				mScheduler.push(queue, upper);
+
+				task.end = middle;
+			}
+
+			(*task.function)(task.begin, task.end);
+
+			// Loop may return once last range is processed, scheduler is woken only
+			const size_t count = task.end - task.begin;
+			if (task.remaining->fetch_sub(count, std::memory_order_acq_rel) == count)
+				mScheduler.notify();
+		}
+	}
+}
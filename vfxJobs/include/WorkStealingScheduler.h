@@ -0,0 +1,260 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vfx
+{
+	namespace jobs
+	{
+		/// \brief	Work-stealing deques and worker threads. Engine job system and
+		///			CPU simulation thread pool each own an instance.
+		///
+		///			Each thread owns a deque of jobs, pushes and pops new jobs at its
+		///			back and idle threads steal oldest jobs from the front of other
+		///			deques. Threads outside scheduler share deque 0. Waiting thread
+		///			executes jobs until its condition holds, workers and waiting
+		///			threads sleep while no job is queued.
+		///
+		/// \tparam Job Copyable job, executed by executor of scheduler.
+		template<typename Job>
+		class WorkStealingScheduler
+		{
+		public:
+			typedef std::function<void(Job& job, unsigned int queue)> Executor;
+			typedef std::function<void(unsigned int queue)> WorkerStart;
+
+			/// \param executor Executes job on thread owning given queue.
+			explicit WorkStealingScheduler(const Executor& executor)
+				: mExecutor(executor)
+				, mQueuedJobs(0)
+				, mSleepingThreads(0)
+				, mWorkerCount(0)
+				, mRunning(false)
+			{
+				mQueues.push_back(std::make_unique<Queue>());
+			}
+
+			~WorkStealingScheduler()
+			{
+				stop();
+			}
+
+			WorkStealingScheduler(const WorkStealingScheduler&) = delete;
+			WorkStealingScheduler& operator=(const WorkStealingScheduler&) = delete;
+
+			/// \brief	Starts workers, has to be called before jobs are pushed.
+			///
+			/// \param threads Number of threads including waiting one, one worker less is started.
+			/// \param workerStart Called on worker thread before its first job.
+			void start(unsigned int threads, const WorkerStart& workerStart = WorkerStart())
+			{
+				if (isRunning())
+					return;
+
+				while (mQueues.size() < threads)
+					mQueues.push_back(std::make_unique<Queue>());
+
+				mRunning.store(true, std::memory_order_release);
+
+				for (unsigned int i = 1; i < threads; ++i)
+				{
+					mWorkers.emplace_back([this, i, workerStart]()
+					{
+						if (workerStart) workerStart(i);
+						workerLoop(i);
+					});
+				}
+
+				mWorkerCount.store(static_cast<unsigned int>(mWorkers.size()), std::memory_order_release);
+			}
+
+			/// \brief	Stops workers once queued jobs are taken, jobs pushed later
+			///			run on waiting threads.
+			void stop()
+			{
+				{
+					std::lock_guard<std::mutex> lock(mWakeMutex);
+					mRunning.store(false, std::memory_order_release);
+				}
+
+				mWake.notify_all();
+
+				for (auto& worker : mWorkers)
+					worker.join();
+
+				mWorkers.clear();
+				mWorkerCount.store(0, std::memory_order_release);
+			}
+
+			bool isRunning() const { return mRunning.load(std::memory_order_acquire); }
+			unsigned int getWorkerCount() const { return mWorkerCount.load(std::memory_order_acquire); }
+
+			/// \brief	Number of deques, one per thread including waiting one.
+			unsigned int getThreadCount() const { return static_cast<unsigned int>(mQueues.size()); }
+
+			/// \brief	Deque of calling thread, threads outside scheduler share deque 0.
+			unsigned int getQueueIndex() const
+			{
+				return getThreadScheduler() == this ? getThreadQueue() : 0;
+			}
+
+			/// \brief	Pushes job to back of deque of calling thread.
+			void push(const Job& job)
+			{
+				push(getQueueIndex(), job);
+			}
+
+			void push(unsigned int queue, const Job& job)
+			{
+				{
+					std::lock_guard<std::mutex> lock(mQueues[queue]->mutex);
+					mQueues[queue]->jobs.push_back(job);
+				}
+
+				// Sequentially consistent with counting of sleeping threads in sleep,
+				// either job is seen by predicate or sleeping thread by this
+				mQueuedJobs.fetch_add(1);
+
+				if (mSleepingThreads.load() > 0)
+				{
+					// Lock pairs with predicate check of sleeping thread, wakeup is not lost
+					std::lock_guard<std::mutex> lock(mWakeMutex);
+					mWake.notify_one();
+				}
+			}
+
+			/// \brief	Executes jobs on calling thread until done returns true, sleeps
+			///			while no job is queued. Thread making done true calls notify.
+			template<typename Predicate>
+			void wait(Predicate done)
+			{
+				const unsigned int queue = getQueueIndex();
+
+				Job job;
+				while (!done())
+				{
+					if (pop(queue, job) || steal(queue, job))
+						mExecutor(job, queue);
+					else
+						sleep(done);
+				}
+			}
+
+			/// \brief	Wakes sleeping threads to check their wait condition.
+			void notify()
+			{
+				// Condition is checked under lock, so it is seen once lock is taken
+				std::lock_guard<std::mutex> lock(mWakeMutex);
+				mWake.notify_all();
+			}
+
+		private:
+			/// \brief	Deque of jobs owned by single thread.
+			struct Queue
+			{
+				std::mutex mutex;
+				std::deque<Job> jobs;
+			};
+
+			/// \brief	Takes newest job of own deque.
+			bool pop(unsigned int queue, Job& job)
+			{
+				std::lock_guard<std::mutex> lock(mQueues[queue]->mutex);
+
+				auto& jobs = mQueues[queue]->jobs;
+				if (jobs.empty()) return false;
+
+				job = std::move(jobs.back());
+				jobs.pop_back();
+				mQueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+
+				return true;
+			}
+
+			/// \brief	Takes oldest job of other deque.
+			bool steal(unsigned int thief, Job& job)
+			{
+				const auto count = static_cast<unsigned int>(mQueues.size());
+
+				for (unsigned int i = 1; i < count; ++i)
+				{
+					auto& victim = *mQueues[(thief + i) % count];
+
+					std::lock_guard<std::mutex> lock(victim.mutex);
+					if (victim.jobs.empty()) continue;
+
+					job = std::move(victim.jobs.front());
+					victim.jobs.pop_front();
+					mQueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+
+					return true;
+				}
+
+				return false;
+			}
+
+			/// \brief	Blocks until job is queued or wake returns true.
+			template<typename Predicate>
+			void sleep(Predicate wake)
+			{
+				std::unique_lock<std::mutex> lock(mWakeMutex);
+
+				mSleepingThreads.fetch_add(1);
+				mWake.wait(lock, [&]() { return wake() || mQueuedJobs.load() > 0; });
+				mSleepingThreads.fetch_sub(1);
+			}
+
+			void workerLoop(unsigned int queue)
+			{
+				getThreadScheduler() = this;
+				getThreadQueue() = queue;
+
+				Job job;
+				while (true)
+				{
+					if (pop(queue, job) || steal(queue, job))
+					{
+						mExecutor(job, queue);
+						continue;
+					}
+
+					if (!isRunning()) return;
+
+					sleep([this]() { return !isRunning(); });
+				}
+			}
+
+			/// \brief	Scheduler the thread works for, workers of nested schedulers are not expected.
+			static const void*& getThreadScheduler()
+			{
+				static thread_local const void* scheduler = nullptr;
+				return scheduler;
+			}
+
+			static unsigned int& getThreadQueue()
+			{
+				static thread_local unsigned int queue = 0;
+				return queue;
+			}
+
+		private:
+			Executor mExecutor;
+			std::vector<std::unique_ptr<Queue>> mQueues;	//!< Queue 0 belongs to threads outside scheduler.
+			std::vector<std::thread> mWorkers;
+
+			std::mutex mWakeMutex;
+			std::condition_variable mWake;
+			std::atomic<size_t> mQueuedJobs;				//!< Jobs in all deques, threads sleep while zero.
+			std::atomic<unsigned int> mSleepingThreads;		//!< Threads sleeping or about to, push wakes them.
+			std::atomic<unsigned int> mWorkerCount;
+			std::atomic<bool> mRunning;						//!< Workers run, read by any thread.
+		};
+	}
+}
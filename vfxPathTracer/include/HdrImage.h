@@ -0,0 +1,37 @@
+#pragma once
+
+#include "glm/vec3.hpp"
+
+#include <string>
+#include <vector>
+
+namespace vfx
+{
+	namespace pt
+	{
+		/// \brief	Floating point RGB image written in Radiance HDR (RGBE) format.
+		class HdrImage
+		{
+		public:
+			HdrImage(unsigned int width, unsigned int height);
+
+			/// \brief	Pixel accessors.
+			glm::vec3& at(unsigned int x, unsigned int y) { return mPixels[y * mWidth + x]; }
+			const glm::vec3& at(unsigned int x, unsigned int y) const { return mPixels[y * mWidth + x]; }
+
+			unsigned int getWidth() const { return mWidth; }
+			unsigned int getHeight() const { return mHeight; }
+
+			/// \brief	Writes image to file (uncompressed scanlines).
+			///
+			/// \param filename Output file path.
+			/// \return True if image has been written.
+			bool write(const std::string& filename) const;
+
+		private:
+			unsigned int mWidth;				//!< Image width.
+			unsigned int mHeight;				//!< Image height.
+			std::vector<glm::vec3> mPixels;		//!< Pixels, top row first.
+		};
+	}
+}
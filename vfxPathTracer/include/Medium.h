@@ -0,0 +1,54 @@
+#pragma once
+
+#include "VolumeFile.h"
+#include "glm/vec3.hpp"
+
+namespace vfx
+{
+	namespace pt
+	{
+		struct MediumProperties
+		{
+			float densityFactor = 10.0f;		//!< Density factor (same as real-time renderer).
+			float absorbtion = 20.0f;			//!< Light absorbtion factor (same as real-time renderer).
+			float albedo = 0.8f;				//!< Single scattering albedo.
+			bool radianceEnabled = false;		//!< Darken hot smoke (same as real-time radiance).
+			float radianceFallOff = 100.0f;		//!< Radiance colour fall off.
+		};
+
+		/// \brief	Heterogeneous participating medium built from exported simulation volumes.
+		///
+		///			Medium occupies unit cube, volumes are sampled trilinearly at voxel centers.
+		class Medium
+		{
+		public:
+			/// \param density Density volume (RGB coloured densities).
+			/// \param temperature Temperature volume, may be null.
+			/// \param properties Medium properties.
+			Medium(const Volume& density, const Volume* temperature, const MediumProperties& properties);
+
+			/// \brief	Extinction coefficient at given position.
+			float extinction(const glm::vec3& position) const;
+
+			/// \brief	Scattering albedo (colour) at given position.
+			glm::vec3 albedo(const glm::vec3& position) const;
+
+			/// \brief	Upper bound of extinction in whole medium.
+			float getMajorant() const { return mMajorant; }
+
+		private:
+			/// \brief	Trilinearly interpolates all channels of volume.
+			///
+			/// \param volume Sampled volume.
+			/// \param position Position in unit cube.
+			/// \param values Interpolated channels (at least volume.channels floats).
+			static void sample(const Volume& volume, const glm::vec3& position, float* values);
+
+		private:
+			const Volume& mDensity;				//!< Density volume.
+			const Volume* mTemperature;			//!< Temperature volume.
+			MediumProperties mProperties;		//!< Medium properties.
+			float mMajorant;					//!< Maximum extinction.
+		};
+	}
+}
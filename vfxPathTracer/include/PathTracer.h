@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Medium.h"
+#include "HdrImage.h"
+#include "Random.h"
+#include "TileScheduler.h"
+
+#include "glm/vec3.hpp"
+
+namespace vfx
+{
+	namespace pt
+	{
+		struct RenderSettings
+		{
+			unsigned int samples = 64;								//!< Samples per pixel.
+			unsigned int maxBounces = 16;							//!< Maximum number of scattering events.
+			unsigned int threads = 0;								//!< Worker threads (0 - all hardware threads).
+			unsigned int seed = 0;									//!< Random sequence selector.
+
+			glm::vec3 cameraPosition = glm::vec3(0.5f, 0.5f, -1.5f);	//!< Camera position in volume space.
+			glm::vec3 cameraTarget = glm::vec3(0.5f);					//!< Point camera looks at.
+			float fieldOfView = 45.0f;									//!< Vertical field of view in degrees.
+
+			glm::vec3 lightPosition = glm::vec3(4.0f, 1.0f, 2.0f);	//!< Light position, light is directional from domain center.
+			glm::vec3 lightColor = glm::vec3(1.0f);					//!< Light colour.
+			float lightIntensity = 20.0f;							//!< Light intensity, scattered by isotropic phase of 1 as in raytracing.frag.
+			glm::vec3 ambient = glm::vec3(0.15f, 0.15f, 0.20f);		//!< Uniform environment radiance.
+
+			float anisotropy = 0.0f;								//!< Henyey-Greenstein asymmetry parameter.
+		};
+
+		struct RenderStats
+		{
+			unsigned long long samples = 0;		//!< Number of traced camera paths.
+			double seconds = 0.0;				//!< Wall clock render time.
+		};
+
+		/// \brief	Unbiased volumetric path tracer used as ground truth for real-time renderer.
+		///
+		///			Free flight distances are sampled by delta tracking, light transmittance
+		///			of next event estimation by ratio tracking, both against global majorant.
+		class PathTracer
+		{
+		public:
+			PathTracer(const Medium& medium, const RenderSettings& settings);
+
+			/// \brief	Renders the medium, image is parallelized by tiles across worker threads.
+			///
+			/// \param image Target image, its size defines rendered resolution.
+			/// \return Render statistics.
+			RenderStats render(HdrImage& image) const;
+
+		private:
+			/// \brief	Estimates radiance arriving along ray.
+			glm::vec3 radiance(glm::vec3 origin, glm::vec3 direction, Random& random) const;
+
+			/// \brief	Samples free flight distance by delta tracking.
+			///
+			/// \return False if ray left the medium without collision.
+			bool deltaTracking(const glm::vec3& origin, const glm::vec3& direction, float tMin, float tMax, Random& random, glm::vec3& position) const;
+
+			/// \brief	Estimates transmittance along ray by ratio tracking.
+			float ratioTracking(const glm::vec3& origin, const glm::vec3& direction, Random& random) const;
+
+			/// \brief	Henyey-Greenstein phase function.
+			float phase(float cosTheta) const;
+
+			/// \brief	Samples direction from Henyey-Greenstein phase function.
+			glm::vec3 samplePhase(const glm::vec3& direction, Random& random) const;
+
+			/// \brief	Intersects ray with unit cube.
+			static bool intersectDomain(const glm::vec3& origin, const glm::vec3& direction, float& tMin, float& tMax);
+
+		private:
+			const Medium& mMedium;				//!< Rendered medium.
+			RenderSettings mSettings;			//!< Render settings.
+			glm::vec3 mLightDirection;			//!< Direction towards light.
+		};
+	}
+}
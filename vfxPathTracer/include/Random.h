@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+
+namespace vfx
+{
+	namespace pt
+	{
+		/// \brief	PCG32 random number generator (O'Neill).
+		///
+		///			Small state, fast and statistically good enough for
+		///			Monte Carlo integration. Each pixel sample uses its own
+		///			stream, so results do not depend on thread scheduling.
+		class Random
+		{
+		public:
+			Random(uint64_t seed, uint64_t sequence = 0)
+			{
+				mIncrement = (sequence << 1u) | 1u;
+				next();
+				mState += seed;
+				next();
+			}
+
+			/// \brief	Generates uniformly distributed 32-bit unsigned integer.
+			uint32_t next()
+			{
+				uint64_t state = mState;
+				mState = state * 6364136223846793005ULL + mIncrement;
+
+				uint32_t xorShifted = static_cast<uint32_t>(((state >> 18u) ^ state) >> 27u);
+				uint32_t rotation = static_cast<uint32_t>(state >> 59u);
+
+				return (xorShifted >> rotation) | (xorShifted << ((~rotation + 1u) & 31));
+			}
+
+			/// \brief	Generates uniformly distributed float in range [0, 1).
+			float uniform()
+			{
+				return (next() >> 8) * (1.0f / 16777216.0f);
+			}
+
+		private:
+			uint64_t mState = 0;		//!< Generator state.
+			uint64_t mIncrement = 0;	//!< Stream selector (must be odd).
+		};
+	}
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+
+namespace vfx
+{
+	namespace pt
+	{
+		struct Tile
+		{
+			unsigned int x0, y0;	//!< Top left pixel (inclusive).
+			unsigned int x1, y1;	//!< Bottom right pixel (exclusive).
+		};
+
+		/// \brief	Distributes image tiles to worker threads.
+		///
+		///			Workers pull tiles from shared atomic counter, so threads which
+		///			get cheap tiles (empty space) simply render more of them.
+		class TileScheduler
+		{
+		public:
+			TileScheduler(unsigned int width, unsigned int height, unsigned int tileSize = 32);
+
+			/// \brief	Renders all tiles using given number of threads.
+			///
+			/// \param threads Number of worker threads (0 - all hardware threads).
+			/// \param renderTile Function rendering single tile.
+			void run(unsigned int threads, const std::function<void(const Tile&)>& renderTile);
+
+		private:
+			/// \brief	Fetches next unrendered tile.
+			///
+			/// \return False if all tiles have been distributed.
+			bool next(Tile& tile);
+
+		private:
+			unsigned int mWidth;					//!< Image width.
+			unsigned int mHeight;					//!< Image height.
+			unsigned int mTileSize;					//!< Tile width & height.
+			unsigned int mTilesX;					//!< Number of tiles in row.
+			unsigned int mTileCount;				//!< Total number of tiles.
+			std::atomic<unsigned int> mNextTile;	//!< Index of next tile to be rendered.
+		};
+	}
+}
@@ -0,0 +1,59 @@
+#include "HdrImage.h"
+
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+
+namespace vfx
+{
+	namespace pt
+	{
+		HdrImage::HdrImage(unsigned int width, unsigned int height)
+			: mWidth(width)
+			, mHeight(height)
+			, mPixels(static_cast<size_t>(width) * height, glm::vec3(0.0f))
+		{
+		}
+
+		bool HdrImage::write(const std::string& filename) const
+		{
+			std::ofstream file(filename, std::ios::binary);
+			if (!file.is_open())
+				return false;
+
+			file << "#?RADIANCE\n";
+			file << "FORMAT=32-bit_rle_rgbe\n\n";
+			file << "-Y " << mHeight << " +X " << mWidth << "\n";
+
+			std::vector<unsigned char> scanline(mWidth * 4);
+
+			for (unsigned int y = 0; y < mHeight; ++y)
+			{
+				for (unsigned int x = 0; x < mWidth; ++x)
+				{
+					const glm::vec3& pixel = at(x, y);
+					float maxComponent = std::max(pixel.x, std::max(pixel.y, pixel.z));
+					unsigned char* rgbe = &scanline[x * 4];
+
+					if (maxComponent < 1e-32f)
+					{
+						rgbe[0] = rgbe[1] = rgbe[2] = rgbe[3] = 0;
+						continue;
+					}
+
+					int exponent;
+					float scale = std::frexp(maxComponent, &exponent) * 256.0f / maxComponent;
+
+					rgbe[0] = static_cast<unsigned char>(std::max(pixel.x, 0.0f) * scale);
+					rgbe[1] = static_cast<unsigned char>(std::max(pixel.y, 0.0f) * scale);
+					rgbe[2] = static_cast<unsigned char>(std::max(pixel.z, 0.0f) * scale);
+					rgbe[3] = static_cast<unsigned char>(exponent + 128);
+				}
+
+				file.write(reinterpret_cast<const char*>(scanline.data()), scanline.size());
+			}
+
+			return file.good();
+		}
+	}
+}
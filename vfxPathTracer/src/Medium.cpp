@@ -0,0 +1,87 @@
+#include "Medium.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace vfx
+{
+	namespace pt
+	{
+		Medium::Medium(const Volume& density, const Volume* temperature, const MediumProperties& properties)
+			: mDensity(density)
+			, mTemperature(temperature)
+			, mProperties(properties)
+			, mMajorant(0.0f)
+		{
+			// Trilinear interpolation never exceeds maximum voxel value
+			unsigned int colorChannels = std::min(3u, mDensity.channels);
+			size_t voxels = static_cast<size_t>(mDensity.size.x) * mDensity.size.y * mDensity.size.z;
+
+			for (size_t i = 0; i < voxels; ++i)
+			{
+				float total = 0.0f;
+				for (unsigned int c = 0; c < colorChannels; ++c)
+					total += mDensity.data[i * mDensity.channels + c];
+
+				mMajorant = std::max(mMajorant, total);
+			}
+
+			mMajorant *= mProperties.densityFactor * mProperties.absorbtion;
+		}
+
+		float Medium::extinction(const glm::vec3& position) const
+		{
+			float values[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			sample(mDensity, position, values);
+
+			float total = values[0] + values[1] + values[2];
+			return std::max(total, 0.0f) * mProperties.densityFactor * mProperties.absorbtion;
+		}
+
+		glm::vec3 Medium::albedo(const glm::vec3& position) const
+		{
+			float values[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			sample(mDensity, position, values);
+
+			float total = values[0] + values[1] + values[2];
+			if (total <= 0.0f)
+				return glm::vec3(0.0f);
+
+			// Coloured densities give colour of scattered light
+			glm::vec3 color = (mDensity.channels >= 3) ? glm::vec3(values[0], values[1], values[2]) * (3.0f / total) : glm::vec3(1.0f);
+			color = glm::min(color, glm::vec3(1.0f));
+
+			if (mProperties.radianceEnabled && mTemperature)
+			{
+				float temperature = 0.0f;
+				sample(*mTemperature, position, &temperature);
+				color *= 1.0f - std::exp(-temperature * temperature / mProperties.radianceFallOff);
+			}
+
+			return color * mProperties.albedo;
+		}
+
+		void Medium::sample(const Volume& volume, const glm::vec3& position, float* values)
+		{
+			glm::vec3 size = glm::vec3(volume.size);
+			glm::vec3 coord = glm::clamp(position * size - 0.5f, glm::vec3(0.0f), size - 1.0f);
+
+			glm::uvec3 p0 = glm::uvec3(coord);
+			glm::uvec3 p1 = glm::min(p0 + 1u, volume.size - 1u);
+			glm::vec3 f = coord - glm::vec3(p0);
+
+			for (unsigned int c = 0; c < volume.channels; ++c)
+			{
+				float c00 = volume.at(p0.x, p0.y, p0.z, c) * (1.0f - f.x) + volume.at(p1.x, p0.y, p0.z, c) * f.x;
+				float c10 = volume.at(p0.x, p1.y, p0.z, c) * (1.0f - f.x) + volume.at(p1.x, p1.y, p0.z, c) * f.x;
+				float c01 = volume.at(p0.x, p0.y, p1.z, c) * (1.0f - f.x) + volume.at(p1.x, p0.y, p1.z, c) * f.x;
+				float c11 = volume.at(p0.x, p1.y, p1.z, c) * (1.0f - f.x) + volume.at(p1.x, p1.y, p1.z, c) * f.x;
+
+				float c0 = c00 * (1.0f - f.y) + c10 * f.y;
+				float c1 = c01 * (1.0f - f.y) + c11 * f.y;
+
+				values[c] = c0 * (1.0f - f.z) + c1 * f.z;
+			}
+		}
+	}
+}
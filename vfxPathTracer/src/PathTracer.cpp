@@ -0,0 +1,220 @@
+#include "PathTracer.h"
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace vfx
+{
+	namespace pt
+	{
+		namespace
+		{
+			const float PI = 3.14159265358979323846f;
+
+			// Bounces after which paths are terminated by russian roulette
+			const unsigned int ROULETTE_BOUNCES = 3;
+		}
+
+		PathTracer::PathTracer(const Medium& medium, const RenderSettings& settings)
+			: mMedium(medium)
+			, mSettings(settings)
+		{
+			glm::vec3 toLight = settings.lightPosition - glm::vec3(0.5f);
+			mLightDirection = glm::length(toLight) > 0.0f ? glm::normalize(toLight) : glm::vec3(0.0f, 1.0f, 0.0f);
+		}
+
+		RenderStats PathTracer::render(HdrImage& image) const
+		{
+			const unsigned int width = image.getWidth();
+			const unsigned int height = image.getHeight();
+
+			// Camera basis
+			glm::vec3 forward = glm::normalize(mSettings.cameraTarget - mSettings.cameraPosition);
+			glm::vec3 right = glm::normalize(glm::cross(forward, glm::vec3(0.0f, 1.0f, 0.0f)));
+			glm::vec3 up = glm::cross(right, forward);
+
+			float tanHalfFov = std::tan(mSettings.fieldOfView * 0.5f * PI / 180.0f);
+			float aspect = static_cast<float>(width) / height;
+
+			auto start = std::chrono::high_resolution_clock::now();
+
+			TileScheduler scheduler(width, height);
+			scheduler.run(mSettings.threads, [&](const Tile& tile)
+			{
+				for (unsigned int y = tile.y0; y < tile.y1; ++y)
+				{
+					for (unsigned int x = tile.x0; x < tile.x1; ++x)
+					{
+						// Each pixel has own random stream, image does not depend on scheduling
+						Random random(static_cast<uint64_t>(y) * width + x, mSettings.seed);
+						glm::vec3 sum(0.0f);
+
+						for (unsigned int s = 0; s < mSettings.samples; ++s)
+						{
+							float u = (2.0f * (x + random.uniform()) / width - 1.0f) * tanHalfFov * aspect;
+							float v = (1.0f - 2.0f * (y + random.uniform()) / height) * tanHalfFov;
+
+							glm::vec3 direction = glm::normalize(forward + u * right + v * up);
+							sum += radiance(mSettings.cameraPosition, direction, random);
+						}
+
+						image.at(x, y) = sum / static_cast<float>(mSettings.samples);
+					}
+				}
+			});
+
+			RenderStats stats;
+			stats.samples = static_cast<unsigned long long>(width) * height * mSettings.samples;
+			stats.seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+			return stats;
+		}
+
+		glm::vec3 PathTracer::radiance(glm::vec3 origin, glm::vec3 direction, Random& random) const
+		{
+			glm::vec3 result(0.0f);
+			glm::vec3 throughput(1.0f);
+			// Real-time renderer scatters light without phase normalization (isotropic
+			// phase equals 1), light is scaled by 4 PI so intensities of both match
+			glm::vec3 lightRadiance = mSettings.lightColor * mSettings.lightIntensity * (4.0f * PI);
+
+			for (unsigned int bounce = 0; bounce <= mSettings.maxBounces; ++bounce)
+			{
+				float tMin, tMax;
+				glm::vec3 position;
+
+				if (!intersectDomain(origin, direction, tMin, tMax) ||
+					!deltaTracking(origin, direction, std::max(tMin, 0.0f), tMax, random, position))
+				{
+					// Escaped to environment
+					result += throughput * mSettings.ambient;
+					break;
+				}
+
+				throughput *= mMedium.albedo(position);
+
+				// Next event estimation towards directional light
+				float transmittance = ratioTracking(position, mLightDirection, random);
+				result += throughput * lightRadiance * transmittance * phase(glm::dot(direction, mLightDirection));
+
+				if (bounce >= ROULETTE_BOUNCES)
+				{
+					float survival = std::min(std::max(throughput.x, std::max(throughput.y, throughput.z)), 0.95f);
+					if (random.uniform() >= survival) break;
+					throughput /= survival;
+				}
+
+				origin = position;
+				direction = samplePhase(direction, random);
+			}
+
+			return result;
+		}
+
+		bool PathTracer::deltaTracking(const glm::vec3& origin, const glm::vec3& direction, float tMin, float tMax, Random& random, glm::vec3& position) const
+		{
+			const float majorant = mMedium.getMajorant();
+			if (majorant <= 0.0f)
+				return false;
+
+			float t = tMin;
+
+			while (true)
+			{
+				t -= std::log(1.0f - random.uniform()) / majorant;
+				if (t >= tMax)
+					return false;
+
+				position = origin + t * direction;
+
+				// Real collision with probability extinction / majorant, null collision otherwise
+				if (random.uniform() * majorant < mMedium.extinction(position))
+					return true;
+			}
+		}
+
+		float PathTracer::ratioTracking(const glm::vec3& origin, const glm::vec3& direction, Random& random) const
+		{
+			const float majorant = mMedium.getMajorant();
+
+			float tMin, tMax;
+			if (majorant <= 0.0f || !intersectDomain(origin, direction, tMin, tMax))
+				return 1.0f;
+
+			float transmittance = 1.0f;
+			float t = std::max(tMin, 0.0f);
+
+			while (true)
+			{
+				t -= std::log(1.0f - random.uniform()) / majorant;
+				if (t >= tMax)
+					break;
+
+				transmittance *= 1.0f - mMedium.extinction(origin + t * direction) / majorant;
+
+				// Russian roulette on low transmittance keeps estimator unbiased
+				if (transmittance < 0.1f)
+				{
+					if (random.uniform() >= 0.5f) return 0.0f;
+					transmittance *= 2.0f;
+				}
+			}
+
+			return transmittance;
+		}
+
+		float PathTracer::phase(float cosTheta) const
+		{
+			const float g = mSettings.anisotropy;
+			float denominator = 1.0f + g * g - 2.0f * g * cosTheta;
+
+			return (1.0f - g * g) / (4.0f * PI * denominator * std::sqrt(denominator));
+		}
+
+		glm::vec3 PathTracer::samplePhase(const glm::vec3& direction, Random& random) const
+		{
+			const float g = mSettings.anisotropy;
+			float u1 = random.uniform();
+			float u2 = random.uniform();
+
+			float cosTheta;
+			if (std::abs(g) < 1e-3f)
+			{
+				cosTheta = 1.0f - 2.0f * u1;
+			}
+			else
+			{
+				float term = (1.0f - g * g) / (1.0f - g + 2.0f * g * u1);
+				cosTheta = (1.0f + g * g - term * term) / (2.0f * g);
+			}
+
+			float sinTheta = std::sqrt(std::max(0.0f, 1.0f - cosTheta * cosTheta));
+			float phi = 2.0f * PI * u2;
+
+			// Local frame around incoming direction
+			glm::vec3 tangent = std::abs(direction.x) > 0.9f ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
+			tangent = glm::normalize(glm::cross(direction, tangent));
+			glm::vec3 bitangent = glm::cross(direction, tangent);
+
+			return sinTheta * std::cos(phi) * tangent + sinTheta * std::sin(phi) * bitangent + cosTheta * direction;
+		}
+
+		bool PathTracer::intersectDomain(const glm::vec3& origin, const glm::vec3& direction, float& tMin, float& tMax)
+		{
+			glm::vec3 inverse = 1.0f / direction;
+			glm::vec3 t0 = (glm::vec3(0.0f) - origin) * inverse;
+			glm::vec3 t1 = (glm::vec3(1.0f) - origin) * inverse;
+
+			glm::vec3 tNear = glm::min(t0, t1);
+			glm::vec3 tFar = glm::max(t0, t1);
+
+			tMin = std::max(tNear.x, std::max(tNear.y, tNear.z));
+			tMax = std::min(tFar.x, std::min(tFar.y, tFar.z));
+
+			return tMax > std::max(tMin, 0.0f);
+		}
+	}
+}
@@ -0,0 +1,59 @@
+#include "TileScheduler.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace vfx
+{
+	namespace pt
+	{
+		TileScheduler::TileScheduler(unsigned int width, unsigned int height, unsigned int tileSize)
+			: mWidth(width)
+			, mHeight(height)
+			, mTileSize(tileSize)
+			, mTilesX((width + tileSize - 1) / tileSize)
+			, mTileCount(mTilesX * ((height + tileSize - 1) / tileSize))
+			, mNextTile(0)
+		{
+		}
+
+		void TileScheduler::run(unsigned int threads, const std::function<void(const Tile&)>& renderTile)
+		{
+			if (threads == 0)
+				threads = std::max(1u, std::thread::hardware_concurrency());
+
+			mNextTile = 0;
+
+			auto worker = [this, &renderTile]()
+			{
+				Tile tile;
+				while (next(tile)) renderTile(tile);
+			};
+
+			std::vector<std::thread> workers;
+			for (unsigned int i = 1; i < threads; ++i)
+				workers.emplace_back(worker);
+
+			// Calling thread renders as well
+			worker();
+
+			for (auto& thread : workers)
+				thread.join();
+		}
+
+		bool TileScheduler::next(Tile& tile)
+		{
+			unsigned int index = mNextTile.fetch_add(1);
+			if (index >= mTileCount)
+				return false;
+
+			tile.x0 = (index % mTilesX) * mTileSize;
+			tile.y0 = (index / mTilesX) * mTileSize;
+			tile.x1 = std::min(tile.x0 + mTileSize, mWidth);
+			tile.y1 = std::min(tile.y0 + mTileSize, mHeight);
+
+			return true;
+		}
+	}
+}
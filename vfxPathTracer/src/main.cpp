@@ -0,0 +1,138 @@
+#include "PathTracer.h"
+#include "VolumeFile.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+
+namespace
+{
+	void printUsage()
+	{
+		std::cout << "Usage: vfxPathTracer --density <file.vfxv> [options]\n"
+				  << "  --temperature <file.vfxv>  temperature volume (enables radiance)\n"
+				  << "  --output <file.hdr>        output image (default: reference.hdr)\n"
+				  << "  --size <width> <height>    image size (default: 640 360)\n"
+				  << "  --samples <n>              samples per pixel (default: 64)\n"
+				  << "  --bounces <n>              maximum scattering events (default: 16)\n"
+				  << "  --threads <n>              worker threads (default: all cores)\n"
+				  << "  --camera <x> <y> <z>       camera position in volume space\n"
+				  << "  --light <x> <y> <z>        light position in volume space\n"
+				  << "  --intensity <value>        light intensity (default: 20)\n"
+				  << "  --density-factor <value>   density factor (default: 10)\n"
+				  << "  --absorbtion <value>       light absorbtion (default: 20)\n"
+				  << "  --albedo <value>           scattering albedo (default: 0.8)\n"
+				  << "  --anisotropy <value>       Henyey-Greenstein g (default: 0)\n"
+				  << "  --benchmark <passes>       render repeatedly and report samples per second\n";
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	std::string densityFile;
+	std::string temperatureFile;
+	std::string outputFile = "reference.hdr";
+	unsigned int width = 640;
+	unsigned int height = 360;
+	unsigned int benchmarkPasses = 0;
+
+	vfx::pt::RenderSettings settings;
+	vfx::pt::MediumProperties properties;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		int remaining = argc - i - 1;
+
+		auto nextFloat = [&]() { return static_cast<float>(std::atof(argv[++i])); };
+		auto nextUInt = [&]() { return static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10)); };
+
+		if (arg == "--density" && remaining >= 1) densityFile = argv[++i];
+		else if (arg == "--temperature" && remaining >= 1) temperatureFile = argv[++i];
+		else if (arg == "--output" && remaining >= 1) outputFile = argv[++i];
+		else if (arg == "--size" && remaining >= 2) { width = nextUInt(); height = nextUInt(); }
+		else if (arg == "--samples" && remaining >= 1) settings.samples = nextUInt();
+		else if (arg == "--bounces" && remaining >= 1) settings.maxBounces = nextUInt();
+		else if (arg == "--threads" && remaining >= 1) settings.threads = nextUInt();
+		else if (arg == "--camera" && remaining >= 3) { settings.cameraPosition.x = nextFloat(); settings.cameraPosition.y = nextFloat(); settings.cameraPosition.z = nextFloat(); }
+		else if (arg == "--light" && remaining >= 3) { settings.lightPosition.x = nextFloat(); settings.lightPosition.y = nextFloat(); settings.lightPosition.z = nextFloat(); }
+		else if (arg == "--intensity" && remaining >= 1) settings.lightIntensity = nextFloat();
+		else if (arg == "--density-factor" && remaining >= 1) properties.densityFactor = nextFloat();
+		else if (arg == "--absorbtion" && remaining >= 1) properties.absorbtion = nextFloat();
+		else if (arg == "--albedo" && remaining >= 1) properties.albedo = nextFloat();
+		else if (arg == "--anisotropy" && remaining >= 1) settings.anisotropy = nextFloat();
+		else if (arg == "--benchmark" && remaining >= 1) benchmarkPasses = nextUInt();
+		else
+		{
+			printUsage();
+			return 1;
+		}
+	}
+
+	if (densityFile.empty() || width == 0 || height == 0 || settings.samples == 0)
+	{
+		printUsage();
+		return 1;
+	}
+
+	vfx::Volume density;
+	if (!vfx::VolumeFile::read(densityFile, density) || density.channels == 0 || density.channels > 4)
+	{
+		std::cerr << "Failed to read density volume: " << densityFile << std::endl;
+		return 1;
+	}
+
+	vfx::Volume temperature;
+	if (!temperatureFile.empty())
+	{
+		if (!vfx::VolumeFile::read(temperatureFile, temperature) || temperature.channels != 1)
+		{
+			std::cerr << "Failed to read temperature volume: " << temperatureFile << std::endl;
+			return 1;
+		}
+
+		properties.radianceEnabled = true;
+	}
+
+	vfx::pt::Medium medium(density, temperatureFile.empty() ? nullptr : &temperature, properties);
+	vfx::pt::PathTracer tracer(medium, settings);
+	vfx::pt::HdrImage image(width, height);
+
+	unsigned int threads = settings.threads ? settings.threads : std::max(1u, std::thread::hardware_concurrency());
+
+	std::cout << "Volume " << density.size.x << "x" << density.size.y << "x" << density.size.z
+			  << ", image " << width << "x" << height << ", " << settings.samples << " spp, " << threads << " threads" << std::endl;
+
+	if (benchmarkPasses > 0)
+	{
+		unsigned long long samples = 0;
+		double seconds = 0.0;
+
+		for (unsigned int pass = 0; pass < benchmarkPasses; ++pass)
+		{
+			vfx::pt::RenderStats stats = tracer.render(image);
+			samples += stats.samples;
+			seconds += stats.seconds;
+
+			std::cout << "Pass " << pass << ": " << stats.seconds << " s, " << (stats.samples / stats.seconds) << " samples/s" << std::endl;
+		}
+
+		std::cout << "Average: " << (samples / seconds) << " samples/s (" << (samples / seconds / threads) << " per thread)" << std::endl;
+	}
+	else
+	{
+		vfx::pt::RenderStats stats = tracer.render(image);
+		std::cout << "Rendered in " << stats.seconds << " s, " << (stats.samples / stats.seconds) << " samples/s" << std::endl;
+	}
+
+	if (!image.write(outputFile))
+	{
+		std::cerr << "Failed to write image: " << outputFile << std::endl;
+		return 1;
+	}
+
+	std::cout << "Written " << outputFile << std::endl;
+	return 0;
+}